@@ -0,0 +1,126 @@
+//	 The batch runner of the friction problem: the scenarios are read from
+// the scenario files (the format is described in simulation_config.h) and
+// are solved one after another without the console.
+//	 For each scenario, the displacements of the nodes 1, 2, 5, 6 in the
+// direction of movement are written to the file "outputFile" of the scenario
+// or, if it is not set, to the file "<name>_displacements.txt". If the
+// output file has the extension ".mfer", the binary columnar format is
+// written (binary_results.h) together with the configuration; ".mfez" - the
+// compressed history (history_codec.h); ".csv" and ".tsv" give the time and
+// the displacements in columns with full precision.
+//
+// Usage: friction-batch scenarios.txt [more_scenarios.txt ...]
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <MFE_lib/functions_for_MFE/dinamic_solver_MFE.h>
+#include <MFE_lib/functions_for_MFE/binary_results.h>
+#include <MFE_lib/functions_for_MFE/async_sink.h>
+#include <MFE_lib/functions_for_MFE/history_codec.h>
+
+using namespace MFE;
+
+// The format of the output file is chosen by its extension
+static bool hasExtension(const std::string& fileName, const std::string& extension)
+{
+	return fileName.size() >= extension.size() &&
+		fileName.compare(fileName.size() - extension.size(), extension.size(),
+			extension) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0]
+			<< " scenarios.txt [more_scenarios.txt ...]\n";
+		return EXIT_FAILURE;
+	}
+
+	std::vector<SimulationConfig> configs;
+	try
+	{
+		for (int argNum = 1; argNum < argc; ++argNum)
+		{
+			std::vector<SimulationConfig> configsFile =
+				readScenarioFile(argv[argNum]);
+			configs.insert(configs.end(), configsFile.begin(),
+				configsFile.end());
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cout << "Error : " << ex.what() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	// The failed scenario does not stop the others
+	UnsignedType failedCount = 0;
+	for (const auto& config : configs)
+	{
+		std::cout << "Scenario \"" << config.name << "\"\n";
+		try
+		{
+			std::string fileName = config.outputFile;
+			if (fileName.empty())
+				fileName = config.name + "_displacements.txt";
+
+			// The steps are written on the writer thread as they are
+			// calculated, the history of displacements is not kept in memory
+			if (hasExtension(fileName, BINARY_RESULTS_EXTENSION))
+			{
+				BinaryFileSink fileSink(fileName, config);
+				AsyncSink sink(fileSink);
+				runSimulation(config, sink);
+
+				if (!fileSink.isWritten())
+					++failedCount;
+			}
+			else if (hasExtension(fileName, COMPRESSED_HISTORY_EXTENSION))
+			{
+				CompressedSink sink(std::vector<UnsignedType>(
+					ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()));
+				runSimulation(config, sink);
+
+				if (!writeCompressedHistory(sink.getHistory(), fileName))
+					++failedCount;
+			}
+			else if (hasExtension(fileName, ".csv") ||
+				hasExtension(fileName, ".tsv"))
+			{
+				const TextLayout layout = hasExtension(fileName, ".tsv") ?
+					TEXT_LAYOUT_TSV : TEXT_LAYOUT_CSV;
+				ChannelsFileSink fileSink(fileName, std::vector<UnsignedType>(
+					ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()), layout);
+				AsyncSink sink(fileSink);
+				runSimulation(config, sink);
+
+				if (!fileSink.isWritten())
+					++failedCount;
+			}
+			else
+			{
+				TextFileSink fileSink(fileName);
+				AsyncSink sink(fileSink);
+				runSimulation(config, sink);
+
+				if (!fileSink.isWritten())
+					++failedCount;
+			}
+
+			std::cout << "Written to \"" << fileName << "\"\n\n";
+		}
+		catch (const std::exception& ex)
+		{
+			std::cout << "Error : " << ex.what() << "\n\n";
+			++failedCount;
+		}
+	}
+
+	std::cout << configs.size() - failedCount << " of " << configs.size()
+		<< " scenarios are completed. \n";
+
+	return failedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -26,9 +26,8 @@
 #include <fstream>
 
 #include <MFE_lib/functions_for_MFE/dinamic_solver_MFE.h>
-#include <MFE_lib/functions_for_MFE/matrix_MFE.h>
-#include <MFE_lib/write_functions.h>
-#include <MFE_lib/get_disps_func.h>
+#include <MFE_lib/functions_for_MFE/series_decimation.h>
+#include <MFE_lib/functions_for_MFE/async_sink.h>
 #include "../libs/matplotlib/matplotlibcpp.h"
 
 using namespace MFE;
@@ -36,35 +35,25 @@ namespace plt = matplotlibcpp;
 
 int main()
 {
-	FiniteElement finiteElement;
-	chooseMaterialProperties(finiteElement);
-
-	// As well as the oscillation time and time step (for numerical integration)
-	Real time = inputTime();
-	// For good convergence, it's worth taking 1e-7 or 1e-8.
-	Real deltaT = inputDeltaT();
+	// The finite element, the oscillation time, the time step and the
+	// parameters of the solver are entered from the console.
+	// For good convergence, it's worth taking the time step 1e-7 or 1e-8.
+	SimulationConfig config = inputSimulationConfig();
 
 	try
 	{
-		// Matrix stiffness
-		RealMatrix matrixStiffness = makeMatrixStiffness(finiteElement);
-
-		UnsignedType rows = matrixStiffness.sizeRows();
-		// Diagonal matrix mass final element
-		RealMatrix matrixMassDiag =
-			makeMatrixMassDiag(rows, finiteElement);
-
-		RealMatrix displacements =
-			calculateDisplacementsDinamic(time, deltaT,
-				matrixStiffness, matrixMassDiag);
-
-		// Writing to "displacements.txt"
-		writeDispSecondNode(displacements);
+		// Writing node 2 to "displacements.txt" on the writer thread during
+		// the calculation, the graph is built by the decimated series (the
+		// peaks of each bucket of steps are kept)
+		TextFileSink fileSink("displacements.txt", { ACTIVE_INDICES[1] });
+		AsyncSink asyncFileSink(fileSink);
+		SeriesSink seriesSink(DECIMATION_M4);
+		SplitSink sink({ &asyncFileSink, &seriesSink });
+		runSimulation(config, sink);
 
-		RealVector dispsSecondNode = getDispSecondNode(displacements);
-		RealVector stepsTime = getStepsTime(displacements.sizeRows(), deltaT);
+		const PlotSeries& series = seriesSink.getSeries();
 
-		plt::plot(stepsTime, dispsSecondNode);
+		plt::plot(series.time, series.values);
 		plt::title("Displacements node");
 		plt::xlabel("X, sec");
 		plt::ylabel("Y, m");
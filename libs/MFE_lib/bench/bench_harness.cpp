@@ -0,0 +1,394 @@
+#include "bench_harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+#include <MFE_lib/functions_for_MFE/profiling.h>
+
+#include "bench_memory.h"
+
+using namespace MFE;
+
+namespace
+{
+	using BenchClock = std::chrono::steady_clock;
+
+	// The limit of the iterations of one sample (the kernel is too fast or
+	// empty)
+	constexpr UnsignedType BENCH_ITERATIONS_MAX = 1ULL << 30;
+}
+
+const void* volatile MFE::benchSink = nullptr;
+
+// The time of "iterations" runs of the kernel (seconds)
+static Real runKernel(const BenchKernel& kernel, const UnsignedType& iterations)
+{
+	const BenchClock::time_point start = BenchClock::now();
+	kernel(iterations);
+	return std::chrono::duration<Real>(BenchClock::now() - start).count();
+}
+
+static Real getMedian(RealVector values)
+{
+	std::sort(values.begin(), values.end());
+	const UnsignedType size = values.size();
+	if (size == 0)
+		return 0.0;
+
+	return size % 2 != 0 ? values[size / 2] :
+		0.5 * (values[size / 2 - 1] + values[size / 2]);
+}
+
+std::string MFE::getBenchName(const std::string& family,
+	const UnsignedType& size)
+{
+	return family + "/" + std::to_string(size);
+}
+
+void BenchSuite::add(const std::string& family, const UnsignedType& size,
+	const BenchKernel& kernel, const UnsignedType& itemsPerIteration,
+	const Real& flopsPerIteration)
+{
+	BenchCase benchCase;
+	benchCase.family = family;
+	benchCase.size = size;
+	benchCase.itemsPerIteration = itemsPerIteration;
+	benchCase.flopsPerIteration = flopsPerIteration;
+	benchCase.kernel = kernel;
+
+	m_cases.push_back(benchCase);
+}
+
+const std::vector<BenchCase>& BenchSuite::getCases() const
+{
+	return m_cases;
+}
+
+std::vector<BenchResult> BenchSuite::run(const BenchOptions& options,
+	std::ostream& output) const
+{
+	std::vector<BenchResult> results;
+
+	// The counters are opened once for all benchmarks
+	std::unique_ptr<PerfCounters> counters;
+	if (options.isCounted)
+	{
+		counters = std::make_unique<PerfCounters>();
+		if (!counters->isAvailable())
+		{
+			output << "The hardware counters are not available ("
+				<< counters->getError() << "), only the time is measured.\n\n";
+			counters.reset();
+		}
+	}
+
+	output << std::left << std::setw(40) << "benchmark"
+		<< std::right << std::setw(12) << "iterations"
+		<< std::setw(16) << "median, ns"
+		<< std::setw(16) << "min, ns"
+		<< std::setw(14) << "peak, bytes"
+		<< std::setw(16) << "items/s" << "\n";
+
+	for (const auto& benchCase : m_cases)
+	{
+		const std::string name = getBenchName(benchCase.family, benchCase.size);
+		if (name.find(options.filter) == std::string::npos)
+			continue;
+
+		BenchResult result = measureBench(benchCase, options, counters.get());
+
+		output << std::left << std::setw(40) << result.name
+			<< std::right << std::setw(12) << result.iterations
+			<< std::fixed << std::setprecision(1)
+			<< std::setw(16) << result.medianTime
+			<< std::setw(16) << result.minTime
+			<< std::setw(14) << result.peakMemory;
+		if (result.itemsPerIteration != 0)
+		{
+			output << std::scientific << std::setprecision(3) << std::setw(16)
+				<< result.itemsPerIteration * 1e9 / result.medianTime;
+		}
+		output << std::defaultfloat << "\n";
+
+		const std::vector<std::pair<std::string, Real>> metrics =
+			getCounterMetrics(result);
+		if (!metrics.empty())
+		{
+			output << "    " << std::setprecision(4);
+			for (const auto& metric : metrics)
+				output << " " << metric.first << " = " << metric.second;
+			output << std::setprecision(6) << "\n";
+		}
+
+		results.push_back(result);
+	}
+
+	return results;
+}
+
+// The number of iterations is increased until one sample takes minTime,
+// then the samples are measured with this number
+BenchResult MFE::measureBench(const BenchCase& benchCase,
+	const BenchOptions& options, PerfCounters* counters)
+{
+	BenchResult result;
+	result.name = getBenchName(benchCase.family, benchCase.size);
+	result.family = benchCase.family;
+	result.size = benchCase.size;
+	result.itemsPerIteration = benchCase.itemsPerIteration;
+	result.flopsPerIteration = benchCase.flopsPerIteration;
+
+	UnsignedType iterations = 1;
+	Real time = runKernel(benchCase.kernel, iterations);
+	while (time < options.minTime && iterations < BENCH_ITERATIONS_MAX)
+	{
+		// The next number is estimated by the time, but not more than 10
+		// times greater (the first runs are slower)
+		UnsignedType factor = 10;
+		if (time > 0.0)
+		{
+			const Real estimate = 1.2 * options.minTime / time;
+			factor = std::max<UnsignedType>(2,
+				std::min<UnsignedType>(10, static_cast<UnsignedType>(estimate)));
+		}
+		iterations = std::min(iterations * factor, BENCH_ITERATIONS_MAX);
+		time = runKernel(benchCase.kernel, iterations);
+	}
+	result.iterations = iterations;
+
+	const UnsignedType repetitions = std::max<UnsignedType>(1, options.repetitions);
+	for (UnsignedType sampleNum = 0; sampleNum < repetitions; ++sampleNum)
+	{
+		time = runKernel(benchCase.kernel, iterations);
+		result.samples.push_back(time * 1e9 / iterations);
+	}
+
+	// The memory of one iteration
+	const UnsignedType memoryStart = getMemoryCurrent();
+	const UnsignedType allocationsStart = getAllocationsCount();
+	resetMemoryPeak();
+	runKernel(benchCase.kernel, 1);
+	result.peakMemory = getMemoryPeak() - memoryStart;
+	result.allocations = getAllocationsCount() - allocationsStart;
+
+	// The counters of one iteration by the run of the measured number
+	if (counters != nullptr && counters->isAvailable())
+	{
+		counters->start();
+		benchCase.kernel(iterations);
+		result.counters = counters->stop();
+		for (auto& value : result.counters.values)
+			value /= static_cast<Real>(iterations);
+	}
+
+	result.medianTime = getMedian(result.samples);
+	result.minTime = *std::min_element(result.samples.begin(), result.samples.end());
+	result.maxTime = *std::max_element(result.samples.begin(), result.samples.end());
+
+	return result;
+}
+
+std::vector<std::pair<std::string, Real>> MFE::getCounterMetrics(
+	const BenchResult& result)
+{
+	std::vector<std::pair<std::string, Real>> metrics;
+	const CounterValues& counters = result.counters;
+	for (UnsignedType type = 0; type < COUNTERS_COUNT; ++type)
+	{
+		if (counters.isAvailable[type])
+		{
+			metrics.emplace_back(getPerfCounterName(static_cast<PerfCounterType>(type)),
+				counters.values[type]);
+		}
+	}
+
+	const Real cycles = counters.values[COUNTER_CYCLES];
+	if (counters.isAvailable[COUNTER_INSTRUCTIONS] && cycles > 0.0)
+		metrics.emplace_back("ipc", counters.values[COUNTER_INSTRUCTIONS] / cycles);
+
+	if (counters.isAvailable[COUNTER_CACHE_MISSES])
+	{
+		const Real cacheMisses = counters.values[COUNTER_CACHE_MISSES];
+		if (result.flopsPerIteration > 0.0)
+		{
+			metrics.emplace_back("bytesPerFlop",
+				cacheMisses * CACHE_LINE_SIZE / result.flopsPerIteration);
+		}
+
+		if (result.itemsPerIteration != 0)
+		{
+			metrics.emplace_back("cacheMissesPerItem",
+				cacheMisses / static_cast<Real>(result.itemsPerIteration));
+		}
+	}
+
+	return metrics;
+}
+
+// The date of the run in ISO 8601
+static std::string getDateText()
+{
+	const std::time_t time = std::time(nullptr);
+	std::tm localTime{};
+#ifdef _WIN32
+	localtime_s(&localTime, &time);
+#else
+	localtime_r(&time, &localTime);
+#endif
+
+	std::ostringstream output;
+	output << std::put_time(&localTime, "%Y-%m-%dT%H:%M:%S");
+	return output.str();
+}
+
+std::string MFE::formatBenchJson(const std::vector<BenchResult>& results,
+	const BenchOptions& options)
+{
+	bool isCounted = false;
+	for (const auto& result : results)
+		isCounted = isCounted || !getCounterMetrics(result).empty();
+
+	std::ostringstream output;
+	output.precision(std::numeric_limits<Real>::max_digits10);
+
+	output << "{\n"
+		<< "\t\"context\": {\n"
+		<< "\t\t\"date\": \"" << getDateText() << "\",\n"
+		<< "\t\t\"minTimeSeconds\": " << options.minTime << ",\n"
+		<< "\t\t\"repetitions\": " << options.repetitions << ",\n"
+		<< "\t\t\"profiling\": " << (isProfilingEnabled() ? "true" : "false") << ",\n"
+		<< "\t\t\"counters\": " << (isCounted ? "true" : "false") << ",\n"
+#ifdef NDEBUG
+		<< "\t\t\"debug\": false\n"
+#else
+		<< "\t\t\"debug\": true\n"
+#endif
+		<< "\t},\n"
+		<< "\t\"timeUnit\": \"ns\",\n"
+		<< "\t\"benchmarks\": [\n";
+
+	const UnsignedType resultsCount = results.size();
+	for (UnsignedType resultNum = 0; resultNum < resultsCount; ++resultNum)
+	{
+		const BenchResult& result = results[resultNum];
+		output << "\t\t{\n"
+			<< "\t\t\t\"name\": \"" << result.name << "\",\n"
+			<< "\t\t\t\"family\": \"" << result.family << "\",\n"
+			<< "\t\t\t\"size\": " << result.size << ",\n"
+			<< "\t\t\t\"iterations\": " << result.iterations << ",\n"
+			<< "\t\t\t\"itemsPerIteration\": " << result.itemsPerIteration << ",\n"
+			<< "\t\t\t\"median\": " << result.medianTime << ",\n"
+			<< "\t\t\t\"min\": " << result.minTime << ",\n"
+			<< "\t\t\t\"max\": " << result.maxTime << ",\n"
+			<< "\t\t\t\"peakMemory\": " << result.peakMemory << ",\n"
+			<< "\t\t\t\"allocations\": " << result.allocations << ",\n"
+			<< "\t\t\t\"flopsPerIteration\": " << result.flopsPerIteration << ",\n"
+			<< "\t\t\t\"samples\": [";
+
+		const UnsignedType samplesCount = result.samples.size();
+		for (UnsignedType sampleNum = 0; sampleNum < samplesCount; ++sampleNum)
+		{
+			output << result.samples[sampleNum]
+				<< (sampleNum + 1 < samplesCount ? ", " : "");
+		}
+
+		output << "]";
+
+		const std::vector<std::pair<std::string, Real>> metrics =
+			getCounterMetrics(result);
+		if (!metrics.empty())
+		{
+			output << ",\n\t\t\t\"counters\": {";
+			const UnsignedType metricsCount = metrics.size();
+			for (UnsignedType metricNum = 0; metricNum < metricsCount; ++metricNum)
+			{
+				output << "\"" << metrics[metricNum].first << "\": "
+					<< metrics[metricNum].second
+					<< (metricNum + 1 < metricsCount ? ", " : "");
+			}
+			output << "}";
+		}
+
+		output << "\n"
+			<< "\t\t}" << (resultNum + 1 < resultsCount ? ",\n" : "\n");
+	}
+
+	output << "\t]\n"
+		<< "}\n";
+
+	return output.str();
+}
+
+bool MFE::writeBenchJson(const std::vector<BenchResult>& results,
+	const BenchOptions& options, const std::string& fileName)
+{
+	std::ofstream fout(fileName);
+	if (!fout.is_open())
+		return false;
+
+	fout << formatBenchJson(results, options);
+
+	fout.close();
+	return !fout.fail();
+}
+
+bool MFE::getBenchOptionValue(const std::string& argument,
+	const std::string& key, std::string& value)
+{
+	const std::string prefix = "--" + key + "=";
+	if (argument.compare(0, prefix.size(), prefix) != 0)
+		return false;
+
+	value = argument.substr(prefix.size());
+	return true;
+}
+
+bool MFE::parseBenchValue(const std::string& value, Real& number)
+{
+	char* end = nullptr;
+	number = std::strtod(value.c_str(), &end);
+	return !value.empty() && *end == '\0' && number >= 0.0;
+}
+
+bool MFE::parseBenchOption(const std::string& argument, BenchOptions& options)
+{
+	std::string value;
+	if (argument == "--list")
+		options.isListed = true;
+	else if (argument == "--counters")
+		options.isCounted = true;
+	else if (getBenchOptionValue(argument, "filter", value))
+		options.filter = value;
+	else if (getBenchOptionValue(argument, "json", value))
+		options.jsonFile = value;
+	else if (getBenchOptionValue(argument, "min-time", value))
+		return parseBenchValue(value, options.minTime);
+	else if (getBenchOptionValue(argument, "repetitions", value))
+	{
+		char* end = nullptr;
+		options.repetitions = std::strtoull(value.c_str(), &end, 10);
+		return !value.empty() && *end == '\0' && options.repetitions != 0;
+	}
+	else
+		return false;
+
+	return true;
+}
+
+bool MFE::parseBenchOptions(int argc, char* argv[], BenchOptions& options)
+{
+	for (int argNum = 1; argNum < argc; ++argNum)
+	{
+		if (!parseBenchOption(argv[argNum], options))
+			return false;
+	}
+
+	return true;
+}
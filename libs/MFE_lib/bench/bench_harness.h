@@ -0,0 +1,156 @@
+// This file is used in the benchmark applications of MFE_lib.
+// This file contains the small harness of the microbenchmarks: the kernels
+// are registered with a family name and a size, the number of iterations of
+// a kernel is chosen so that one sample takes at least minTime seconds, and
+// several samples (repetitions) are measured. The median of the samples is
+// the result, the samples are kept for the comparison of the runs. The peak
+// of the dynamic memory and the number of the allocations of one iteration
+// are measured by a separate run (bench_memory.h). With the option
+// --counters, the hardware counters of an iteration (perf_counters.h) and
+// the metrics by them are measured by one more run.
+// The results are printed as a table and written in JSON.
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <MFE_lib/types/types.h>
+
+#include "perf_counters.h"
+
+namespace MFE
+{
+	// The kernel of a benchmark: it is run "iterations" times, the
+	// preparation of the data is done before the kernel is registered
+	using BenchKernel = std::function<void(const UnsignedType& iterations)>;
+
+	// The benchmark: name - "<family>/<size>";
+	// itemsPerIteration - the number of processed items of one iteration
+	// (for example, the time steps of a solver), 0 - no throughput;
+	// flopsPerIteration - the floating point operations of one iteration
+	// (0 - not known)
+	struct BenchCase
+	{
+		std::string family;
+		UnsignedType size = 0;
+		UnsignedType itemsPerIteration = 0;
+		Real flopsPerIteration = 0.0;
+		BenchKernel kernel;
+	};
+
+	// The result of a benchmark, the times of an iteration in nanoseconds;
+	// peakMemory - the maximum of the bytes allocated by one iteration,
+	// allocations - the number of the allocations of one iteration;
+	// counters - the hardware counters of one iteration (if measured)
+	struct BenchResult
+	{
+		std::string name;
+		std::string family;
+		UnsignedType size = 0;
+		UnsignedType iterations = 0;
+		UnsignedType itemsPerIteration = 0;
+		Real flopsPerIteration = 0.0;
+		Real medianTime = 0.0;
+		Real minTime = 0.0;
+		Real maxTime = 0.0;
+		RealVector samples;
+		UnsignedType peakMemory = 0;
+		UnsignedType allocations = 0;
+		CounterValues counters;
+	};
+
+	// filter - only the benchmarks whose name contains the text are run;
+	// minTime - the minimum time of one sample (seconds);
+	// repetitions - the number of samples of a benchmark;
+	// isCounted - the hardware counters are measured
+	struct BenchOptions
+	{
+		std::string filter = "";
+		std::string jsonFile = "";
+		Real minTime = 0.05;
+		UnsignedType repetitions = 5;
+		bool isListed = false;
+		bool isCounted = false;
+	};
+
+	class BenchSuite
+	{
+	public:
+
+		void add(const std::string& family, const UnsignedType& size,
+			const BenchKernel& kernel, const UnsignedType& itemsPerIteration = 0,
+			const Real& flopsPerIteration = 0.0);
+
+		const std::vector<BenchCase>& getCases() const;
+
+		// Running the benchmarks of the filter, the results are printed
+		// to "output" as they are measured
+		std::vector<BenchResult> run(const BenchOptions& options,
+			std::ostream& output) const;
+
+	private:
+
+		std::vector<BenchCase> m_cases;
+
+	};
+
+	std::string getBenchName(const std::string& family, const UnsignedType& size);
+
+	// Measuring one benchmark, the hardware counters are measured if
+	// "counters" is set and available
+	BenchResult measureBench(const BenchCase& benchCase,
+		const BenchOptions& options, PerfCounters* counters = nullptr);
+
+	// The counters of the result and the metrics by them: the instructions
+	// per cycle, the bytes of the cache misses per floating point operation,
+	// the cache misses per item (per time step of the solvers). Only the
+	// measured values are given.
+	std::vector<std::pair<std::string, Real>> getCounterMetrics(
+		const BenchResult& result);
+
+	// The results in JSON (the context of the run and the benchmarks)
+	std::string formatBenchJson(const std::vector<BenchResult>& results,
+		const BenchOptions& options);
+
+	bool writeBenchJson(const std::vector<BenchResult>& results,
+		const BenchOptions& options, const std::string& fileName);
+
+	// The value of the option "--key=value", false if the argument is
+	// another option
+	bool getBenchOptionValue(const std::string& argument,
+		const std::string& key, std::string& value);
+
+	// The non-negative number of the option, false if it is incorrect
+	bool parseBenchValue(const std::string& value, Real& number);
+
+	// Reading one option of the command line: --filter=, --json=,
+	// --min-time=, --repetitions=, --list, --counters. false if the option
+	// is unknown or incorrect.
+	bool parseBenchOption(const std::string& argument, BenchOptions& options);
+
+	// Reading the options of the command line (the options of
+	// parseBenchOption), false if an option is unknown or incorrect
+	bool parseBenchOptions(int argc, char* argv[], BenchOptions& options);
+
+	// The address of the last used value (the compilers without asm)
+	extern const void* volatile benchSink;
+
+	// The value is considered used, so the calculation of the kernel is
+	// not removed by the compiler
+	template <typename T>
+	inline void doNotOptimize(const T& value)
+	{
+	#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+	#else
+		benchSink = static_cast<const void*>(&value);
+	#endif
+	}
+}
+
+#endif
@@ -0,0 +1,55 @@
+//	 The microbenchmarks of the kernels of MFE_lib (kernel_benchmarks.h).
+// The results are printed as a table and, with --json, written in JSON
+// for the comparison of the runs. With --counters, the hardware counters of
+// the kernels are measured too (perf_counters.h).
+//
+// Usage: MFE_lib_bench [--filter=text] [--json=file] [--min-time=seconds]
+//	[--repetitions=N] [--counters] [--list]
+
+#include <cstdlib>
+#include <iostream>
+
+#include "kernel_benchmarks.h"
+
+using namespace MFE;
+
+int main(int argc, char* argv[])
+{
+	BenchOptions options;
+	if (!parseBenchOptions(argc, argv, options))
+	{
+		std::cout << "Usage: " << argv[0] << " [--filter=text] [--json=file]"
+			<< " [--min-time=seconds] [--repetitions=N] [--counters] [--list]\n";
+		return EXIT_FAILURE;
+	}
+
+	BenchSuite suite;
+	addKernelBenchmarks(suite);
+
+	if (options.isListed)
+	{
+		for (const auto& benchCase : suite.getCases())
+			std::cout << getBenchName(benchCase.family, benchCase.size) << "\n";
+		return EXIT_SUCCESS;
+	}
+
+	try
+	{
+		const std::vector<BenchResult> results = suite.run(options, std::cout);
+
+		if (!options.jsonFile.empty() &&
+			!writeBenchJson(results, options, options.jsonFile))
+		{
+			std::cerr << "The file \"" << options.jsonFile
+				<< "\" was not written.\n";
+			return EXIT_FAILURE;
+		}
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+#include "bench_memory.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace MFE;
+
+namespace
+{
+	// The size of the block is kept before it, the header keeps the
+	// alignment of the block
+	constexpr std::size_t MEMORY_HEADER_SIZE = alignof(std::max_align_t);
+
+	std::atomic<UnsignedType> memoryCurrent{ 0 };
+	std::atomic<UnsignedType> memoryPeak{ 0 };
+	std::atomic<UnsignedType> allocationsCount{ 0 };
+}
+
+static void* allocateCounted(std::size_t size)
+{
+	void* block = std::malloc(size + MEMORY_HEADER_SIZE);
+	if (block == nullptr)
+		return nullptr;
+
+	*static_cast<std::size_t*>(block) = size;
+	allocationsCount.fetch_add(1, std::memory_order_relaxed);
+
+	const UnsignedType current =
+		memoryCurrent.fetch_add(size, std::memory_order_relaxed) + size;
+	UnsignedType peak = memoryPeak.load(std::memory_order_relaxed);
+	while (current > peak &&
+		!memoryPeak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+	{
+	}
+
+	return static_cast<char*>(block) + MEMORY_HEADER_SIZE;
+}
+
+static void freeCounted(void* pointer)
+{
+	if (pointer == nullptr)
+		return;
+
+	void* block = static_cast<char*>(pointer) - MEMORY_HEADER_SIZE;
+	memoryCurrent.fetch_sub(*static_cast<std::size_t*>(block),
+		std::memory_order_relaxed);
+	std::free(block);
+}
+
+UnsignedType MFE::getMemoryCurrent()
+{
+	return memoryCurrent.load(std::memory_order_relaxed);
+}
+
+UnsignedType MFE::getMemoryPeak()
+{
+	return memoryPeak.load(std::memory_order_relaxed);
+}
+
+void MFE::resetMemoryPeak()
+{
+	memoryPeak.store(memoryCurrent.load(std::memory_order_relaxed),
+		std::memory_order_relaxed);
+}
+
+UnsignedType MFE::getAllocationsCount()
+{
+	return allocationsCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+	void* pointer = allocateCounted(size);
+	if (pointer == nullptr)
+		throw std::bad_alloc();
+
+	return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocateCounted(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocateCounted(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	freeCounted(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	freeCounted(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	freeCounted(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	freeCounted(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	freeCounted(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	freeCounted(pointer);
+}
@@ -0,0 +1,28 @@
+// This file is used in the benchmark applications of MFE_lib.
+// This file contains the counters of the dynamic memory of the benchmarks:
+// the global operators new and delete are replaced in bench_memory.cpp, so
+// the allocations of the library and of the benchmarks are counted. The
+// counters do not depend on the load of the machine, so the changes of the
+// memory are found exactly.
+
+#ifndef BENCH_MEMORY_H
+#define BENCH_MEMORY_H
+
+#include <MFE_lib/types/types.h>
+
+namespace MFE
+{
+	// The bytes that are allocated now
+	UnsignedType getMemoryCurrent();
+
+	// The maximum of the allocated bytes since the last reset
+	UnsignedType getMemoryPeak();
+
+	// The peak is set to the current allocated bytes
+	void resetMemoryPeak();
+
+	// The number of the allocations since the start of the program
+	UnsignedType getAllocationsCount();
+}
+
+#endif
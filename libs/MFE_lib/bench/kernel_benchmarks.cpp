@@ -0,0 +1,495 @@
+#include "kernel_benchmarks.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+
+#include <MFE_lib/math_functions.h>
+#include <MFE_lib/functions_for_MFE/element_batch.h>
+#include <MFE_lib/functions_for_MFE/element_cache.h>
+#include <MFE_lib/functions_for_MFE/hex_mesh.h>
+#include <MFE_lib/functions_for_MFE/high_order_mesh.h>
+#include <MFE_lib/functions_for_MFE/mesh_operator.h>
+#include <MFE_lib/functions_for_MFE/initial_conditions.h>
+#include <MFE_lib/functions_for_MFE/matrix_MFE.h>
+
+#include "operator_overloading/operator_overloading.h"
+
+using namespace MFE;
+
+namespace
+{
+	// The sizes of the vectors, of the matrices and the number of the time
+	// steps of the solvers (the floating point operations of the kernels
+	// are given by the sizes for the metrics of the hardware counters)
+	constexpr std::array<UnsignedType, 3> VECTOR_SIZES = { 24, 256, 4096 };
+	constexpr std::array<UnsignedType, 3> MATRIX_SIZES = { 12, 24, 96 };
+	constexpr std::array<UnsignedType, 2> SOLVER_STEPS = { 100, 1000 };
+
+	// The numbers of the elements of the mesh along each direction
+	constexpr std::array<UnsignedType, 2> MESH_SIZES = { 4, 8 };
+
+	// The orders of the elements of the mesh of 4 x 4 x 4 elements
+	constexpr std::array<UnsignedType, 2> ELEMENT_ORDERS = { 2, 4 };
+
+	// The time step of the friction solvers, the static load of the
+	// initial displacements of the problem of dry friction without force
+	constexpr Real BENCH_DELTA_T = 1e-6;
+	constexpr Real BENCH_STATIC_LOAD = 30000.0;
+}
+
+// The vector with different values (the values do not grow in the kernels)
+static RealVector makeBenchVector(const UnsignedType& size)
+{
+	RealVector vec(size, 0.0);
+	for (UnsignedType index = 0; index < size; ++index)
+		vec[index] = 1.0 + 1e-3 * std::sin(static_cast<Real>(index));
+
+	return vec;
+}
+
+static RealMatrix makeBenchMatrix(const UnsignedType& rows,
+	const UnsignedType& columns)
+{
+	RealMatrix matrix(rows, columns);
+	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
+	{
+		for (UnsignedType columnNum = 0; columnNum < columns; ++columnNum)
+			matrix[rowNum][columnNum] = std::cos(static_cast<Real>(rowNum * columns + columnNum));
+	}
+
+	return matrix;
+}
+
+// The symmetric positive definite matrix (the diagonal dominates)
+static RealMatrix makeSymmetricMatrix(const UnsignedType& size)
+{
+	RealMatrix matrix(size, size);
+	for (UnsignedType rowNum = 0; rowNum < size; ++rowNum)
+	{
+		for (UnsignedType columnNum = 0; columnNum < size; ++columnNum)
+		{
+			const UnsignedType distance = rowNum > columnNum ?
+				rowNum - columnNum : columnNum - rowNum;
+			matrix[rowNum][columnNum] = 1.0 / (1.0 + distance);
+		}
+		matrix[rowNum][rowNum] += static_cast<Real>(size);
+	}
+
+	return matrix;
+}
+
+void BenchSink::begin(const SinkHeader&)
+{
+}
+
+void BenchSink::record(const UnsignedType&, const RealVector& displacement,
+	const bool&)
+{
+	doNotOptimize(displacement);
+}
+
+void BenchSink::end()
+{
+}
+
+void MFE::addMatrixBenchmarks(BenchSuite& suite)
+{
+	for (const auto& size : MATRIX_SIZES)
+	{
+		suite.add("matrix_construct", size, [size](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					RealMatrix matrix(size, size);
+					doNotOptimize(matrix);
+				}
+			});
+
+		auto matrix = std::make_shared<RealMatrix>(makeBenchMatrix(size, size));
+		suite.add("matrix_access", size, [matrix, size](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					Real sum = 0.0;
+					for (UnsignedType rowNum = 0; rowNum < size; ++rowNum)
+					{
+						for (UnsignedType columnNum = 0; columnNum < size; ++columnNum)
+							sum += (*matrix)[rowNum][columnNum];
+					}
+					doNotOptimize(sum);
+				}
+			});
+	}
+}
+
+void MFE::addOperatorBenchmarks(BenchSuite& suite)
+{
+	for (const auto& size : VECTOR_SIZES)
+	{
+		auto lhs = std::make_shared<RealVector>(makeBenchVector(size));
+		auto rhs = std::make_shared<RealVector>(makeBenchVector(size));
+
+		suite.add("vector_scale_left", size, [lhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(0.5 * *lhs);
+			}, 0, static_cast<Real>(size));
+
+		suite.add("vector_scale_right", size, [lhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs * 0.5);
+			}, 0, static_cast<Real>(size));
+
+		// The sum and the difference are alternated, so the values stay
+		suite.add("vector_add_assign", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					if (iteration % 2 == 0)
+						*lhs += *rhs;
+					else
+						*lhs -= *rhs;
+					doNotOptimize(*lhs);
+				}
+			}, 0, static_cast<Real>(size));
+
+		suite.add("vector_sub_assign", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					if (iteration % 2 == 0)
+						*lhs -= *rhs;
+					else
+						*lhs += *rhs;
+					doNotOptimize(*lhs);
+				}
+			}, 0, static_cast<Real>(size));
+
+		suite.add("vector_add", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs + *rhs);
+			}, 0, static_cast<Real>(size));
+
+		suite.add("vector_sub", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs - *rhs);
+			}, 0, static_cast<Real>(size));
+
+		suite.add("vector_dot", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs * *rhs);
+			}, 0, 2.0 * size);
+	}
+
+	for (const auto& size : MATRIX_SIZES)
+	{
+		auto vec = std::make_shared<RealVector>(makeBenchVector(size));
+		auto lhs = std::make_shared<RealMatrix>(makeBenchMatrix(size, size));
+		auto rhs = std::make_shared<RealMatrix>(makeBenchMatrix(size, size));
+
+		suite.add("vector_outer", size, [vec](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(matrixMultipOfVectors(*vec, *vec));
+			}, 0, 1.0 * size * size);
+
+		suite.add("matrix_vector", size, [lhs, vec](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs * *vec);
+			}, 0, 2.0 * size * size);
+
+		suite.add("vector_matrix", size, [lhs, vec](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*vec * *lhs);
+			}, 0, 2.0 * size * size);
+
+		suite.add("matrix_scale_left", size, [lhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(0.5 * *lhs);
+			}, 0, 1.0 * size * size);
+
+		suite.add("matrix_scale_right", size, [lhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs * 0.5);
+			}, 0, 1.0 * size * size);
+
+		suite.add("matrix_add", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs + *rhs);
+			}, 0, 1.0 * size * size);
+
+		suite.add("matrix_sub", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs - *rhs);
+			}, 0, 1.0 * size * size);
+
+		suite.add("matrix_multiply", size, [lhs, rhs](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(*lhs * *rhs);
+			}, 0, 2.0 * size * size * size);
+	}
+}
+
+void MFE::addLinearSolverBenchmarks(BenchSuite& suite)
+{
+	for (const auto& size : MATRIX_SIZES)
+	{
+		auto matrix = std::make_shared<RealMatrix>(makeSymmetricMatrix(size));
+		auto freeTerms = std::make_shared<RealVector>(makeBenchVector(size));
+
+		suite.add("cholesky", size, [matrix](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(createMatrixCholesky(*matrix));
+			}, 0, size * size * size / 3.0);
+
+		suite.add("reflection_solve", size, [matrix, freeTerms](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(solveReflectionMethod(*matrix, *freeTerms));
+			}, 0, 4.0 * size * size * size / 3.0);
+
+		suite.add("static_solve", size, [matrix, freeTerms](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(calculateDispStatic(*matrix, *freeTerms));
+			}, 0, size * size * size / 3.0 + 2.0 * size * size);
+	}
+
+	// The stiffness matrix of the finite element (24 degrees of freedom)
+	const FiniteElement finiteElement;
+	suite.add("element_stiffness", 24, [finiteElement](const UnsignedType& iterations)
+		{
+			for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				doNotOptimize(makeMatrixStiffness(finiteElement));
+		});
+
+	// The sweep by the modulus of elasticity: the stiffness for the modulus
+	// 1 of the geometry is found in the cache and scaled
+	suite.add("element_stiffness_modulus_sweep", 24,
+		[finiteElement](const UnsignedType& iterations)
+		{
+			ElementMatrixCache cache;
+			FiniteElement element = finiteElement;
+			for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+			{
+				element.modulusElastic = finiteElement.modulusElastic *
+					(1.0 + 1.0e-3 * static_cast<Real>(iteration % 100));
+				doNotOptimize(cache.getStiffness(element));
+			}
+		});
+
+	// The stiffness matrices of STIFFNESS_LANES elements of different sizes
+	// and materials at once (one iteration is one batch)
+	std::vector<FiniteElement> elements(STIFFNESS_LANES, finiteElement);
+	for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+	{
+		const Real factor = 1.0 + 0.1 * static_cast<Real>(lane);
+		elements[lane].length *= factor;
+		elements[lane].modulusElastic *= factor;
+	}
+	const ElementBatch batch = makeElementBatch(elements, 0);
+	suite.add("element_stiffness_batch", 24, [batch](const UnsignedType& iterations)
+		{
+			auto stiffness = std::make_unique<BatchStiffness>();
+			for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+			{
+				makeMatrixStiffnessBatch(batch, *stiffness);
+				doNotOptimize(*stiffness);
+			}
+		});
+}
+
+// The configuration of the friction mode (the parameters of the examples
+// of README) with the time of "steps" steps
+static SimulationConfig makeBenchConfig(const FrictionMode& frictionMode,
+	const UnsignedType& steps)
+{
+	SimulationConfig config = makeDefaultConfig(frictionMode);
+	config.name = "bench";
+	config.deltaT = BENCH_DELTA_T;
+	// Half of the step is added, so the number of steps is not
+	// reduced by the rounding of time / deltaT
+	config.time = (static_cast<Real>(steps) + 0.5) * BENCH_DELTA_T;
+
+	if (frictionMode == FRICTION_VISCOUS_DRIVE)
+	{
+		config.coeffViscousFriction = 1.5;
+		config.initialSpeed = 1.0;
+	}
+	else
+	{
+		config.coeffDryFrictionRest = 0.5;
+		config.coeffDryFrictionSliding = 0.3;
+	}
+
+	if (frictionMode == FRICTION_DRY_FREE)
+		config.initialStaticLoad = BENCH_STATIC_LOAD;
+
+	return config;
+}
+
+void MFE::addFrictionSolverBenchmarks(BenchSuite& suite)
+{
+	const FiniteElement finiteElement;
+	auto matrixStiffness =
+		std::make_shared<RealMatrix>(makeMatrixStiffness(finiteElement));
+	const UnsignedType rows = matrixStiffness->sizeRows();
+	auto matrixMass =
+		std::make_shared<RealMatrix>(makeMatrixMassDiag(rows, finiteElement));
+
+	for (const auto& steps : SOLVER_STEPS)
+	{
+		const SimulationConfig configFree = makeBenchConfig(FRICTION_DRY_FREE, steps);
+		auto initialFree = std::make_shared<RealVector>(
+			makeInitialDisps(*matrixStiffness, configFree.initialStaticLoad));
+		suite.add("dry_friction_free", steps,
+			[configFree, matrixStiffness, matrixMass, initialFree](
+				const UnsignedType& iterations)
+			{
+				BenchSink sink;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					dryFrictionFree(configFree, *matrixStiffness, *matrixMass, *initialFree, sink);
+			}, steps);
+
+		const SimulationConfig configForced = makeBenchConfig(FRICTION_DRY_DRIVE, steps);
+		auto initialZero = std::make_shared<RealVector>(rows, 0.0);
+		suite.add("forced_dry_friction", steps,
+			[configForced, matrixStiffness, matrixMass, initialZero](
+				const UnsignedType& iterations)
+			{
+				BenchSink sink;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					forcedDryFriction(configForced, *matrixStiffness, *matrixMass, *initialZero, sink);
+			}, steps);
+
+		const SimulationConfig configViscous =
+			makeBenchConfig(FRICTION_VISCOUS_DRIVE, steps);
+		suite.add("viscous_friction_force", steps,
+			[configViscous, matrixStiffness, matrixMass, initialZero](
+				const UnsignedType& iterations)
+			{
+				BenchSink sink;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					viscousFrictionForce(configViscous, *matrixStiffness, *matrixMass, *initialZero, sink);
+			}, steps);
+	}
+}
+
+void MFE::addMeshBenchmarks(BenchSuite& suite)
+{
+	const FiniteElement body;
+	for (const auto& size : MESH_SIZES)
+	{
+		auto mesh = std::make_shared<HexMesh>(makeHexMesh(body, size, size, size));
+		auto matrixStiffness =
+			std::make_shared<SparseMatrix>(assembleStiffnessMesh(*mesh));
+		boundConditionStaticMesh(*mesh, *matrixStiffness);
+		auto force = std::make_shared<RealVector>(
+			makeStaticForceMesh(*mesh, BENCH_STATIC_LOAD));
+		const UnsignedType elementsCount = mesh->elements.size();
+		const Real nonZeros = static_cast<Real>(matrixStiffness->values.size());
+
+		suite.add("mesh_assembly", size, [mesh](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(assembleStiffnessMesh(*mesh));
+			}, elementsCount);
+
+		suite.add("mesh_spmv", size, [matrixStiffness, force](const UnsignedType& iterations)
+			{
+				RealVector result;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					multiplySparse(*matrixStiffness, *force, result);
+					doNotOptimize(result);
+				}
+			}, 0, 2.0 * nonZeros);
+
+		// The same product without the global matrix
+		auto matrixFree = std::make_shared<MeshStiffnessOperator>(*mesh, 1);
+		matrixFree->boundConditionStatic();
+		suite.add("mesh_matrix_free", size, [mesh, matrixFree, force](const UnsignedType& iterations)
+			{
+				RealVector result;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					matrixFree->apply(*force, result);
+					doNotOptimize(result);
+				}
+			}, 0, 2.0 * ELEMENT_DOF_COUNT * ELEMENT_DOF_COUNT * elementsCount);
+
+		// The elements with the reduced integration: the gradient and the
+		// hourglass modes instead of the matrix of the element
+		FiniteElement reducedBody = body;
+		reducedBody.formulation = FORMULATION_REDUCED_INTEGRATION;
+		auto reducedMesh = std::make_shared<HexMesh>(
+			makeHexMesh(reducedBody, size, size, size));
+		auto reducedMatrixFree =
+			std::make_shared<MeshStiffnessOperator>(*reducedMesh, 1);
+		reducedMatrixFree->boundConditionStatic();
+		suite.add("mesh_matrix_free_reduced", size,
+			[reducedMesh, reducedMatrixFree, force](const UnsignedType& iterations)
+			{
+				RealVector result;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					reducedMatrixFree->apply(*force, result);
+					doNotOptimize(result);
+				}
+			}, 0, 4.0 * ELEMENT_DOF_COUNT *
+			(ELEMENT_DIMENSIONS_COUNT + HOURGLASS_MODES_COUNT) * elementsCount);
+
+		suite.add("mesh_static_cg", size, [matrixStiffness, force](const UnsignedType& iterations)
+			{
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					doNotOptimize(solveConjugateGradient(*matrixStiffness, *force));
+			});
+	}
+
+	// The product by the stiffness of the elements of the order p by sum
+	// factorization: 16 one-dimensional products (2 * n^4 operations,
+	// n = p + 1) for each direction of the element
+	for (const auto& order : ELEMENT_ORDERS)
+	{
+		const UnsignedType size = MESH_SIZES[0];
+		auto mesh = std::make_shared<HighOrderMesh>(
+			makeHighOrderMesh(body, order, size, size, size));
+		auto matrixFree = std::make_shared<HighOrderStiffnessOperator>(*mesh, 1);
+		matrixFree->boundConditionStatic();
+		auto force = std::make_shared<RealVector>(
+			makeStaticForceHighOrder(*mesh, BENCH_STATIC_LOAD));
+		const Real pointsCount = static_cast<Real>(order + 1);
+		suite.add("mesh_high_order", order, [mesh, matrixFree, force](const UnsignedType& iterations)
+			{
+				RealVector result;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+				{
+					matrixFree->apply(*force, result);
+					doNotOptimize(result);
+				}
+			}, 0, 96.0 * pointsCount * pointsCount * pointsCount * pointsCount *
+			static_cast<Real>(size * size * size));
+	}
+}
+
+void MFE::addKernelBenchmarks(BenchSuite& suite)
+{
+	addMatrixBenchmarks(suite);
+	addOperatorBenchmarks(suite);
+	addLinearSolverBenchmarks(suite);
+	addFrictionSolverBenchmarks(suite);
+	addMeshBenchmarks(suite);
+}
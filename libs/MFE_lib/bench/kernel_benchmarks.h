@@ -0,0 +1,51 @@
+// This file is used in the benchmark applications of MFE_lib.
+// This file contains the benchmarks of the kernels of the library: the
+// construction of the matrix and the access to it, the operators of the
+// vectors and the matrices (operator_overloading.h), the Cholesky
+// decomposition, the reflection method, the static problem, the stiffness
+// matrix of the finite element, the time steps of the friction solvers and
+// the global matrices of the mesh (hex_mesh.h).
+// The kernels are measured for several sizes: the vector size, the number of
+// rows of the matrix, the number of time steps of the solver.
+
+#ifndef KERNEL_BENCHMARKS_H
+#define KERNEL_BENCHMARKS_H
+
+#include <MFE_lib/functions_for_MFE/dinamic_solver_MFE.h>
+
+#include "bench_harness.h"
+
+namespace MFE
+{
+	// The sink without the output, the displacements are only used
+	class BenchSink : public ResultSink
+	{
+	public:
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step, const RealVector& displacement,
+			const bool& isStuck) override;
+
+		void end() override;
+
+	};
+
+	void addMatrixBenchmarks(BenchSuite& suite);
+
+	void addOperatorBenchmarks(BenchSuite& suite);
+
+	void addLinearSolverBenchmarks(BenchSuite& suite);
+
+	void addFrictionSolverBenchmarks(BenchSuite& suite);
+
+	// The assembly of the global stiffness matrix of the mesh, its product
+	// by a vector (stored and matrix-free) and the static problem by the
+	// conjugate gradient method
+	void addMeshBenchmarks(BenchSuite& suite);
+
+	// All benchmarks of the kernels
+	void addKernelBenchmarks(BenchSuite& suite);
+}
+
+#endif
@@ -0,0 +1,194 @@
+//	 The check of the performance of MFE_lib: the end-to-end scenarios
+// (scenario_benchmarks.h) and the benchmarks of the kernels are measured and
+// compared with the baseline (perf_compare.h). The slower benchmarks are
+// measured once more and are reported only if they are slower again. The
+// program returns an error if a benchmark is slower or takes more memory
+// than the baseline allows, so it can be run after the changes of the
+// solvers. The results that must not change are checked before the
+// benchmarks (result_checks.h).
+//	 The baseline is written by --write-baseline on the same machine (for
+// example, before the changes), the times of other machines are not
+// comparable with it, so it is not stored in the repository.
+//
+// Usage: MFE_lib_perf_check [--baseline=file] [--write-baseline]
+//	[--time-threshold=0.10] [--memory-threshold=0.05] [--alpha=0.05]
+//	[--filter=text] [--json=file] [--min-time=seconds] [--repetitions=N]
+//	[--counters] [--list] [--help]
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include <MFE_lib/functions_for_MFE/profiling.h>
+
+#include "kernel_benchmarks.h"
+#include "perf_compare.h"
+#include "result_checks.h"
+#include "scenario_benchmarks.h"
+
+using namespace MFE;
+
+#ifndef PERF_BASELINE_FILE
+	#define PERF_BASELINE_FILE "perf_baseline.json"
+#endif
+
+int main(int argc, char* argv[])
+{
+	BenchOptions options;
+	// More samples than in MFE_lib_bench for the test
+	options.repetitions = 9;
+
+	PerfThresholds thresholds;
+	std::string baselineFile = PERF_BASELINE_FILE;
+	bool isBaselineWritten = false;
+	bool isHelp = false;
+
+	bool isCorrect = true;
+	for (int argNum = 1; argNum < argc && isCorrect; ++argNum)
+	{
+		const std::string argument = argv[argNum];
+		std::string value;
+
+		if (argument == "--write-baseline")
+			isBaselineWritten = true;
+		else if (argument == "--help")
+			isHelp = true;
+		else if (getBenchOptionValue(argument, "baseline", value))
+			baselineFile = value;
+		else if (getBenchOptionValue(argument, "time-threshold", value))
+			isCorrect = parseBenchValue(value, thresholds.timeThreshold);
+		else if (getBenchOptionValue(argument, "memory-threshold", value))
+			isCorrect = parseBenchValue(value, thresholds.memoryThreshold);
+		else if (getBenchOptionValue(argument, "alpha", value))
+			isCorrect = parseBenchValue(value, thresholds.alpha);
+		else
+			isCorrect = parseBenchOption(argument, options);
+	}
+
+	if (!isCorrect || isHelp)
+	{
+		std::cout << "Usage: " << argv[0] << " [--baseline=file] [--write-baseline]"
+			<< " [--time-threshold=0.10] [--memory-threshold=0.05] [--alpha=0.05]"
+			<< " [--filter=text] [--json=file] [--min-time=seconds]"
+			<< " [--repetitions=N] [--counters] [--list] [--help]\n";
+		return isCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	BenchSuite suite;
+	addScenarioBenchmarks(suite);
+	addKernelBenchmarks(suite);
+
+	// The list does not need the baseline
+	if (options.isListed)
+	{
+		for (const auto& benchCase : suite.getCases())
+			std::cout << getBenchName(benchCase.family, benchCase.size) << "\n";
+		return EXIT_SUCCESS;
+	}
+
+	if (!isBaselineWritten && !std::ifstream(baselineFile).is_open())
+	{
+		std::cerr << "There is no baseline \"" << baselineFile << "\" of this "
+			<< "machine, it is written by " << argv[0] << " --write-baseline "
+			<< "(the target perf_baseline) before the changes.\n";
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		// The baseline is read before the run, so a wrong file is found
+		// at once
+		BenchBaseline baseline;
+		if (!isBaselineWritten)
+			baseline = readBenchJson(baselineFile);
+
+		// The times of the wrong results are not measured
+		if (!runResultChecks(std::cout))
+		{
+			std::cerr << "The checks of the results of MFE_lib failed.\n";
+			return EXIT_FAILURE;
+		}
+
+		const std::vector<BenchResult> results = suite.run(options, std::cout);
+
+		if (!options.jsonFile.empty() &&
+			!writeBenchJson(results, options, options.jsonFile))
+		{
+			std::cerr << "The file \"" << options.jsonFile
+				<< "\" was not written.\n";
+			return EXIT_FAILURE;
+		}
+
+		if (isBaselineWritten)
+		{
+			if (!writeBenchJson(results, options, baselineFile))
+			{
+				std::cerr << "The file \"" << baselineFile << "\" was not written.\n";
+				return EXIT_FAILURE;
+			}
+
+			std::cout << "\nThe baseline is written to \"" << baselineFile << "\"\n";
+			return EXIT_SUCCESS;
+		}
+
+#ifdef NDEBUG
+		const bool isDebug = false;
+#else
+		const bool isDebug = true;
+#endif
+		if (baseline.isDebug != isDebug || baseline.isProfiling != isProfilingEnabled())
+		{
+			std::cout << "\nWarning: the baseline is measured with another build "
+				<< "(debug or profiling), the times are not comparable.\n";
+		}
+
+		std::vector<PerfComparison> comparisons =
+			comparePerf(baseline, results, thresholds, options.filter.empty());
+
+		// The slower benchmarks are measured again, the regression is kept
+		// only if it is confirmed (the noise of the machine is not reported)
+		std::vector<BenchResult> resultsConfirmed;
+		for (const auto& comparison : comparisons)
+		{
+			if (comparison.status != PERF_SLOWER)
+				continue;
+
+			for (const auto& benchCase : suite.getCases())
+			{
+				if (getBenchName(benchCase.family, benchCase.size) == comparison.name)
+					resultsConfirmed.push_back(measureBench(benchCase, options));
+			}
+		}
+
+		if (!resultsConfirmed.empty())
+		{
+			std::cout << "\nThe slower benchmarks are measured again: "
+				<< resultsConfirmed.size() << "\n";
+			for (const auto& comparisonConfirmed :
+				comparePerf(baseline, resultsConfirmed, thresholds, false))
+			{
+				for (auto& comparison : comparisons)
+				{
+					if (comparison.name == comparisonConfirmed.name &&
+						comparisonConfirmed.status != PERF_SLOWER)
+						comparison = comparisonConfirmed;
+				}
+			}
+		}
+
+		writePerfReport(std::cout, comparisons, thresholds);
+
+		for (const auto& comparison : comparisons)
+		{
+			if (isPerfRegression(comparison))
+				return EXIT_FAILURE;
+		}
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
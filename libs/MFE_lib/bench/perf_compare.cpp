@@ -0,0 +1,560 @@
+#include "perf_compare.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+using namespace MFE;
+
+namespace
+{
+	// The largest samples, for which the exact distribution of the
+	// Mann-Whitney statistic is calculated
+	constexpr UnsignedType MANN_WHITNEY_EXACT_MAX = 20;
+
+	// The value of the JSON file (only the values of the files of the
+	// benchmarks: objects, arrays, strings, numbers, true, false, null)
+	struct JsonValue
+	{
+		enum Type {JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY,
+			JSON_OBJECT};
+
+		Type type = JSON_NULL;
+		bool isTrue = false;
+		Real number = 0.0;
+		std::string text;
+		std::vector<JsonValue> items;
+		std::vector<std::pair<std::string, JsonValue>> members;
+
+		const JsonValue* find(const std::string& key) const
+		{
+			for (const auto& member : members)
+			{
+				if (member.first == key)
+					return &member.second;
+			}
+			return nullptr;
+		}
+	};
+
+	class JsonReader
+	{
+	public:
+
+		JsonReader(const std::string& text, const std::string& fileName) :
+			m_text(text), m_fileName(fileName)
+		{
+		}
+
+		JsonValue readDocument()
+		{
+			JsonValue value = readValue();
+			skipSpaces();
+			if (m_pos != m_text.size())
+				fail();
+
+			return value;
+		}
+
+	private:
+
+		[[noreturn]] void fail() const
+		{
+			throw std::runtime_error("The file \"" + m_fileName +
+				"\" is written incorrectly (position " + std::to_string(m_pos) + "). ");
+		}
+
+		void skipSpaces()
+		{
+			while (m_pos < m_text.size() &&
+				std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+				++m_pos;
+		}
+
+		bool readSymbol(const char& symbol)
+		{
+			skipSpaces();
+			if (m_pos < m_text.size() && m_text[m_pos] == symbol)
+			{
+				++m_pos;
+				return true;
+			}
+			return false;
+		}
+
+		bool readWord(const std::string& word)
+		{
+			if (m_text.compare(m_pos, word.size(), word) != 0)
+				return false;
+
+			m_pos += word.size();
+			return true;
+		}
+
+		std::string readString()
+		{
+			if (!readSymbol('"'))
+				fail();
+
+			std::string text;
+			while (m_pos < m_text.size() && m_text[m_pos] != '"')
+			{
+				if (m_text[m_pos] == '\\')
+					++m_pos;
+				if (m_pos < m_text.size())
+					text += m_text[m_pos++];
+			}
+
+			if (!readSymbol('"'))
+				fail();
+
+			return text;
+		}
+
+		JsonValue readValue()
+		{
+			JsonValue value;
+			skipSpaces();
+			if (m_pos >= m_text.size())
+				fail();
+
+			const char symbol = m_text[m_pos];
+			if (symbol == '{')
+			{
+				value.type = JsonValue::JSON_OBJECT;
+				++m_pos;
+				if (readSymbol('}'))
+					return value;
+				do
+				{
+					std::string key = readString();
+					if (!readSymbol(':'))
+						fail();
+					value.members.emplace_back(std::move(key), readValue());
+				} while (readSymbol(','));
+				if (!readSymbol('}'))
+					fail();
+			}
+			else if (symbol == '[')
+			{
+				value.type = JsonValue::JSON_ARRAY;
+				++m_pos;
+				if (readSymbol(']'))
+					return value;
+				do
+				{
+					value.items.push_back(readValue());
+				} while (readSymbol(','));
+				if (!readSymbol(']'))
+					fail();
+			}
+			else if (symbol == '"')
+			{
+				value.type = JsonValue::JSON_STRING;
+				value.text = readString();
+			}
+			else if (readWord("true") || readWord("false"))
+			{
+				value.type = JsonValue::JSON_BOOL;
+				value.isTrue = symbol == 't';
+			}
+			else if (readWord("null"))
+				value.type = JsonValue::JSON_NULL;
+			else
+			{
+				char* end = nullptr;
+				value.type = JsonValue::JSON_NUMBER;
+				value.number = std::strtod(m_text.c_str() + m_pos, &end);
+				const std::size_t size = end - (m_text.c_str() + m_pos);
+				if (size == 0)
+					fail();
+				m_pos += size;
+			}
+
+			return value;
+		}
+
+		const std::string& m_text;
+		std::string m_fileName;
+		std::size_t m_pos = 0;
+
+	};
+}
+
+// The number of the member, 0 if it is not set
+static Real getJsonNumber(const JsonValue& object, const std::string& key)
+{
+	const JsonValue* value = object.find(key);
+	return value != nullptr && value->type == JsonValue::JSON_NUMBER ?
+		value->number : 0.0;
+}
+
+static UnsignedType getJsonUnsigned(const JsonValue& object,
+	const std::string& key)
+{
+	return static_cast<UnsignedType>(std::llround(getJsonNumber(object, key)));
+}
+
+static bool getJsonBool(const JsonValue& object, const std::string& key)
+{
+	const JsonValue* value = object.find(key);
+	return value != nullptr && value->type == JsonValue::JSON_BOOL &&
+		value->isTrue;
+}
+
+BenchBaseline MFE::readBenchJson(const std::string& fileName)
+{
+	std::ifstream fin(fileName);
+	if (!fin.is_open())
+		throw std::runtime_error("The file \"" + fileName + "\" was not opened. ");
+
+	std::ostringstream buffer;
+	buffer << fin.rdbuf();
+	const std::string text = buffer.str();
+	const JsonValue document = JsonReader(text, fileName).readDocument();
+
+	const JsonValue* benchmarks = document.find("benchmarks");
+	if (benchmarks == nullptr || benchmarks->type != JsonValue::JSON_ARRAY)
+	{
+		throw std::runtime_error("The file \"" + fileName +
+			"\" has no benchmarks. ");
+	}
+
+	BenchBaseline baseline;
+	const JsonValue* context = document.find("context");
+	if (context != nullptr)
+	{
+		baseline.isDebug = getJsonBool(*context, "debug");
+		baseline.isProfiling = getJsonBool(*context, "profiling");
+	}
+
+	for (const auto& benchmark : benchmarks->items)
+	{
+		BenchResult result;
+		const JsonValue* name = benchmark.find("name");
+		if (name == nullptr || name->type != JsonValue::JSON_STRING)
+		{
+			throw std::runtime_error("The file \"" + fileName +
+				"\" has a benchmark without the name. ");
+		}
+
+		result.name = name->text;
+		const JsonValue* family = benchmark.find("family");
+		if (family != nullptr)
+			result.family = family->text;
+		result.size = getJsonUnsigned(benchmark, "size");
+		result.iterations = getJsonUnsigned(benchmark, "iterations");
+		result.itemsPerIteration = getJsonUnsigned(benchmark, "itemsPerIteration");
+		result.medianTime = getJsonNumber(benchmark, "median");
+		result.minTime = getJsonNumber(benchmark, "min");
+		result.maxTime = getJsonNumber(benchmark, "max");
+		result.peakMemory = getJsonUnsigned(benchmark, "peakMemory");
+		result.allocations = getJsonUnsigned(benchmark, "allocations");
+
+		const JsonValue* samples = benchmark.find("samples");
+		if (samples != nullptr)
+		{
+			for (const auto& sample : samples->items)
+				result.samples.push_back(sample.number);
+		}
+
+		baseline.results.push_back(result);
+	}
+
+	return baseline;
+}
+
+// The number of the orders of the samples of sizes greaterSize and lessSize,
+// for which the statistic U (the number of the pairs, in which the value of
+// the first sample is greater) is equal to u: counts[u] / C(n1 + n2, n1).
+// The last value of the order either is from the first sample (it is greater
+// than all lessSize values of the second one) or from the second one.
+static RealVector countMannWhitney(const UnsignedType& greaterSize,
+	const UnsignedType& lessSize)
+{
+	const UnsignedType statisticMax = greaterSize * lessSize;
+	// counts[i][j][u] for the first i and j values
+	std::vector<std::vector<RealVector>> counts(greaterSize + 1,
+		std::vector<RealVector>(lessSize + 1, RealVector(statisticMax + 1, 0.0)));
+
+	for (UnsignedType i = 0; i <= greaterSize; ++i)
+	{
+		for (UnsignedType j = 0; j <= lessSize; ++j)
+		{
+			if (i == 0 || j == 0)
+			{
+				counts[i][j][0] = 1.0;
+				continue;
+			}
+
+			for (UnsignedType u = 0; u <= i * j; ++u)
+			{
+				Real count = counts[i][j - 1][u];
+				if (u >= j)
+					count += counts[i - 1][j][u - j];
+				counts[i][j][u] = count;
+			}
+		}
+	}
+
+	return counts[greaterSize][lessSize];
+}
+
+Real MFE::testMannWhitney(const RealVector& greater, const RealVector& less)
+{
+	const UnsignedType greaterSize = greater.size();
+	const UnsignedType lessSize = less.size();
+	if (greaterSize == 0 || lessSize == 0)
+		return 1.0;
+
+	// The statistic is doubled, so the ties (1/2) are integer
+	UnsignedType statisticDouble = 0;
+	for (const auto& valueGreater : greater)
+	{
+		for (const auto& valueLess : less)
+		{
+			if (valueGreater > valueLess)
+				statisticDouble += 2;
+			else if (valueGreater == valueLess)
+				statisticDouble += 1;
+		}
+	}
+
+	if (greaterSize <= MANN_WHITNEY_EXACT_MAX && lessSize <= MANN_WHITNEY_EXACT_MAX)
+	{
+		const RealVector counts = countMannWhitney(greaterSize, lessSize);
+		Real countTotal = 0.0;
+		Real countTail = 0.0;
+		const UnsignedType statisticMin = (statisticDouble + 1) / 2;
+		for (UnsignedType u = 0; u < counts.size(); ++u)
+		{
+			countTotal += counts[u];
+			if (u >= statisticMin)
+				countTail += counts[u];
+		}
+
+		return countTail / countTotal;
+	}
+
+	// The normal approximation with the continuity correction
+	const Real sizeProduct = static_cast<Real>(greaterSize * lessSize);
+	const Real mean = 0.5 * sizeProduct;
+	const Real deviation =
+		std::sqrt(sizeProduct * (greaterSize + lessSize + 1) / 12.0);
+	const Real z = (0.5 * statisticDouble - mean - 0.5) / deviation;
+
+	return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+// The relative change, the change from 0 is infinite
+static Real getRelativeChange(const Real& baseline, const Real& current)
+{
+	if (baseline == 0.0)
+		return current == 0.0 ? 0.0 : HUGE_VAL;
+
+	return current / baseline - 1.0;
+}
+
+static PerfComparison compareResult(const BenchResult& baseline,
+	const BenchResult& current, const PerfThresholds& thresholds)
+{
+	PerfComparison comparison;
+	comparison.name = current.name;
+	comparison.itemsPerIteration = current.itemsPerIteration;
+	comparison.baselineTime = baseline.medianTime;
+	comparison.currentTime = current.medianTime;
+	comparison.timeChange = getRelativeChange(baseline.medianTime,
+		current.medianTime);
+	comparison.baselineMemory = baseline.peakMemory;
+	comparison.currentMemory = current.peakMemory;
+	comparison.memoryChange = getRelativeChange(
+		static_cast<Real>(baseline.peakMemory), static_cast<Real>(current.peakMemory));
+	comparison.baselineAllocations = baseline.allocations;
+	comparison.currentAllocations = current.allocations;
+
+	if (comparison.timeChange >= 0.0)
+	{
+		comparison.pValue = testMannWhitney(current.samples, baseline.samples);
+		if (comparison.timeChange > thresholds.timeThreshold &&
+			comparison.pValue < thresholds.alpha)
+			comparison.status = PERF_SLOWER;
+	}
+	else
+	{
+		comparison.pValue = testMannWhitney(baseline.samples, current.samples);
+		if (-comparison.timeChange > thresholds.timeThreshold &&
+			comparison.pValue < thresholds.alpha)
+			comparison.status = PERF_FASTER;
+	}
+
+	const Real memoryFactor = 1.0 + thresholds.memoryThreshold;
+	comparison.isMoreMemory =
+		current.peakMemory > memoryFactor * baseline.peakMemory ||
+		current.allocations > memoryFactor * baseline.allocations;
+
+	return comparison;
+}
+
+std::vector<PerfComparison> MFE::comparePerf(const BenchBaseline& baseline,
+	const std::vector<BenchResult>& current, const PerfThresholds& thresholds,
+	const bool& isComplete)
+{
+	std::map<std::string, const BenchResult*> baselineResults;
+	for (const auto& result : baseline.results)
+		baselineResults[result.name] = &result;
+
+	std::vector<PerfComparison> comparisons;
+	for (const auto& result : current)
+	{
+		const auto found = baselineResults.find(result.name);
+		if (found == baselineResults.end())
+		{
+			PerfComparison comparison;
+			comparison.name = result.name;
+			comparison.status = PERF_NEW;
+			comparison.currentTime = result.medianTime;
+			comparison.currentMemory = result.peakMemory;
+			comparison.currentAllocations = result.allocations;
+			comparisons.push_back(comparison);
+			continue;
+		}
+
+		comparisons.push_back(compareResult(*found->second, result, thresholds));
+		baselineResults.erase(found);
+	}
+
+	if (isComplete)
+	{
+		for (const auto& result : baseline.results)
+		{
+			if (baselineResults.count(result.name) == 0)
+				continue;
+
+			PerfComparison comparison;
+			comparison.name = result.name;
+			comparison.status = PERF_MISSING;
+			comparison.baselineTime = result.medianTime;
+			comparison.baselineMemory = result.peakMemory;
+			comparison.baselineAllocations = result.allocations;
+			comparisons.push_back(comparison);
+		}
+	}
+
+	return comparisons;
+}
+
+std::string MFE::getPerfStatusName(const PerfStatus& status)
+{
+	switch (status)
+	{
+	case PERF_SAME:
+		return "ok";
+	case PERF_FASTER:
+		return "faster";
+	case PERF_SLOWER:
+		return "SLOWER";
+	case PERF_NEW:
+		return "new";
+	case PERF_MISSING:
+		return "missing";
+	}
+
+	return "";
+}
+
+bool MFE::isPerfRegression(const PerfComparison& comparison)
+{
+	return comparison.status == PERF_SLOWER || comparison.isMoreMemory;
+}
+
+// The change in percent
+static std::string formatChange(const Real& change)
+{
+	if (std::isinf(change))
+		return "+inf%";
+
+	std::ostringstream output;
+	output << std::showpos << std::fixed << std::setprecision(1)
+		<< 100.0 * change << "%";
+	return output.str();
+}
+
+void MFE::writePerfReport(std::ostream& output,
+	const std::vector<PerfComparison>& comparisons,
+	const PerfThresholds& thresholds)
+{
+	output << "\nComparison with the baseline (time: "
+		<< formatChange(thresholds.timeThreshold) << " and p < " << thresholds.alpha
+		<< "; memory: " << formatChange(thresholds.memoryThreshold) << ")\n\n"
+		<< std::left << std::setw(40) << "benchmark"
+		<< std::right << std::setw(16) << "baseline, ns"
+		<< std::setw(16) << "current, ns"
+		<< std::setw(10) << "change"
+		<< std::setw(10) << "p"
+		<< std::setw(10) << "memory"
+		<< std::setw(10) << "status" << "\n";
+
+	UnsignedType regressionsCount = 0;
+	for (const auto& comparison : comparisons)
+	{
+		const bool isCompared = comparison.status != PERF_NEW &&
+			comparison.status != PERF_MISSING;
+
+		output << std::left << std::setw(40) << comparison.name << std::right
+			<< std::fixed << std::setprecision(1)
+			<< std::setw(16) << comparison.baselineTime
+			<< std::setw(16) << comparison.currentTime
+			<< std::setw(10) << (isCompared ? formatChange(comparison.timeChange) : "")
+			<< std::setprecision(3)
+			<< std::setw(10) << comparison.pValue
+			<< std::setw(10) << (isCompared ? formatChange(comparison.memoryChange) : "")
+			<< std::setw(10) << (comparison.isMoreMemory ? "MEMORY" :
+				getPerfStatusName(comparison.status))
+			<< std::defaultfloat << "\n";
+
+		if (isPerfRegression(comparison))
+			++regressionsCount;
+	}
+
+	output << "\n";
+	if (regressionsCount == 0)
+	{
+		output << "No regressions.\n";
+		return;
+	}
+
+	output << "Regressions: " << regressionsCount << "\n";
+	for (const auto& comparison : comparisons)
+	{
+		if (comparison.status == PERF_SLOWER)
+		{
+			output << "  " << comparison.name << ": the time is "
+				<< formatChange(comparison.timeChange) << " (p = "
+				<< comparison.pValue << ")";
+			if (comparison.itemsPerIteration != 0)
+			{
+				output << ", the throughput is "
+					<< comparison.itemsPerIteration * 1e9 / comparison.baselineTime
+					<< " -> "
+					<< comparison.itemsPerIteration * 1e9 / comparison.currentTime
+					<< " steps/s";
+			}
+			output << "\n";
+		}
+
+		if (comparison.isMoreMemory)
+		{
+			output << "  " << comparison.name << ": the peak of the memory is "
+				<< comparison.baselineMemory << " -> " << comparison.currentMemory
+				<< " bytes, the allocations " << comparison.baselineAllocations
+				<< " -> " << comparison.currentAllocations << "\n";
+		}
+	}
+}
@@ -0,0 +1,98 @@
+// This file is used in the application perf_check.
+// This file contains the comparison of the results of the benchmarks with
+// the baseline (the JSON file of MFE_lib_bench or of perf_check). The time
+// is compared by the samples: the benchmark is slower if the median is
+// greater than the median of the baseline by more than timeThreshold and
+// the one-sided Mann-Whitney test confirms it (p-value < alpha), so the
+// noise of one sample does not give a regression. The memory (the peak of
+// the bytes and the number of the allocations) does not depend on the load
+// of the machine and is compared by memoryThreshold.
+
+#ifndef PERF_COMPARE_H
+#define PERF_COMPARE_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+
+namespace MFE
+{
+	// The results of a JSON file and the build of their run
+	struct BenchBaseline
+	{
+		bool isDebug = false;
+		bool isProfiling = false;
+		std::vector<BenchResult> results;
+	};
+
+	// timeThreshold, memoryThreshold - the relative changes, which are
+	// allowed; alpha - the significance level of the test
+	struct PerfThresholds
+	{
+		Real timeThreshold = 0.10;
+		Real memoryThreshold = 0.05;
+		Real alpha = 0.05;
+	};
+
+	// The status of the time of a benchmark
+	enum PerfStatus
+	{
+		PERF_SAME,
+		PERF_FASTER,
+		PERF_SLOWER,
+		PERF_NEW,
+		PERF_MISSING,
+	};
+
+	// The comparison of a benchmark: timeChange, memoryChange - the
+	// relative changes of the median and of the peak of the memory;
+	// pValue - the p-value of the test in the direction of the change;
+	// isMoreMemory - the peak of the memory or the number of the
+	// allocations is greater than allowed
+	struct PerfComparison
+	{
+		std::string name;
+		PerfStatus status = PERF_SAME;
+		bool isMoreMemory = false;
+		Real baselineTime = 0.0;
+		Real currentTime = 0.0;
+		Real timeChange = 0.0;
+		Real pValue = 1.0;
+		UnsignedType baselineMemory = 0;
+		UnsignedType currentMemory = 0;
+		Real memoryChange = 0.0;
+		UnsignedType baselineAllocations = 0;
+		UnsignedType currentAllocations = 0;
+		UnsignedType itemsPerIteration = 0;
+	};
+
+	// Reading the JSON file of the results, an exception is thrown if the
+	// file is not opened or is written incorrectly
+	BenchBaseline readBenchJson(const std::string& fileName);
+
+	// The p-value of the one-sided Mann-Whitney test of the hypothesis that
+	// the values of "greater" are greater than the values of "less". The
+	// exact distribution is used for the small samples, the normal one for
+	// the large samples.
+	Real testMannWhitney(const RealVector& greater, const RealVector& less);
+
+	// Comparing the current results with the baseline. The benchmarks of
+	// the baseline which are not run are PERF_MISSING only if isComplete.
+	std::vector<PerfComparison> comparePerf(const BenchBaseline& baseline,
+		const std::vector<BenchResult>& current,
+		const PerfThresholds& thresholds, const bool& isComplete);
+
+	std::string getPerfStatusName(const PerfStatus& status);
+
+	// true if the benchmark is slower or takes more memory
+	bool isPerfRegression(const PerfComparison& comparison);
+
+	// The report of the comparison, the regressions are listed at the end
+	void writePerfReport(std::ostream& output,
+		const std::vector<PerfComparison>& comparisons,
+		const PerfThresholds& thresholds);
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include "perf_counters.h"
+
+#ifdef __linux__
+	#include <cerrno>
+	#include <cstdint>
+	#include <cstring>
+
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+using namespace MFE;
+
+#ifdef __linux__
+
+namespace
+{
+	constexpr std::array<std::uint64_t, COUNTERS_COUNT> COUNTER_EVENTS = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES,
+	};
+}
+
+// The counter of the event of the calling thread, only the user code is
+// counted (it is allowed with perf_event_paranoid = 2)
+static int openCounter(const std::uint64_t& event, const int& leader)
+{
+	perf_event_attr attributes;
+	std::memset(&attributes, 0, sizeof(attributes));
+	attributes.size = sizeof(attributes);
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.config = event;
+	attributes.disabled = leader == -1 ? 1 : 0;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+	attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+		PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1,
+		leader, 0));
+}
+
+PerfCounters::PerfCounters()
+{
+	m_files.fill(-1);
+	for (UnsignedType type = 0; type < COUNTERS_COUNT; ++type)
+	{
+		const int file = openCounter(COUNTER_EVENTS[type], m_leader);
+		if (file == -1)
+		{
+			if (m_error.empty())
+			{
+				m_error = "perf_event_open (" +
+					getPerfCounterName(static_cast<PerfCounterType>(type)) + "): " +
+					std::strerror(errno);
+			}
+			continue;
+		}
+
+		m_files[type] = file;
+		if (m_leader == -1)
+			m_leader = file;
+	}
+
+	if (m_leader != -1)
+		m_error.clear();
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (const auto& file : m_files)
+	{
+		if (file != -1)
+			close(file);
+	}
+}
+
+void PerfCounters::start()
+{
+	if (m_leader == -1)
+		return;
+
+	ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+CounterValues PerfCounters::stop()
+{
+	CounterValues counters;
+	if (m_leader == -1)
+		return counters;
+
+	ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+	// The group: the number of the values, the times, the pairs of the
+	// value and the identifier
+	std::array<std::uint64_t, 3 + 2 * COUNTERS_COUNT> buffer{};
+	const ssize_t size = read(m_leader, buffer.data(), sizeof(buffer));
+	if (size < static_cast<ssize_t>(3 * sizeof(std::uint64_t)))
+		return counters;
+
+	const std::uint64_t valuesCount = buffer[0];
+	const std::uint64_t timeEnabled = buffer[1];
+	const std::uint64_t timeRunning = buffer[2];
+	const Real scale = timeRunning == 0 ? 0.0 :
+		static_cast<Real>(timeEnabled) / static_cast<Real>(timeRunning);
+
+	// The values are in the order of the opening of the counters
+	UnsignedType valueNum = 0;
+	for (UnsignedType type = 0; type < COUNTERS_COUNT && valueNum < valuesCount;
+		++type)
+	{
+		if (m_files[type] == -1)
+			continue;
+
+		counters.values[type] = scale * static_cast<Real>(buffer[3 + 2 * valueNum]);
+		counters.isAvailable[type] = true;
+		++valueNum;
+	}
+
+	return counters;
+}
+
+#else
+
+PerfCounters::PerfCounters() :
+	m_error("the hardware counters are supported only on Linux")
+{
+	m_files.fill(-1);
+}
+
+PerfCounters::~PerfCounters()
+{
+}
+
+void PerfCounters::start()
+{
+}
+
+CounterValues PerfCounters::stop()
+{
+	return CounterValues();
+}
+
+#endif
+
+bool PerfCounters::isAvailable() const
+{
+	return m_leader != -1;
+}
+
+const std::string& PerfCounters::getError() const
+{
+	return m_error;
+}
+
+std::string MFE::getPerfCounterName(const PerfCounterType& type)
+{
+	switch (type)
+	{
+	case COUNTER_CYCLES:
+		return "cycles";
+	case COUNTER_INSTRUCTIONS:
+		return "instructions";
+	case COUNTER_CACHE_MISSES:
+		return "cacheMisses";
+	case COUNTER_BRANCH_MISSES:
+		return "branchMisses";
+	default:
+		return "";
+	}
+}
@@ -0,0 +1,75 @@
+// This file is used in the benchmark applications of MFE_lib.
+// This file contains the hardware counters of the benchmarks: the cycles,
+// the instructions, the cache misses and the branch mispredictions of the
+// process are read by perf_event_open (Linux) as one group, so the values
+// are counted over the same time. If the counters are not available (other
+// systems, virtual machines, /proc/sys/kernel/perf_event_paranoid), the
+// benchmarks are measured only by the time, the reason is kept. A counter
+// which is not supported by the processor is skipped, the others are read.
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <string>
+
+#include <MFE_lib/types/types.h>
+
+namespace MFE
+{
+	enum PerfCounterType
+	{
+		COUNTER_CYCLES,
+		COUNTER_INSTRUCTIONS,
+		COUNTER_CACHE_MISSES,
+		COUNTER_BRANCH_MISSES,
+		COUNTERS_COUNT,
+	};
+
+	// The size of the cache line, the bytes of a cache miss
+	constexpr UnsignedType CACHE_LINE_SIZE = 64;
+
+	// The values of the counters (the counters that are not available are 0)
+	struct CounterValues
+	{
+		std::array<Real, COUNTERS_COUNT> values{};
+		std::array<bool, COUNTERS_COUNT> isAvailable{};
+	};
+
+	class PerfCounters
+	{
+	public:
+
+		// Opening the counters of the calling thread
+		PerfCounters();
+
+		~PerfCounters();
+
+		PerfCounters(const PerfCounters&) = delete;
+		PerfCounters& operator=(const PerfCounters&) = delete;
+
+		// true if at least one counter is opened
+		bool isAvailable() const;
+
+		// The reason, why the counters are not available
+		const std::string& getError() const;
+
+		void start();
+
+		// The values since start. If the counters were shared with other
+		// events of the system, the values are scaled by the time of
+		// counting.
+		CounterValues stop();
+
+	private:
+
+		std::array<int, COUNTERS_COUNT> m_files;
+		int m_leader = -1;
+		std::string m_error;
+
+	};
+
+	std::string getPerfCounterName(const PerfCounterType& type);
+}
+
+#endif
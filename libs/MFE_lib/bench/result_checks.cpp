@@ -0,0 +1,231 @@
+#include "result_checks.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <MFE_lib/functions_for_MFE/history_codec.h>
+#include <MFE_lib/functions_for_MFE/simulation_config.h>
+
+using namespace MFE;
+
+// The scenario with the value "value" of the key "key" must be rejected
+static bool checkScenarioRejected(const std::string& key,
+	const std::string& value)
+{
+	std::istringstream input("[check]\n"
+		"frictionMode = 3\n"
+		"time = 0.01\n"
+		"deltaT = 1e-6\n"
+		"integrationScheme = generalized_alpha\n" +
+		key + " = " + value + "\n");
+	try
+	{
+		readScenarios(input);
+	}
+	catch (const std::exception&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+// NaN and infinity do not fail the comparisons of the ranges
+static bool checkScenarioNotFinite(std::ostream& output)
+{
+	const std::array<const char*, 5> keys = { "time", "deltaT",
+		"spectralRadius", "coeffViscousFriction", "modulusElastic" };
+	bool isCorrect = true;
+	for (const auto& key : keys)
+	{
+		for (const auto& value : { "nan", "inf" })
+		{
+			if (!checkScenarioRejected(key, value))
+			{
+				output << "The scenario with " << key << " = " << value
+					<< " is accepted.\n";
+				isCorrect = false;
+			}
+		}
+	}
+
+	return isCorrect;
+}
+
+namespace
+{
+	// The damped oscillation (24 values) compressed by CODEC_QUADRATIC and
+	// CODEC_CUBIC: the bits of the values and the words of the series.
+	// The series are written by a build without FMA, the builds with FMA
+	// must decode them to the same bits.
+	constexpr std::array<std::uint64_t, 24> CODEC_CHECK_VALUES = {
+		0x3f1a2bb509c671d7, 0x3f3846b85a593da3, 0x3f4319d290bea72e,
+		0x3f47bb8a33476571, 0x3f49d9ba823207e8, 0x3f498244d062d6db,
+		0x3f46f8b8179d8817, 0x3f42ab4e947050d3, 0x3f3a4a7ae7754570,
+		0x3f2bff27c675a36f, 0x3efa71ed88ea68a8, 0xbf235313c5112fbd,
+		0xbf330e7b9e4c02f6, 0xbf39e46f805cc981, 0xbf3dd0dededdae9f,
+		0xbf3ec2ff35fc92dd, 0xbf3cee355301b2af, 0xbf38bf1b0085aed0,
+		0xbf32cc90e8e87066, 0xbf278d15a70e75ee, 0xbf1191390269ac60,
+		0x3f056210c66a5ca6, 0x3f21a9e3e922c60a, 0x3f2b4432b6c39584,
+	};
+
+	struct CodecCheckSeries
+	{
+		CodecPredictor predictor = CODEC_CUBIC;
+		UnsignedType bitsCount = 0;
+		std::vector<std::uint64_t> words;
+	};
+
+	const std::array<CodecCheckSeries, 2> CODEC_CHECK_SERIES = {
+		CodecCheckSeries{ CODEC_QUADRATIC, 1316, {
+			0x3f1a2bb509c671d7, 0xf5f0d81a84965e62, 0x0f3b79430e41cfbf,
+			0x6a7cc53c0efe5d91, 0x2529a36786f0a972, 0x2424a871df3876b9,
+			0xcb71d1e471a9bbc6, 0x2cd4b37dc6a4f299, 0x453c20eb14debcf7,
+			0xe67c98c9a8422ab4, 0xac0d486ef871f557, 0xdf7346ea346da5ed,
+			0x13acb50d53ba79c1, 0x8432a0f487dc319b, 0x266a41e3926c99ca,
+			0x98a0bd52dc154bfd, 0x24af1aff3c75d438, 0x63ce14797fac9c28,
+			0x2ade2b710b3a1389, 0x634441e8609e1ce9, 0xfdd4041db0000000 } },
+		CodecCheckSeries{ CODEC_CUBIC, 1238, {
+			0x3f1a2bb509c671d7, 0xf5f0d81a84965e62, 0x0f3b79430e41cfbf,
+			0x6a7cc53c0efe7d0e, 0x0c25605a9e54f2bc, 0x8cfea6b5b4dbedb0,
+			0xa9555a1653fb4273, 0xebc144f1c09c201e, 0x82f2d5a2a777c8ec,
+			0x3ef9bdc6656bbd8a, 0x62df4c8f7b58a051, 0xeab00aa9a9180610,
+			0x328b6a4de13058eb, 0x7a885ea234b7ca9c, 0x9a7ea83224a548db,
+			0xf8e90d299131cfd5, 0xa6023a8dc6d8c878, 0xa58b249ea3d325eb,
+			0x9cbc8b65ca28c4cc, 0xe759300000000000 } },
+	};
+
+	const std::string CODEC_CHECK_FILE = "result_check.mfez";
+}
+
+static std::uint64_t getBits(const Real& value)
+{
+	std::uint64_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	return bits;
+}
+
+static Real getReal(const std::uint64_t& bits)
+{
+	Real value = 0.0;
+	std::memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+// The fixed series are decoded and encoded bit for bit (the predictions
+// must not depend on the build)
+static bool checkCodecFixedSeries(std::ostream& output)
+{
+	RealVector expected;
+	for (const auto& bits : CODEC_CHECK_VALUES)
+		expected.push_back(getReal(bits));
+
+	bool isCorrect = true;
+	for (const auto& checkSeries : CODEC_CHECK_SERIES)
+	{
+		CompressedSeries series;
+		series.predictor = checkSeries.predictor;
+		series.count = expected.size();
+		series.bitsCount = checkSeries.bitsCount;
+		series.words = checkSeries.words;
+
+		UnsignedType differentCount = 0;
+		const RealVector values = decompressSeries(series);
+		for (UnsignedType valueNum = 0; valueNum < expected.size(); ++valueNum)
+		{
+			if (valueNum >= values.size() ||
+				getBits(values[valueNum]) != getBits(expected[valueNum]))
+				++differentCount;
+		}
+
+		if (values.size() != expected.size() || differentCount != 0)
+		{
+			output << "The fixed compressed series (predictor " <<
+				series.predictor << ") is decoded with " << differentCount <<
+				" different values.\n";
+			isCorrect = false;
+		}
+
+		const CompressedSeries encoded = compressSeries(expected,
+			series.predictor);
+		if (encoded.bitsCount != series.bitsCount ||
+			encoded.words != series.words)
+		{
+			output << "The fixed series (predictor " << series.predictor <<
+				") is encoded with different bits.\n";
+			isCorrect = false;
+		}
+	}
+
+	return isCorrect;
+}
+
+// The file with the number of words of the series that does not fit the
+// file must be rejected before the memory for the words is allocated
+static bool checkCodecDamagedFile(std::ostream& output)
+{
+	CompressedHistory history;
+	history.deltaT = 1e-6;
+	history.indices = { 1 };
+	history.steps = compressSeries({ 0.0, 1.0, 2.0 }, CODEC_LINEAR);
+	history.channels = { compressSeries({ 0.0, 0.5, 1.0 }, CODEC_CUBIC) };
+	if (!writeCompressedHistory(history, CODEC_CHECK_FILE))
+	{
+		output << "The compressed history is not written.\n";
+		return false;
+	}
+
+	// The number of bits and the number of words of the series of the steps
+	// are the last words of its header (after the magic, the version,
+	// deltaT, the number of the channels and the index): they agree with
+	// each other, but not with the size of the file
+	const std::streamoff bitsCountOffset = 8 + 8 + 8 + 8 + 8 + 2 * 8;
+	const std::uint64_t sizes[2] = { std::uint64_t(1) << 58,
+		std::uint64_t(1) << 52 };
+	{
+		std::fstream file(CODEC_CHECK_FILE,
+			std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(bitsCountOffset);
+		file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+	}
+
+	bool isCorrect = false;
+	try
+	{
+		readCompressedHistory(CODEC_CHECK_FILE);
+	}
+	catch (const std::runtime_error&)
+	{
+		isCorrect = true;
+	}
+	catch (const std::exception&)
+	{
+		// std::bad_alloc: the words are allocated by the damaged header
+	}
+	std::remove(CODEC_CHECK_FILE.c_str());
+
+	if (!isCorrect)
+		output << "The damaged compressed history is not rejected.\n";
+
+	return isCorrect;
+}
+
+bool MFE::runResultChecks(std::ostream& output)
+{
+	bool isCorrect = true;
+	isCorrect = checkScenarioNotFinite(output) && isCorrect;
+	isCorrect = checkCodecFixedSeries(output) && isCorrect;
+	isCorrect = checkCodecDamagedFile(output) && isCorrect;
+
+	return isCorrect;
+}
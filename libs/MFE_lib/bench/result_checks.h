@@ -0,0 +1,21 @@
+// This file is used in the application perf_check.
+// This file contains the checks of the results that the optimizations must
+// not change. They are run by perf_check before the benchmarks, a failed
+// check is an error of the program as a regression of the time:
+// the values that are not finite numbers are rejected by readScenarios;
+// the fixed compressed series is decoded bit for bit (history_codec.h), and
+// the damaged compressed history is rejected.
+
+#ifndef RESULT_CHECKS_H
+#define RESULT_CHECKS_H
+
+#include <ostream>
+
+namespace MFE
+{
+	// Running the checks, false if one of them failed (the failed checks are
+	// written to the output)
+	bool runResultChecks(std::ostream& output);
+}
+
+#endif
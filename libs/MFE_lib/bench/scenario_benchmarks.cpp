@@ -0,0 +1,61 @@
+#include "scenario_benchmarks.h"
+
+#include "kernel_benchmarks.h"
+
+using namespace MFE;
+
+// The time of the steps, half of the step is added, so the number of steps
+// is not reduced by the rounding of time / deltaT
+static Real getScenarioTime(const Real& deltaT)
+{
+	return (static_cast<Real>(SCENARIO_STEPS) + 0.5) * deltaT;
+}
+
+std::vector<SimulationConfig> MFE::makeBenchScenarios()
+{
+	std::vector<SimulationConfig> configs;
+
+	// The example of the console front end
+	SimulationConfig configFree = makeDefaultConfig(FRICTION_DRY_FREE);
+	configFree.name = "scenario_dry_free";
+	configFree.deltaT = 1e-7;
+	configFree.initialStaticLoad = 10000.0;
+	configFree.coeffDryFrictionRest = 0.5;
+	configFree.coeffDryFrictionSliding = 0.3;
+	configs.push_back(configFree);
+
+	// The examples of the scenario file
+	SimulationConfig configForced = makeDefaultConfig(FRICTION_DRY_DRIVE);
+	configForced.name = "scenario_dry_drive";
+	configForced.deltaT = 1e-7;
+	configForced.coeffDryFrictionRest = 0.5;
+	configForced.coeffDryFrictionSliding = 0.3;
+	configForced.integrationScheme = INTEGRATION_GENERALIZED_ALPHA;
+	configForced.spectralRadius = 0.6;
+	configs.push_back(configForced);
+
+	SimulationConfig configViscous = makeDefaultConfig(FRICTION_VISCOUS_DRIVE);
+	configViscous.name = "scenario_viscous";
+	configViscous.deltaT = 1e-6;
+	configViscous.coeffViscousFriction = 1.5;
+	configViscous.initialSpeed = 1.0;
+	configs.push_back(configViscous);
+
+	for (auto& config : configs)
+		config.time = getScenarioTime(config.deltaT);
+
+	return configs;
+}
+
+void MFE::addScenarioBenchmarks(BenchSuite& suite)
+{
+	for (const auto& config : makeBenchScenarios())
+	{
+		suite.add(config.name, SCENARIO_STEPS, [config](const UnsignedType& iterations)
+			{
+				BenchSink sink;
+				for (UnsignedType iteration = 0; iteration < iterations; ++iteration)
+					runSimulation(config, sink);
+			}, SCENARIO_STEPS);
+	}
+}
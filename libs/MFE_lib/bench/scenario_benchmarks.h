@@ -0,0 +1,28 @@
+// This file is used in the benchmark applications of MFE_lib.
+// This file contains the end-to-end benchmarks: the three examples of
+// README (dry friction without a driving force, dry friction with a driving
+// force, viscous friction) are calculated by runSimulation with the shorter
+// time, so the assembly of the matrices, the conditions and the time loop
+// are measured together. The size of a benchmark is the number of steps.
+
+#ifndef SCENARIO_BENCHMARKS_H
+#define SCENARIO_BENCHMARKS_H
+
+#include <vector>
+
+#include <MFE_lib/functions_for_MFE/simulation_config.h>
+
+#include "bench_harness.h"
+
+namespace MFE
+{
+	// The number of steps of the scenarios
+	constexpr UnsignedType SCENARIO_STEPS = 2000;
+
+	// The configurations of the examples with SCENARIO_STEPS steps
+	std::vector<SimulationConfig> makeBenchScenarios();
+
+	void addScenarioBenchmarks(BenchSuite& suite);
+}
+
+#endif
@@ -0,0 +1,94 @@
+// This file is used in the dinamic_solver files and in the applications.
+// This file contains the asynchronous sink: the steps of the solver are
+// collected into blocks, and the filled blocks are passed to the target sink
+// (formatting, writing to the file) on a separate thread. Thus the
+// calculation and the output overlap. The number of blocks is fixed
+// (2 - double buffering): if the writer thread does not have time, the
+// solver waits for a free block, so the memory is bounded by the blocks.
+
+#ifndef ASYNC_SINK_H
+#define ASYNC_SINK_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <MFE_lib/functions_for_MFE/result_sink.h>
+
+namespace MFE
+{
+	// The number of steps of a block and the number of blocks by default
+	constexpr UnsignedType ASYNC_BLOCK_STEPS = 4096;
+	constexpr UnsignedType ASYNC_BLOCKS_COUNT = 2;
+
+	// The sink that passes the steps to the target sink on a separate
+	// thread. begin and end of the target are called on the thread of the
+	// solver; the exception of the target on the writer thread is thrown
+	// again on the thread of the solver (in record or end).
+	class MFE_LIB_EXPORT AsyncSink : public ResultSink
+	{
+	public:
+
+		explicit AsyncSink(ResultSink& target,
+			const UnsignedType& blockSteps = ASYNC_BLOCK_STEPS,
+			const UnsignedType& blocksCount = ASYNC_BLOCKS_COUNT);
+
+		~AsyncSink() override;
+
+		AsyncSink(const AsyncSink&) = delete;
+		AsyncSink& operator=(const AsyncSink&) = delete;
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+	private:
+
+		// The steps of a block: the displacements of the steps one after
+		// another
+		struct Block
+		{
+			std::vector<UnsignedType> steps;
+			std::vector<char> isStuck;
+			RealVector displacements;
+			UnsignedType count = 0;
+		};
+
+		// Passing the current block to the writer thread and waiting for
+		// a free block
+		void submit();
+
+		// The writer thread
+		void write();
+
+		void stop();
+
+		void rethrowError();
+
+		ResultSink& m_target;
+		UnsignedType m_blockSteps = ASYNC_BLOCK_STEPS;
+		UnsignedType m_dofCount = 0;
+
+		std::vector<Block> m_blocks;
+		UnsignedType m_current = 0;
+
+		std::mutex m_mutex;
+		std::condition_variable m_filledCondition;
+		std::condition_variable m_freeCondition;
+		std::deque<UnsignedType> m_filled;
+		std::deque<UnsignedType> m_free;
+		bool m_isFinished = false;
+		std::exception_ptr m_error;
+
+		std::thread m_thread;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,196 @@
+// This file is used in the dinamic_solver files and in the post-processing.
+// This file contains the binary columnar format of the results of the
+// dynamic problem and its reader. The values are not formatted as text:
+// the channels (the displacements of the degrees of freedom) are written as
+// columns of float64, so the writing and the reading are limited only by
+// the disk, and the reader maps the file into memory and gives the columns
+// without copying.
+//
+// File layout (the byte order of the machine, checked by the reader):
+// BinaryHeader (64 bytes);
+// the indices of the degrees of freedom of the channels (uint64);
+// the configuration of the simulation in the format of the scenario file
+// (configSize bytes, can be empty);
+// the data from dataOffset (a multiple of BINARY_DATA_ALIGNMENT):
+// the column of the step numbers (uint64), then the column of each
+// channel (float64). Each column has "capacity" values, the first
+// "stepsCount" of them are written.
+
+#ifndef BINARY_RESULTS_H
+#define BINARY_RESULTS_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <MFE_lib/functions_for_MFE/result_sink.h>
+#include <MFE_lib/functions_for_MFE/simulation_config.h>
+
+namespace MFE
+{
+	constexpr char BINARY_MAGIC[8] = { 'M', 'F', 'E', 'R', 'E', 'S', '0', '1' };
+	constexpr std::uint32_t BINARY_VERSION = 1;
+	constexpr std::uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+	// The alignment of the data (the page size), so the columns of the mapped
+	// file are aligned
+	constexpr std::uint64_t BINARY_DATA_ALIGNMENT = 4096;
+
+	// The number of steps buffered by the sink before writing to the columns
+	constexpr UnsignedType BINARY_CHUNK_STEPS = 65536;
+
+	// The extension of the binary results (the batch runner writes the
+	// binary format if the output file has it)
+	const std::string BINARY_RESULTS_EXTENSION = ".mfer";
+
+	struct MFE_LIB_EXPORT BinaryHeader
+	{
+		char magic[8] = {};
+		std::uint32_t version = BINARY_VERSION;
+		std::uint32_t byteOrder = BINARY_BYTE_ORDER;
+		double deltaT = 0.0;
+		std::uint64_t capacity = 0;
+		std::uint64_t stepsCount = 0;
+		std::uint64_t channelsCount = 0;
+		std::uint64_t configSize = 0;
+		std::uint64_t dataOffset = 0;
+	};
+
+	// The view of the column of the mapped file (the values are not copied,
+	// the view is valid while the reader exists)
+	template<typename T>
+	class ColumnView
+	{
+	public:
+
+		ColumnView() = default;
+
+		ColumnView(const T* data, const UnsignedType& size) :
+			m_data(data), m_size(size) {}
+
+		const T* data() const { return m_data; }
+		UnsignedType size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+
+		const T* begin() const { return m_data; }
+		const T* end() const { return m_data + m_size; }
+
+		const T& operator[](const UnsignedType& index) const
+		{
+			return m_data[index];
+		}
+
+	private:
+
+		const T* m_data = nullptr;
+		UnsignedType m_size = 0;
+
+	};
+
+	// The displacements of one degree of freedom for all steps
+	using ChannelView = ColumnView<Real>;
+
+	// The step numbers of the recorded steps
+	using StepsView = ColumnView<std::uint64_t>;
+
+	// The sink that writes the degrees of freedom "indices" to the binary
+	// file. The steps are buffered by BINARY_CHUNK_STEPS and written to the
+	// columns by large blocks. The number of steps is limited by the
+	// expected number of steps of the header.
+	class MFE_LIB_EXPORT BinaryFileSink : public ResultSink
+	{
+	public:
+
+		explicit BinaryFileSink(const std::string& fileName,
+			const std::vector<UnsignedType>& indices =
+			std::vector<UnsignedType>(ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()));
+
+		// The configuration is written to the file
+		BinaryFileSink(const std::string& fileName, const SimulationConfig& config,
+			const std::vector<UnsignedType>& indices =
+			std::vector<UnsignedType>(ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()));
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+		// false if the file was not opened or not all steps were written
+		bool isWritten() const;
+
+	private:
+
+		void flush();
+
+		std::string m_fileName;
+		std::vector<UnsignedType> m_indices;
+		std::string m_config;
+
+		std::ofstream m_fout;
+		bool m_isWritten = false;
+		BinaryHeader m_header;
+
+		// The buffered steps and the number of written steps
+		std::vector<std::uint64_t> m_steps;
+		RealMatrix m_channels;
+		UnsignedType m_writtenCount = 0;
+
+	};
+
+	// The reader of the binary file: the file is mapped into memory, the
+	// columns are given as views. An exception is thrown if the file is not
+	// the binary results or is damaged.
+	class MFE_LIB_EXPORT BinaryResultsReader
+	{
+	public:
+
+		explicit BinaryResultsReader(const std::string& fileName);
+
+		~BinaryResultsReader();
+
+		BinaryResultsReader(const BinaryResultsReader&) = delete;
+		BinaryResultsReader& operator=(const BinaryResultsReader&) = delete;
+
+		Real getDeltaT() const;
+
+		UnsignedType getStepsCount() const;
+
+		// The indices of the degrees of freedom of the channels
+		const std::vector<UnsignedType>& getIndices() const;
+
+		bool hasConfig() const;
+
+		// The configuration of the simulation (the file must have it)
+		const SimulationConfig& getConfig() const;
+
+		StepsView getSteps() const;
+
+		// The channel of the degree of freedom "index"
+		ChannelView getChannel(const UnsignedType& index) const;
+
+	private:
+
+		void unmap();
+
+		std::string m_fileName;
+		const char* m_data = nullptr;
+		UnsignedType m_size = 0;
+
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#endif
+
+		BinaryHeader m_header;
+		std::vector<UnsignedType> m_indices;
+		bool m_hasConfig = false;
+		SimulationConfig m_config;
+
+	};
+
+}
+
+#endif
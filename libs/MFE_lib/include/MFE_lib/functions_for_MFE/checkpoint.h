@@ -0,0 +1,74 @@
+// This file is used in the dinamic_solver files.
+// This file contains the checkpoints of the dynamic problem: the full state
+// of the time integrator (the context of the run) is written to a binary
+// file, so a long run can be continued after an interruption, extended in
+// time or split into several runs. The checkpoint keeps the configuration
+// of the run and the parameters of the step (the number of degrees of
+// freedom, the integrator and the hash of the stiffness and mass matrices -
+// the matrix of coefficients of the step is made of them), by which the
+// restart is checked.
+//
+// The file: the magic "MFECHK01", the version and the byte order, the
+// configuration (the text of the scenario file), the parameters of the step,
+// the context. The file is replaced at once: the checkpoint is written to
+// "<file>.tmp" and renamed, so an interruption does not damage the previous
+// checkpoint.
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+
+#include <MFE_lib/functions_for_MFE/dinamic_solver_MFE.h>
+
+namespace MFE
+{
+	constexpr char CHECKPOINT_MAGIC[8] = { 'M', 'F', 'E', 'C', 'H', 'K', '0', '1' };
+	constexpr std::uint32_t CHECKPOINT_VERSION = 1;
+	constexpr std::uint32_t CHECKPOINT_BYTE_ORDER = 0x01020304;
+
+	// The checkpoint of the run:
+	// config - the configuration of the run;
+	// integrator, dofCount, matrixHash - the parameters of the step: the
+	// integrator, the number of degrees of freedom and the hash of the
+	// stiffness and mass matrices after the symmetry conditions;
+	// context - the state of the step context.step;
+	// isStepRecorded - the step context.step is already passed to the sink
+	// (the checkpoint at the end of the run).
+	struct MFE_LIB_EXPORT Checkpoint
+	{
+		SimulationConfig config;
+		IntegratorParameters integrator;
+		UnsignedType dofCount = 0;
+		std::uint64_t matrixHash = 0;
+		SolverContext context;
+		bool isStepRecorded = false;
+	};
+
+	// The hash of the values of the stiffness and mass matrices (FNV-1a of
+	// the bits), the same matrices have the same hash
+	MFE_LIB_EXPORT std::uint64_t hashMatrices(const RealMatrix& matrixStiffness,
+		const RealMatrix& matrixMass);
+
+	// Writing the checkpoint, false if the file is not written (the previous
+	// checkpoint of the file is kept)
+	MFE_LIB_EXPORT bool writeCheckpoint(const Checkpoint& checkpoint,
+		const std::string& fileName);
+
+	// Reading the checkpoint, an exception is thrown if the file is not
+	// opened or is damaged
+	MFE_LIB_EXPORT Checkpoint readCheckpoint(const std::string& fileName);
+
+	// Checking that the run of the configuration can be continued from the
+	// checkpoint: the same problem (all values of the configuration except
+	// the name, the time and the files), the parameters of the step are the
+	// same, the time is not less than the time of the checkpoint.
+	// An exception is thrown if they are different.
+	MFE_LIB_EXPORT void checkRestart(const Checkpoint& checkpoint,
+		const SimulationConfig& config, const IntegratorParameters& integrator,
+		const UnsignedType& dofCount, const std::uint64_t& matrixHash);
+
+}
+
+#endif
@@ -8,19 +8,46 @@
 
 #include <algorithm>
 
-#include <MFE_lib/functions_for_MFE/solver_utils.h>
+#include <MFE_lib/functions_for_MFE/simulation_config.h>
+#include <MFE_lib/functions_for_MFE/result_sink.h>
 
 namespace MFE
 {
-	// Coefficients that are present in the displacement equations.
-	// These values ensure high accuracy and stability of the solution when using
-	// the Newmark method.
-	constexpr Real ALPHA = 0.25;
-	constexpr Real DELTA = 0.5;
-
 	// Value for force limitation in case of inaccurate calculation
 	constexpr Real coeffLimitForce = 1e8;
 
+	// The state of one run of the solver. Each run has its own context, so
+	// several simulations can be calculated at once in different threads:
+	// displacement, speed, acceleration - the kinematic state of the current
+	// step (after the symmetry conditions);
+	// isStuck - the current step is obtained by sticking;
+	// averagePointsSpeedOld - the average speed of the previous step;
+	// sumSteps - the time of the current step;
+	// step - the number of the current step;
+	// isAccelInitialNoZero - the initial acceleration is not zero (the
+	// sticking is not checked on the first step);
+	// isFirstForce, firstSumForce - the resultant force of the first step
+	// for the check of inaccuracy of calculations.
+	struct MFE_LIB_EXPORT SolverContext
+	{
+		RealVector displacement;
+		RealVector speed;
+		RealVector acceleration;
+		bool isStuck = false;
+		Real averagePointsSpeedOld = 0.0;
+		Real sumSteps = 0.0;
+		UnsignedType step = 0;
+		bool isAccelInitialNoZero = false;
+		bool isFirstForce = true;
+		Real firstSumForce = 0.0;
+	};
+
+	// The context of a new run: the initial speed and acceleration of the
+	// configuration for "size" degrees of freedom (before the symmetry
+	// conditions)
+	MFE_LIB_EXPORT SolverContext makeSolverContext(const SimulationConfig& config,
+		const UnsignedType& size);
+
 	// Applying symmetry conditions for a dinamic problem to a stiffness matrix,
 	// a mass matrix, a velocity vector, a displacement vector
 	// (meaning a row of the displacement matrix, since the matrix is constructed
@@ -31,44 +58,115 @@ namespace MFE
 		RealVector& speed, RealVector& acceleration,
 		RealVector& force);
 
-	// The decision functions take as input the number of time steps, the time step,
-	// the stiffness matrix, the mass matrix, and the displacement matrix, in which
-	// the initial displacements are recorded and in which the displacements will
-	// be recorded.
+	// Applying symmetry conditions for a dinamic problem with one
+	// displacement vector instead of the displacement matrix.
+	MFE_LIB_EXPORT void boundConditionsDinamic(RealMatrix& matrixStiffness,
+		RealMatrix& matrixMass, RealVector& displacement,
+		RealVector& speed, RealVector& acceleration,
+		RealVector& force);
 
-	// stepsCount = time / deltaT
+	// The decision functions take as input the configuration of the simulation,
+	// the stiffness matrix, the mass matrix, the initial displacements and
+	// the sink, to which the displacements of each step are passed (after the
+	// symmetry conditions). The solvers keep only the state of the current
+	// step, so the memory does not depend on the number of steps:
+	// stepsCount = time / deltaT.
+	// The functions do not read the console, all parameters are taken from
+	// the configuration, and the state of the run is kept in the local
+	// context, so the functions can be called from several threads at once.
+	// If the values go to infinity, the calculation stops and the sink
+	// gets only the steps before it.
 
 	// A function that solves the problem of dry friction without forcing force.
-	// The function asks you to enter the coefficients of dry friction of rest
-	// and dry friction of sliding.
-	MFE_LIB_EXPORT void dryFrictionFree(const UnsignedType& stepsCount,
-		const Real& deltaT, RealMatrix matrixStiffness,
-		RealMatrix matrixMass, RealMatrix& displacements);
+	// Uses the coefficients of dry friction of rest and dry friction of sliding
+	// and the normal reaction of the configuration.
+	MFE_LIB_EXPORT void dryFrictionFree(const SimulationConfig& config,
+		RealMatrix matrixStiffness, RealMatrix matrixMass,
+		RealVector initialDisplacements, ResultSink& sink);
 
 	// A function that solves the problem of dry friction with a driving force.
-	// The function asks you to enter the coefficients of dry friction of rest
-	// and dry friction of sliding.
-	MFE_LIB_EXPORT void forcedDryFriction(const UnsignedType& stepsCount,
-		const Real& deltaT, RealMatrix matrixStiffness,
-		RealMatrix matrixMass, RealMatrix& displacements);
+	// Uses the coefficients of dry friction of rest and dry friction of sliding,
+	// the normal reaction and the driving force of the configuration.
+	MFE_LIB_EXPORT void forcedDryFriction(const SimulationConfig& config,
+		RealMatrix matrixStiffness, RealMatrix matrixMass,
+		RealVector initialDisplacements, ResultSink& sink);
 
 	// A function that solves the problem of viscous friction with 
 	// a driving force.
-	// The function asks you to enter the coefficient of viscous friction
-	MFE_LIB_EXPORT void viscousFrictionForce(const UnsignedType& stepsCount,
-		const Real& deltaT, RealMatrix matrixStiffness,
-		RealMatrix matrixMass, RealMatrix& displacements);
+	// Uses the coefficient of viscous friction and the driving force
+	// of the configuration.
+	MFE_LIB_EXPORT void viscousFrictionForce(const SimulationConfig& config,
+		RealMatrix matrixStiffness, RealMatrix matrixMass,
+		RealVector initialDisplacements, ResultSink& sink);
+
+	// The same solvers that continue the run from the context: the matrices
+	// and the vectors of the context are after the symmetry conditions, the
+	// steps from context.step are calculated (context.step is the first step
+	// passed to the sink). If the checkpoint file of the configuration is set,
+	// the context is written to it every checkpointInterval steps and at the
+	// end of the run (checkpoint.h).
+	MFE_LIB_EXPORT void dryFrictionFree(const SimulationConfig& config,
+		const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+		SolverContext context, ResultSink& sink);
+
+	MFE_LIB_EXPORT void forcedDryFriction(const SimulationConfig& config,
+		const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+		SolverContext context, ResultSink& sink);
+
+	MFE_LIB_EXPORT void viscousFrictionForce(const SimulationConfig& config,
+		const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+		SolverContext context, ResultSink& sink);
+
+	// The same solvers with the displacement matrix: the initial displacements
+	// are taken from the first row, then the matrix is replaced by the
+	// displacements of all steps (MemorySink).
+	MFE_LIB_EXPORT void dryFrictionFree(const SimulationConfig& config,
+		RealMatrix matrixStiffness, RealMatrix matrixMass,
+		RealMatrix& displacements);
+
+	MFE_LIB_EXPORT void forcedDryFriction(const SimulationConfig& config,
+		RealMatrix matrixStiffness, RealMatrix matrixMass,
+		RealMatrix& displacements);
+
+	MFE_LIB_EXPORT void viscousFrictionForce(const SimulationConfig& config,
+		RealMatrix matrixStiffness, RealMatrix matrixMass,
+		RealMatrix& displacements);
 
 
 	// Solver for dinamic problem.
 	// It consists of a solver for the problem of dry friction without
 	// a driving force, dry friction with a driving force and viscous
-	// friction with a driving force.
-	// The solver takes the oscillation time, time step, stiffness matrix
-	// and mass matrix as input
+	// friction with a driving force (by the friction mode of the configuration).
+	// The solver takes the configuration, stiffness matrix, mass matrix and
+	// the sink of the results as input.
+	// If the restart file of the configuration is set, the run is continued
+	// from the checkpoint (the steps before it are not passed to the sink).
+	MFE_LIB_EXPORT void calculateDisplacementsDinamic(
+		const SimulationConfig& config, RealMatrix matrixStiffness,
+		RealMatrix matrixMass, ResultSink& sink);
+
+	// Solver for dinamic problem, returns the displacements of all steps
+	MFE_LIB_EXPORT RealMatrix calculateDisplacementsDinamic(
+		const SimulationConfig& config, RealMatrix matrixStiffness,
+		RealMatrix matrixMass);
+
+	// Solver for dinamic problem with the console front end.
+	// The solver takes the oscillation time, time step, stiffness matrix and
+	// mass matrix as input, the other parameters are entered from the console
+	// (inputSolverParameters)
 	MFE_LIB_EXPORT RealMatrix calculateDisplacementsDinamic
 	(const Real& time, const Real& deltaT,
 		RealMatrix matrixStiffness, RealMatrix matrixMass);
 
+	// The simulation without the console: the configuration is checked, the
+	// stiffness matrix and the diagonal mass matrix are built from the finite
+	// element of the configuration and the dinamic problem is solved.
+	// The displacements of the steps are passed to the sink.
+	MFE_LIB_EXPORT void runSimulation(const SimulationConfig& config,
+		ResultSink& sink);
+
+	// The simulation without the console, returns the displacement matrix.
+	MFE_LIB_EXPORT RealMatrix runSimulation(const SimulationConfig& config);
+
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+// This file is used in the applications with elements of different sizes
+// and materials.
+// This file contains the stiffness matrices of several finite elements at
+// once: the properties of STIFFNESS_LANES elements are kept by fields
+// (structure of arrays), and each operation of makeMatrixStiffness is done
+// for all lanes in one loop, which the compiler vectorizes (SIMD). The
+// matrices are the same as of makeMatrixStiffness for each element.
+
+#ifndef ELEMENT_BATCH_H
+#define ELEMENT_BATCH_H
+
+#include <vector>
+
+#include <MFE_lib/functions_for_MFE/reference_element.h>
+
+namespace MFE
+{
+	// The number of the elements of a batch: 4 doubles are one AVX register
+	// (the same lanes are used by the batches of MeshStiffnessOperator)
+	constexpr UnsignedType STIFFNESS_LANES = 4;
+
+	using StiffnessLaneValues = std::array<Real, STIFFNESS_LANES>;
+
+	// The properties of the elements of the batch by fields, the lanes from
+	// count are not used
+	struct MFE_LIB_EXPORT ElementBatch
+	{
+		UnsignedType count = 0;
+		StiffnessLaneValues modulusElastic{};
+		StiffnessLaneValues poissonRatio{};
+		StiffnessLaneValues length{};
+		StiffnessLaneValues width{};
+		StiffnessLaneValues heigth{};
+	};
+
+	// [row][column][lane]
+	using BatchStiffness = std::array<std::array<StiffnessLaneValues,
+		ELEMENT_DOF_COUNT>, ELEMENT_DOF_COUNT>;
+
+	// The batch of the elements from "first" (up to STIFFNESS_LANES), the
+	// elements must have the full integration
+	MFE_LIB_EXPORT ElementBatch makeElementBatch(
+		const std::vector<FiniteElement>& elements, const UnsignedType& first);
+
+	// The stiffness matrices of the elements of the batch
+	MFE_LIB_EXPORT void makeMatrixStiffnessBatch(const ElementBatch& batch,
+		BatchStiffness& result);
+
+	// The stiffness matrices of the elements (by batches)
+	MFE_LIB_EXPORT std::vector<RealMatrix> makeMatrixStiffnessBatch(
+		const std::vector<FiniteElement>& elements);
+}
+
+#endif
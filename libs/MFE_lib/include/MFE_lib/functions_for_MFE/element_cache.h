@@ -0,0 +1,109 @@
+// This file is used in the dinamic_solver files and in the applications.
+// This file contains the cache of the matrices of the finite element: the
+// stiffness matrix and the diagonal mass matrix are built once for the same
+// fields of the FiniteElement and are shared as immutable matrices. The
+// stiffness is linear in the modulus of elasticity, so the stiffness for the
+// modulus 1 is kept too: if only the modulus changes (sweeps by the modulus),
+// the stiffness is scaled without the assembly. The cache is thread-safe,
+// the samples of the sweeps calculated in parallel use the same cache.
+
+#ifndef ELEMENT_CACHE_H
+#define ELEMENT_CACHE_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include <MFE_lib/functions_for_MFE/matrix_MFE.h>
+
+namespace MFE
+{
+	// The number of the kept matrices of each kind by default, the oldest
+	// matrices are removed
+	constexpr UnsignedType ELEMENT_CACHE_CAPACITY = 256;
+
+	using SharedMatrix = std::shared_ptr<const RealMatrix>;
+
+	// The counters of the cache:
+	// hits - the matrix is found;
+	// modulusHits - the stiffness is scaled from the stiffness for the
+	// modulus 1 of the same geometry and Poisson's ratio;
+	// misses - the matrix is built.
+	struct MFE_LIB_EXPORT ElementCacheStats
+	{
+		UnsignedType hits = 0;
+		UnsignedType modulusHits = 0;
+		UnsignedType misses = 0;
+	};
+
+	// The matrices are the same as of makeMatrixStiffness and
+	// makeMatrixMassDiag (bitwise). The keys are the exact values of the
+	// fields, the elements with not finite fields are not cached.
+	class MFE_LIB_EXPORT ElementMatrixCache
+	{
+	public:
+
+		explicit ElementMatrixCache(
+			const UnsignedType& capacity = ELEMENT_CACHE_CAPACITY);
+
+		ElementMatrixCache(const ElementMatrixCache&) = delete;
+		ElementMatrixCache& operator=(const ElementMatrixCache&) = delete;
+
+		// The cache of the library, it is used by runSimulation
+		static ElementMatrixCache& getInstance();
+
+		SharedMatrix getStiffness(const FiniteElement& finiteElement);
+
+		// size - this is the size of the stiffness matrix
+		SharedMatrix getMassDiag(const UnsignedType& size,
+			const FiniteElement& finiteElement);
+
+		ElementCacheStats getStats() const;
+
+		void clear();
+
+	private:
+
+		// modulus of elasticity, Poisson's ratio, length, width, heigth,
+		// formulation, hourglass coefficient
+		using StiffnessKey =
+			std::tuple<Real, Real, Real, Real, Real, ElementFormulation, Real>;
+
+		// Poisson's ratio, length, width, heigth, formulation, hourglass
+		// coefficient
+		using ModulusKey =
+			std::tuple<Real, Real, Real, Real, ElementFormulation, Real>;
+
+		// size, dencity, length, width, heigth
+		using MassKey = std::tuple<UnsignedType, Real, Real, Real, Real>;
+
+		// The matrices and the order of their addition
+		template <typename Key>
+		struct Entries
+		{
+			std::map<Key, SharedMatrix> matrices;
+			std::deque<Key> order;
+		};
+
+		template <typename Key>
+		SharedMatrix find(const Entries<Key>& entries, const Key& key) const;
+
+		template <typename Key>
+		void insert(Entries<Key>& entries, const Key& key,
+			const SharedMatrix& matrix);
+
+		UnsignedType m_capacity = ELEMENT_CACHE_CAPACITY;
+
+		mutable std::mutex m_mutex;
+		Entries<StiffnessKey> m_stiffness;
+		Entries<ModulusKey> m_stiffnessPerModulus;
+		Entries<MassKey> m_massDiag;
+		ElementCacheStats m_stats;
+
+	};
+
+}
+
+#endif
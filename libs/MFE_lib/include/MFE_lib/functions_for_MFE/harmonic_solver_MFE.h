@@ -0,0 +1,76 @@
+// This file contains functions for calculating the steady state of the
+// problem of viscous friction with a harmonic driving force in the frequency
+// domain: instead of integrating the transient over time, the complex
+// system (K - w^2 * M + i * w * C) * U = F is solved once per frequency,
+// where the damping matrix C is the mass matrix multiplied by the
+// coefficient of viscous friction (as in viscousFrictionForce).
+// The transient can be added to the steady state from the modal data.
+
+#ifndef HARMONIC_SOLVER_MFE_H
+#define HARMONIC_SOLVER_MFE_H
+
+#include <MFE_lib/functions_for_MFE/dinamic_solver_MFE.h>
+
+namespace MFE
+{
+	// The steady state at one frequency of the driving force: the
+	// displacement of each degree of freedom (after the symmetry conditions)
+	// is amplitude * cos(frequency * t + phase).
+	struct MFE_LIB_EXPORT FrequencyResponse
+	{
+		Real frequency = 0.0;
+		RealVector amplitude;
+		RealVector phase;
+	};
+
+	// Natural frequencies and mass-normalized modes, the modes are written in
+	// the rows of the matrix "modes" in the order of the frequencies.
+	struct MFE_LIB_EXPORT ModalData
+	{
+		RealVector naturalFrequencies;
+		RealMatrix modes;
+	};
+
+	// Applying symmetry conditions to the stiffness matrix and the mass matrix
+	// (the same degrees of freedom are deleted as in boundConditionsDinamic).
+	// All the functions below take the matrices after this function.
+	MFE_LIB_EXPORT void boundConditionsHarmonic(RealMatrix& matrixStiffness,
+		RealMatrix& matrixMass);
+
+	// The steady state for the frequency of the driving force "frequency"
+	// (rad/s) and the amplitude of the driving force "amplitudeForce" acting
+	// on the final element (distributed over the active degrees of freedom
+	// as in setForceViscous).
+	MFE_LIB_EXPORT FrequencyResponse solveHarmonicViscous(
+		const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+		const Real& coeffViscousFriction, const Real& amplitudeForce,
+		const Real& frequency);
+
+	// The frequency response curve: the steady states for all frequencies,
+	// calculated in parallel in "threadsCount" threads
+	// (0 - by the number of cores).
+	MFE_LIB_EXPORT std::vector<FrequencyResponse> sweepFrequencyViscous(
+		const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+		const Real& coeffViscousFriction, const Real& amplitudeForce,
+		const RealVector& frequencies, const UnsignedType& threadsCount = 0);
+
+	// Natural frequencies and modes of the problem K * u = w^2 * M * u.
+	// The mass matrix must be diagonal (makeMatrixMassDiag).
+	MFE_LIB_EXPORT ModalData calculateModalData(const RealMatrix& matrixStiffness,
+		const RealMatrix& matrixMass);
+
+	// The displacements at the time moments "stepsTime" (the rows of the
+	// result, as in the displacement matrix of the dynamic problem).
+	// The steady state is supplemented by the transient, which is obtained
+	// from the modal data and the initial displacements and speeds
+	// (after the symmetry conditions). If the modal data is empty,
+	// only the steady state is returned.
+	MFE_LIB_EXPORT RealMatrix calculateHarmonicDisplacements(
+		const FrequencyResponse& steadyState, const ModalData& modalData,
+		const RealMatrix& matrixMass, const Real& coeffViscousFriction,
+		const RealVector& initialDisps, const RealVector& initialSpeed,
+		const RealVector& stepsTime);
+
+}
+
+#endif
@@ -0,0 +1,122 @@
+// This file is used in the applications.
+// This file contains the structured mesh of the body: the part of the body
+// with the conditions of symmetry (the finite element of the other files)
+// is divided into countX x countY x countZ 8-node bricks. The nodes are
+// numbered along the length first, then along the width and the heigth,
+// the degrees of freedom of the node are 3 * node + direction. The global
+// stiffness matrix (sparse) and the lumped mass matrix are assembled from
+// the matrices of the element (makeMatrixStiffness, makeMatrixMassDiag),
+// the static problem is solved by the conjugate gradient method. With one
+// element the mesh is the finite element of the other files.
+
+#ifndef HEX_MESH_H
+#define HEX_MESH_H
+
+#include <vector>
+
+#include <MFE_lib/sparse_matrix.h>
+#include <MFE_lib/functions_for_MFE/reference_element.h>
+
+namespace MFE
+{
+	// The nodes of the element in the order of REFERENCE_NODES
+	using ElementNodes = std::array<UnsignedType, ELEMENT_NODES_COUNT>;
+
+	// The mesh of the body:
+	// finiteElement - the material and the dimensions of one element;
+	// nodes - the coordinates (x along the length, 0 is the plane of
+	// symmetry);
+	// symmetryDofs - the degrees of freedom fixed by the conditions of
+	// symmetry (the normal displacements of the planes x = 0, y = 0, z = 0),
+	// in ascending order;
+	// frontNodes - the nodes of the front face x = length, the static load
+	// acts on them;
+	// wallNodes - the nodes of the faces y = width and z = heigth, which are
+	// in contact with the walls of the tube;
+	// colors - the numbers of the elements by colors (colorElements), the
+	// elements of one color do not have common nodes.
+	struct MFE_LIB_EXPORT HexMesh
+	{
+		UnsignedType countX = 1;
+		UnsignedType countY = 1;
+		UnsignedType countZ = 1;
+		FiniteElement finiteElement;
+
+		std::vector<Array3D> nodes;
+		std::vector<ElementNodes> elements;
+
+		std::vector<UnsignedType> symmetryDofs;
+		std::vector<UnsignedType> frontNodes;
+		std::vector<UnsignedType> wallNodes;
+
+		std::vector<std::vector<UnsignedType>> colors;
+	};
+
+	// The mesh of the part of the body with the dimensions and the material
+	// of "body" (a FiniteElement), divided into countX x countY x countZ
+	// elements
+	MFE_LIB_EXPORT HexMesh makeHexMesh(const FiniteElement& body,
+		const UnsignedType& countX, const UnsignedType& countY,
+		const UnsignedType& countZ);
+
+	// The greedy coloring of the elements: each element in turn gets the
+	// first color, which the elements with common nodes do not have (the
+	// structured mesh has 8 colors). The elements of a color are in
+	// ascending order.
+	MFE_LIB_EXPORT std::vector<std::vector<UnsignedType>> colorElements(
+		const std::vector<ElementNodes>& elements, const UnsignedType& nodesCount);
+
+	// The number of the node by its numbers along the length, the width and
+	// the heigth (0 ... count)
+	MFE_LIB_EXPORT UnsignedType getMeshNode(const HexMesh& mesh,
+		const UnsignedType& nodeX, const UnsignedType& nodeY,
+		const UnsignedType& nodeZ);
+
+	// direction: 0 - x, 1 - y, 2 - z
+	MFE_LIB_EXPORT UnsignedType getMeshDof(const UnsignedType& node,
+		const UnsignedType& direction);
+
+	MFE_LIB_EXPORT UnsignedType getMeshDofCount(const HexMesh& mesh);
+
+	// The assembly: the colors one after another, the elements of a color
+	// in parallel in "threadsCount" threads (0 - by the number of cores)
+	// without locks. The values are added in the order of the colors, so
+	// the matrices do not depend on the number of threads.
+
+	// The global stiffness matrix, the pattern is the nodes of the common
+	// elements
+	MFE_LIB_EXPORT SparseMatrix assembleStiffnessMesh(const HexMesh& mesh,
+		const UnsignedType& threadsCount = 0);
+
+	// The global stiffness matrix in the dense matrix (small meshes)
+	MFE_LIB_EXPORT RealMatrix assembleStiffnessMeshDense(const HexMesh& mesh,
+		const UnsignedType& threadsCount = 0);
+
+	// The diagonal of the lumped mass matrix
+	MFE_LIB_EXPORT RealVector assembleMassMesh(const HexMesh& mesh,
+		const UnsignedType& threadsCount = 0);
+
+	// The lumped mass matrix in the dense diagonal matrix
+	// (as makeMatrixMassDiag)
+	MFE_LIB_EXPORT RealMatrix assembleMassMeshDense(const HexMesh& mesh,
+		const UnsignedType& threadsCount = 0);
+
+	// Applying symmetry conditions for a static problem on the global matrix
+	// stiffness (as boundConditionStatic)
+	MFE_LIB_EXPORT void boundConditionStaticMesh(const HexMesh& mesh,
+		SparseMatrix& matrixStiffness);
+
+	// The static load along the length on the front face, distributed by the
+	// areas of the nodes (with one element - as makeInitialStaticForce)
+	MFE_LIB_EXPORT RealVector makeStaticForceMesh(const HexMesh& mesh,
+		const Real& initialForce);
+
+	// The displacements of the static problem with the load on the front
+	// face
+	MFE_LIB_EXPORT IterativeSolution calculateDispStaticMesh(const HexMesh& mesh,
+		const Real& initialForce,
+		const IterativeSolverOptions& options = IterativeSolverOptions(),
+		const UnsignedType& threadsCount = 0);
+}
+
+#endif
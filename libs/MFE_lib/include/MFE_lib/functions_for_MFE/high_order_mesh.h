@@ -0,0 +1,154 @@
+// This file is used in the applications.
+// This file contains the structured mesh of the body of the hexahedral
+// elements of the order p (the nodes of the element are the tensor product
+// of p + 1 Gauss - Lobatto - Legendre points along each direction, 8 nodes
+// for p = 1, 27 nodes for p = 2) and the stiffness matrix of the mesh
+// without storage. The shape functions are the products of the
+// one-dimensional Lagrange polynomials of ksi, etta and psi (as
+// shapeFunction), so the gradient of the displacements at the Gauss points
+// and the forces of the stresses are calculated by the one-dimensional
+// matrices along one direction after another (sum factorization): O(p^4)
+// operations for the element instead of O(p^6) of the product by the matrix
+// of the element. The stiffness is integrated by (p + 1) x (p + 1) x (p + 1)
+// Gauss points, which is exact for the brick; with p = 1 it is the element
+// of makeMatrixStiffness. The nodes, the conditions of symmetry and the load
+// are as in hex_mesh.h.
+
+#ifndef HIGH_ORDER_MESH_H
+#define HIGH_ORDER_MESH_H
+
+#include <memory>
+
+#include <MFE_lib/functions_for_MFE/hex_mesh.h>
+
+namespace MFE
+{
+	// The pool of the threads of the operators (mesh_operator.h)
+	class ThreadPool;
+
+	constexpr UnsignedType MIN_ELEMENT_ORDER = 1;
+	constexpr UnsignedType MAX_ELEMENT_ORDER = 10;
+
+	// The one-dimensional basis of the order p on [-1, 1]:
+	// nodes, nodeWeights - the Gauss - Lobatto - Legendre points (the nodes
+	// of the element along one direction) and their weights;
+	// gaussPoints, gaussWeights - the p + 1 Gauss points of the integration;
+	// values, derivatives - the Lagrange polynomials of the nodes and their
+	// derivatives at the Gauss points [Gauss point][node].
+	struct MFE_LIB_EXPORT LagrangeBasis
+	{
+		UnsignedType order = 0;
+		RealVector nodes;
+		RealVector nodeWeights;
+		RealVector gaussPoints;
+		RealVector gaussWeights;
+		RealMatrix values;
+		RealMatrix derivatives;
+	};
+
+	MFE_LIB_EXPORT LagrangeBasis makeLagrangeBasis(const UnsignedType& order);
+
+	// The mesh of the body of countX x countY x countZ elements of the
+	// order "order":
+	// finiteElement - the material and the dimensions of one element (the
+	// field formulation is not used);
+	// symmetryDofs - the degrees of freedom fixed by the conditions of
+	// symmetry, in ascending order;
+	// frontNodes - the nodes of the front face x = length.
+	// The nodes are numbered along the length first, then along the width
+	// and the heigth (countX * order + 1 nodes along the length).
+	struct MFE_LIB_EXPORT HighOrderMesh
+	{
+		UnsignedType order = 1;
+		UnsignedType countX = 1;
+		UnsignedType countY = 1;
+		UnsignedType countZ = 1;
+		FiniteElement finiteElement;
+		LagrangeBasis basis;
+
+		std::vector<UnsignedType> symmetryDofs;
+		std::vector<UnsignedType> frontNodes;
+	};
+
+	MFE_LIB_EXPORT HighOrderMesh makeHighOrderMesh(const FiniteElement& body,
+		const UnsignedType& order, const UnsignedType& countX,
+		const UnsignedType& countY, const UnsignedType& countZ);
+
+	// The number of the node by its numbers along the length, the width and
+	// the heigth (0 ... count * order)
+	MFE_LIB_EXPORT UnsignedType getHighOrderNode(const HighOrderMesh& mesh,
+		const UnsignedType& nodeX, const UnsignedType& nodeY,
+		const UnsignedType& nodeZ);
+
+	// The degrees of freedom are getMeshDof(node, direction)
+	MFE_LIB_EXPORT UnsignedType getHighOrderDofCount(const HighOrderMesh& mesh);
+
+	// The static load along the length on the front face, distributed by the
+	// integrals of the shape functions of the nodes over the face (with
+	// p = 1 - as makeStaticForceMesh)
+	MFE_LIB_EXPORT RealVector makeStaticForceHighOrder(const HighOrderMesh& mesh,
+		const Real& initialForce);
+
+	// The stiffness matrix of the mesh by sum factorization. The rows of the
+	// elements along x are calculated in parallel by the four colors of the
+	// tiles (as MeshStiffnessOperator, one row in the tile), the result does
+	// not depend on the number of threads. The mesh must exist while the
+	// operator is used.
+	// threadsCount - the number of threads (0 - by the number of cores).
+	class MFE_LIB_EXPORT HighOrderStiffnessOperator : public LinearOperator
+	{
+	public:
+
+		explicit HighOrderStiffnessOperator(const HighOrderMesh& mesh,
+			const UnsignedType& threadsCount = 0);
+
+		UnsignedType sizeRows() const override;
+
+		void apply(const RealVector& vec, RealVector& result) const override;
+
+		RealVector getDiagonal() const override;
+
+		// Applying symmetry conditions for a static problem
+		// (as boundConditionStaticMesh)
+		void boundConditionStatic();
+
+	private:
+
+		// Adding the products of the elements of the tile "tile" (one row
+		// of the elements along x, makeTileColors)
+		void applyTile(const UnsignedType& tile, const RealVector& vec,
+			RealVector& result) const;
+
+		const HighOrderMesh& m_mesh;
+		std::shared_ptr<ThreadPool> m_threadPool;
+		std::vector<std::vector<UnsignedType>> m_tileColors;
+
+		// The elastic constants (makeMatrixElConst) multiplied by the
+		// determinant of the Jacobi matrix, the derivatives of the local
+		// coordinates by x, y, z
+		Real m_normal = 0.0;
+		Real m_lateral = 0.0;
+		Real m_shear = 0.0;
+		Array3D m_scales{};
+
+		// The matrices of the basis by rows (the values and the derivatives
+		// at the Gauss points) and the transposed ones
+		RealVector m_values;
+		RealVector m_derivatives;
+		RealVector m_valuesTransposed;
+		RealVector m_derivativesTransposed;
+
+		RealVector m_diagonal;
+		std::vector<UnsignedType> m_penaltyDofs;
+
+	};
+
+	// The displacements of the static problem with the load on the front
+	// face
+	MFE_LIB_EXPORT IterativeSolution calculateDispStaticHighOrder(
+		const HighOrderMesh& mesh, const Real& initialForce,
+		const IterativeSolverOptions& options = IterativeSolverOptions(),
+		const UnsignedType& threadsCount = 0);
+}
+
+#endif
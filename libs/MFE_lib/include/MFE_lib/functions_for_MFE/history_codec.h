@@ -0,0 +1,165 @@
+// This file is used in the dinamic_solver files and in the post-processing.
+// This file contains the lossless compression of the histories of
+// displacements. The histories are smooth, so the value of a step is close
+// to the extrapolation by the previous steps: the difference of the bits of
+// the value and of the prediction (as integers) is small, and only its
+// meaningful bits are written with a short prefix of their number (as in
+// the "Gorilla" compression of floating point series, where the XOR is
+// written instead of the difference). The steps of sticking, when the
+// displacements do not change, take one bit.
+// Predictors (the extrapolation by the polynomial through the previous
+// steps):
+// CODEC_PREVIOUS - the value of the previous step;
+// CODEC_LINEAR - by the two previous steps;
+// CODEC_QUADRATIC - by the three previous steps;
+// CODEC_CUBIC - by the four previous steps.
+
+#ifndef HISTORY_CODEC_H
+#define HISTORY_CODEC_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <MFE_lib/functions_for_MFE/result_sink.h>
+
+namespace MFE
+{
+	enum CodecPredictor
+	{
+		CODEC_PREVIOUS,
+		CODEC_LINEAR,
+		CODEC_QUADRATIC,
+		CODEC_CUBIC,
+	};
+
+	// The number of previous values of the predictors
+	constexpr UnsignedType CODEC_HISTORY_SIZE = 4;
+
+	// The extension of the file of the compressed history (the batch runner
+	// writes it if the output file has the extension)
+	const std::string COMPRESSED_HISTORY_EXTENSION = ".mfez";
+
+	// The compressed series: the bits are written to the words from the
+	// highest bit
+	struct MFE_LIB_EXPORT CompressedSeries
+	{
+		CodecPredictor predictor = CODEC_CUBIC;
+		UnsignedType count = 0;
+		UnsignedType bitsCount = 0;
+		std::vector<std::uint64_t> words;
+	};
+
+	// Compression of the series value by value
+	class MFE_LIB_EXPORT SeriesEncoder
+	{
+	public:
+
+		explicit SeriesEncoder(const CodecPredictor& predictor = CODEC_CUBIC);
+
+		void add(const Real& value);
+
+		const CompressedSeries& getSeries() const;
+
+		// The size of the compressed series in bytes
+		UnsignedType getSize() const;
+
+	private:
+
+		void writeBits(const std::uint64_t& bits, const UnsignedType& bitsCount);
+
+		CompressedSeries m_series;
+
+		// The previous values, the last is the first
+		std::array<Real, CODEC_HISTORY_SIZE> m_previous = {};
+
+		// The number of the meaningful bits of the differences
+		UnsignedType m_length = 0;
+
+	};
+
+	// Decompression of the series value by value
+	class MFE_LIB_EXPORT SeriesDecoder
+	{
+	public:
+
+		explicit SeriesDecoder(const CompressedSeries& series);
+
+		// false if all values are read
+		bool next(Real& value);
+
+	private:
+
+		std::uint64_t readBits(const UnsignedType& bitsCount);
+
+		const CompressedSeries& m_series;
+		UnsignedType m_valueNum = 0;
+		UnsignedType m_bitNum = 0;
+
+		std::array<Real, CODEC_HISTORY_SIZE> m_previous = {};
+		UnsignedType m_length = 0;
+
+	};
+
+	MFE_LIB_EXPORT CompressedSeries compressSeries(const RealVector& values,
+		const CodecPredictor& predictor = CODEC_CUBIC);
+
+	MFE_LIB_EXPORT RealVector decompressSeries(const CompressedSeries& series);
+
+	// The compressed history of the degrees of freedom "indices"
+	struct MFE_LIB_EXPORT CompressedHistory
+	{
+		Real deltaT = 0.0;
+		std::vector<UnsignedType> indices;
+		CompressedSeries steps;
+		std::vector<CompressedSeries> channels;
+	};
+
+	// The sink that keeps the history of the degrees of freedom "indices"
+	// compressed in memory
+	class MFE_LIB_EXPORT CompressedSink : public ResultSink
+	{
+	public:
+
+		explicit CompressedSink(const std::vector<UnsignedType>& indices =
+			std::vector<UnsignedType>(ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()),
+			const CodecPredictor& predictor = CODEC_CUBIC);
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+		const CompressedHistory& getHistory() const;
+
+		// The decompressed channel of the degree of freedom "index"
+		RealVector getChannel(const UnsignedType& index) const;
+
+		// The size of the history in bytes: compressed and without compression
+		UnsignedType getSize() const;
+		UnsignedType getRawSize() const;
+
+	private:
+
+		CodecPredictor m_predictor = CODEC_CUBIC;
+		CompressedHistory m_history;
+		std::vector<SeriesEncoder> m_encoders;
+		SeriesEncoder m_stepsEncoder;
+
+	};
+
+	// Writing the compressed history to the file and reading it, the
+	// functions return false / throw an exception if the file is not written
+	// or is damaged
+	MFE_LIB_EXPORT bool writeCompressedHistory(const CompressedHistory& history,
+		const std::string& fileName);
+
+	MFE_LIB_EXPORT CompressedHistory readCompressedHistory(
+		const std::string& fileName);
+
+}
+
+#endif
@@ -25,6 +25,16 @@ namespace MFE
 	// Time step setting function
 	MFE_LIB_EXPORT Real inputDeltaT();
 
+	// The function of choosing the initial static load acting on the edge
+	// (0 - zero initial displacements)
+	MFE_LIB_EXPORT Real inputInitialStaticLoad();
+
+	// Initial speed setting function
+	MFE_LIB_EXPORT Real inputInitialSpeed();
+
+	// Initial acceleration setting function
+	MFE_LIB_EXPORT Real inputInitialAccel();
+
 	// Everywhere "size" is the row size of the stiffness matrix.
 
 	// The function of setting a static load to solve a static problem.
@@ -36,12 +46,25 @@ namespace MFE
 	// a static problem or manually setting displacements
 	MFE_LIB_EXPORT RealVector makeInitialDisps(RealMatrix matrixStiffness);
 
+	// The function of setting initial displacements from a static problem
+	// with the given load on the edge (zero load - zero displacements).
+	MFE_LIB_EXPORT RealVector makeInitialDisps(RealMatrix matrixStiffness,
+		const Real& initialStaticLoad);
+
 	// The function of setting the initial speeds manually.
 	MFE_LIB_EXPORT RealVector makeInitialSpeed(const UnsignedType& size);
 
+	// The function of setting the given initial speed.
+	MFE_LIB_EXPORT RealVector makeInitialSpeed(const UnsignedType& size,
+		const Real& speed);
+
 	// The function of setting the initial acceleration manually.
 	MFE_LIB_EXPORT RealVector makeInitialAccel(const UnsignedType& size);
 
+	// The function of setting the given initial acceleration.
+	MFE_LIB_EXPORT RealVector makeInitialAccel(const UnsignedType& size,
+		const Real& acceleration);
+
 	// Applying symmetry conditions for a static problem on matrix stiffness.
 	MFE_LIB_EXPORT void boundConditionStatic(RealMatrix& matrixStiffness);
 
@@ -20,6 +20,11 @@ namespace MFE
 	constexpr Real MAX_DENCITY = 19200.0;
 	constexpr Real MIN_SIZE_FINITE_ELEMENT = 1.0e-3;
 
+	// The coefficient of the stiffness of the hourglass modes of the element
+	// with the reduced integration (Flanagan - Belytschko)
+	constexpr Real HOURGLASS_COEFFICIENT = 0.1;
+	constexpr UnsignedType HOURGLASS_MODES_COUNT = 4;
+
 	enum Properties
 	{
 		PROPERTIES_MODULUS_ELASTIC,
@@ -30,6 +35,14 @@ namespace MFE
 		PROPERTIES_HEIGTH,
 	};
 
+	// The integration of the stiffness matrix: 2 x 2 x 2 Gauss points or one
+	// point in the center with the hourglass stabilization
+	enum ElementFormulation
+	{
+		FORMULATION_FULL_INTEGRATION,
+		FORMULATION_REDUCED_INTEGRATION,
+	};
+
 	// Finite element structure, default structure fields:
 	// modulus of elasticity = 7e10;
 	// poisson's ratio. = 0.33;
@@ -37,6 +50,8 @@ namespace MFE
 	// length = 0.5
 	// width = 0.06;
 	// heigth = 0.05;
+	// formulation = FORMULATION_FULL_INTEGRATION;
+	// hourglassCoefficient = HOURGLASS_COEFFICIENT.
 	struct MFE_LIB_EXPORT FiniteElement
 	{
 		// Material properties: modulus Elastic, Poisson's ratio, dencity
@@ -48,6 +63,26 @@ namespace MFE
 		Real length = 0.10;
 		Real width = 0.06;
 		Real heigth = 0.05;
+
+		// The integration of the stiffness matrix and the coefficient of the
+		// hourglass stiffness (only for the reduced integration)
+		ElementFormulation formulation = FORMULATION_FULL_INTEGRATION;
+		Real hourglassCoefficient = HOURGLASS_COEFFICIENT;
+	};
+
+	// The element with the reduced integration for the modulus of elasticity
+	// 1: the derivatives of the shape functions at the center
+	// [node][direction], the hourglass vectors [mode][node], the volume, the
+	// elastic constants (makeMatrixElConst) and the hourglass stiffness
+	struct MFE_LIB_EXPORT ReducedElement
+	{
+		std::array<Array3D, 8> derivatives{};
+		std::array<std::array<Real, 8>, HOURGLASS_MODES_COUNT> hourglassVectors{};
+		Real volume = 0.0;
+		Real normal = 0.0;
+		Real lateral = 0.0;
+		Real shear = 0.0;
+		Real hourglassStiffness = 0.0;
 	};
 
 	// Entering material properties manually
@@ -109,9 +144,31 @@ namespace MFE
 	MFE_LIB_EXPORT RealMatrix makeMatrixMassDiag(const UnsignedType& size,
 		const FiniteElement& finiteElement);
 
-	// Its function creates a stiffness matrix
+	// Its function checks the dimensions of the element and the Poisson's
+	// ratio for the stiffness (all stiffness functions of the element call it)
+	MFE_LIB_EXPORT void checkStiffnessProperties(
+		const FiniteElement& finiteElement);
+
+	// Its function creates a stiffness matrix from the reference blocks
+	// of reference_element.h (the full integration) or by one point with
+	// the hourglass stiffness (the reduced integration)
 	MFE_LIB_EXPORT RealMatrix makeMatrixStiffness(const FiniteElement& finiteElement);
 
+	// Its function creates a stiffness matrix for the modulus of elasticity 1
+	// (the field modulusElastic is not used)
+	MFE_LIB_EXPORT RealMatrix makeMatrixStiffnessPerModulus(
+		const FiniteElement& finiteElement);
+
+	// Its function creates the element with the reduced integration
+	// (the field formulation is not used)
+	MFE_LIB_EXPORT ReducedElement makeReducedElement(
+		const FiniteElement& finiteElement);
+
+	// Its function multiplies the stiffness matrix for the modulus 1 by
+	// the modulus of elasticity
+	MFE_LIB_EXPORT RealMatrix scaleMatrixStiffness(
+		const RealMatrix& stiffnessPerModulus, const Real& modulusElastic);
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+// This file is used in the hex_mesh files and in the applications.
+// This file contains the stiffness matrix of the mesh without storage: the
+// product K * u is the sum of the products of the matrices of the elements
+// by the displacements of their nodes (element by element). All elements of
+// the structured mesh have the same matrix (makeMatrixStiffness), so the
+// memory is the matrix of one element and the vectors of the degrees of
+// freedom instead of the nonzeros of the global matrix. The elements are
+// taken by STIFFNESS_LANES in the lanes of arrays (one loop over the lanes
+// for all elements of the batch). The layers of the elements along z are
+// divided into the tiles of the rows along y, the tiles are calculated in
+// parallel by the threads of the operator, which wait between the products:
+// the four colors of the tiles (by the parities of the layer and of the
+// tile in the layer) one after another, so the tiles at the same time do
+// not have common nodes and the sums do not need atomics. The result does
+// not depend on the number of threads. The elements with the reduced
+// integration are calculated without the matrix: by the gradient at the
+// center and the amplitudes of the hourglass modes (about a quarter of the
+// operations of the product by the matrix).
+
+#ifndef MESH_OPERATOR_H
+#define MESH_OPERATOR_H
+
+#include <memory>
+
+#include <MFE_lib/functions_for_MFE/element_batch.h>
+#include <MFE_lib/functions_for_MFE/element_cache.h>
+#include <MFE_lib/functions_for_MFE/hex_mesh.h>
+
+namespace MFE
+{
+	// The tile has at least MESH_TILE_ELEMENTS elements (the whole rows
+	// along x), if the layer has them
+	constexpr UnsignedType MESH_TILE_ELEMENTS = 4 * STIFFNESS_LANES;
+
+	// The pool of the threads of the operators (the threads are created
+	// once with the operator)
+	class ThreadPool;
+
+	// The mesh must exist while the operator is used.
+	// threadsCount - the number of threads (0 - by the number of cores).
+	class MFE_LIB_EXPORT MeshStiffnessOperator : public LinearOperator
+	{
+	public:
+
+		explicit MeshStiffnessOperator(const HexMesh& mesh,
+			const UnsignedType& threadsCount = 0);
+
+		UnsignedType sizeRows() const override;
+
+		void apply(const RealVector& vec, RealVector& result) const override;
+
+		RealVector getDiagonal() const override;
+
+		// Applying symmetry conditions for a static problem
+		// (as boundConditionStaticMesh)
+		void boundConditionStatic();
+
+	private:
+
+		// Adding the products of the elements of the tile "tile"
+		// (makeTileColors)
+		void applyTile(const UnsignedType& tile, const RealVector& vec,
+			RealVector& result) const;
+
+		const HexMesh& m_mesh;
+		std::shared_ptr<ThreadPool> m_threadPool;
+		UnsignedType m_tileRows = 1;
+		std::vector<std::vector<UnsignedType>> m_tileColors;
+		SharedMatrix m_elementStiffness;
+		RealVector m_diagonal;
+
+		// The element with the reduced integration (for the modulus of
+		// elasticity of the mesh)
+		bool m_isReduced = false;
+		ReducedElement m_reducedElement;
+
+		// The degrees of freedom with the conditions of symmetry, their
+		// diagonal is multiplied by STATIC_SIMMETRY
+		std::vector<UnsignedType> m_penaltyDofs;
+
+	};
+
+	// The displacements of the static problem with the load on the front
+	// face, the stiffness matrix is not stored (MeshStiffnessOperator)
+	MFE_LIB_EXPORT IterativeSolution calculateDispStaticMatrixFree(
+		const HexMesh& mesh, const Real& initialForce,
+		const IterativeSolverOptions& options = IterativeSolverOptions(),
+		const UnsignedType& threadsCount = 0);
+}
+
+#endif
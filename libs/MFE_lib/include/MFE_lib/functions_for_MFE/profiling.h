@@ -0,0 +1,148 @@
+// This file is used in the dinamic_solver files and in the applications.
+// This file contains the profiling of the runs: the time of the sections of
+// the calculation (assembly of the matrices, symmetry conditions, forces,
+// linear solve, update of the state, output) and the counters of the steps.
+// The time of a section is exclusive: the time of the nested section is not
+// added to the outer one, so the sum of the sections is the time of the run.
+//
+// The profiling is compiled only with the option MFE_LIB_ENABLE_PROFILING
+// of cmake, otherwise the macros are empty and the report of the run is
+// empty (isEnabled = false). The report is kept for each thread, so the runs
+// of different threads do not mix.
+
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <array>
+#include <chrono>
+#include <string>
+
+#include <MFE_lib/types/types.h>
+#include <MFE_lib/export.h>
+
+namespace MFE
+{
+	enum ProfileSection
+	{
+		PROFILE_OTHER,
+		PROFILE_ASSEMBLY,
+		PROFILE_CONDITIONS,
+		PROFILE_FORCE,
+		PROFILE_SOLVE,
+		PROFILE_UPDATE,
+		PROFILE_OUTPUT,
+		PROFILE_SECTIONS_COUNT,
+	};
+
+	// PROFILE_SOLVER_ITERATIONS - the iterations of the iterative linear
+	// solvers (the direct solvers count only PROFILE_LINEAR_SOLVES)
+	enum ProfileCounter
+	{
+		PROFILE_STEPS,
+		PROFILE_STUCK_STEPS,
+		PROFILE_SLIDING_STEPS,
+		PROFILE_LINEAR_SOLVES,
+		PROFILE_SOLVER_ITERATIONS,
+		PROFILE_COUNTERS_COUNT,
+	};
+
+	// The report of a run: the time (seconds) and the number of entries of
+	// the sections, the counters
+	struct MFE_LIB_EXPORT RunProfile
+	{
+		std::string name;
+		bool isEnabled = false;
+		Real totalTime = 0.0;
+		std::array<Real, PROFILE_SECTIONS_COUNT> sectionTime{};
+		std::array<UnsignedType, PROFILE_SECTIONS_COUNT> sectionCalls{};
+		std::array<UnsignedType, PROFILE_COUNTERS_COUNT> counters{};
+	};
+
+	// The run of the thread: the report is started by the outer run (the
+	// nested runs are a part of it) and is kept when the outer run ends.
+	// If reportFile is not empty, the report is written to it in JSON.
+	class MFE_LIB_EXPORT ProfileRun
+	{
+	public:
+
+		explicit ProfileRun(const std::string& name,
+			const std::string& reportFile = "");
+
+		~ProfileRun();
+
+		ProfileRun(const ProfileRun&) = delete;
+		ProfileRun& operator=(const ProfileRun&) = delete;
+
+	private:
+
+		bool m_isOuter = false;
+		std::string m_reportFile;
+		std::chrono::steady_clock::time_point m_start;
+
+	};
+
+	// The section of the scope: the time is added to the section until the
+	// end of the scope, then the previous section continues
+	class MFE_LIB_EXPORT ProfileTimer
+	{
+	public:
+
+		explicit ProfileTimer(const ProfileSection& section);
+
+		~ProfileTimer();
+
+		// Switching to the next section (the sections of the time loop
+		// without nested scopes)
+		void next(const ProfileSection& section);
+
+		ProfileTimer(const ProfileTimer&) = delete;
+		ProfileTimer& operator=(const ProfileTimer&) = delete;
+
+	private:
+
+		ProfileSection m_previous = PROFILE_OTHER;
+
+	};
+
+	// Adding the value to the counter of the run of the thread
+	MFE_LIB_EXPORT void addProfileCount(const ProfileCounter& counter,
+		const UnsignedType& value = 1);
+
+	// true if the library is built with MFE_LIB_ENABLE_PROFILING
+	MFE_LIB_EXPORT bool isProfilingEnabled();
+
+	// The report of the last finished run of the calling thread
+	MFE_LIB_EXPORT RunProfile getLastRunProfile();
+
+	MFE_LIB_EXPORT std::string getSectionName(const ProfileSection& section);
+
+	MFE_LIB_EXPORT std::string getCounterName(const ProfileCounter& counter);
+
+	// The report in JSON
+	MFE_LIB_EXPORT std::string formatProfileJson(const RunProfile& profile);
+
+	MFE_LIB_EXPORT bool writeProfileJson(const RunProfile& profile,
+		const std::string& fileName);
+
+}
+
+#define MFE_PROFILE_CONCAT_INNER(left, right) left##right
+#define MFE_PROFILE_CONCAT(left, right) MFE_PROFILE_CONCAT_INNER(left, right)
+
+#ifdef MFE_LIB_ENABLE_PROFILING
+	#define MFE_PROFILE_RUN(name, reportFile) \
+		MFE::ProfileRun MFE_PROFILE_CONCAT(profileRun, __LINE__)(name, reportFile)
+	#define MFE_PROFILE_SCOPE(section) \
+		MFE::ProfileTimer MFE_PROFILE_CONCAT(profileTimer, __LINE__)(section)
+	#define MFE_PROFILE_LAP(timer, section) MFE::ProfileTimer timer(section)
+	#define MFE_PROFILE_NEXT(timer, section) timer.next(section)
+	#define MFE_PROFILE_COUNT(counter, value) MFE::addProfileCount(counter, value)
+#else
+	#define MFE_PROFILE_RUN(name, reportFile) ((void)0)
+	#define MFE_PROFILE_SCOPE(section) ((void)0)
+	#define MFE_PROFILE_LAP(timer, section) ((void)0)
+	#define MFE_PROFILE_NEXT(timer, section) ((void)0)
+	#define MFE_PROFILE_COUNT(counter, value) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,136 @@
+// This file is used in the matrix_MFE files.
+// This file contains the tables of the reference 8-node brick element, which
+// are calculated at compile time: the local coordinates of the nodes, the
+// Gauss points (2 x 2 x 2, the weights are 1), the derivatives of the shape
+// functions at the Gauss points and the reference blocks of the stiffness
+// matrix. For the rectangular brick the derivative of the shape function of
+// node i by the direction d at the Gauss point g is
+// REFERENCE_DERIVATIVES[g][i][d] / dimension[d], so the stiffness matrix is
+// obtained from the reference blocks by the dimensions and the elastic
+// constants (makeMatrixStiffness).
+
+#ifndef REFERENCE_ELEMENT_H
+#define REFERENCE_ELEMENT_H
+
+#include <array>
+
+#include <MFE_lib/functions_for_MFE/matrix_MFE.h>
+
+namespace MFE
+{
+	constexpr UnsignedType ELEMENT_NODES_COUNT = 8;
+	constexpr UnsignedType ELEMENT_DIMENSIONS_COUNT = 3;
+	constexpr UnsignedType ELEMENT_DOF_COUNT =
+		ELEMENT_NODES_COUNT * ELEMENT_DIMENSIONS_COUNT;
+	constexpr UnsignedType GAUSS_POINTS_COUNT = 8;
+
+	// The coordinate of the Gauss points: sqrt(3) / 3
+	constexpr Real GAUSS_POINT_COORDINATE = 0.57735026918962576451;
+
+	using ElementNodesTable = std::array<Array3D, ELEMENT_NODES_COUNT>;
+
+	// [Gauss point][node][direction]
+	using ReferenceDerivatives =
+		std::array<ElementNodesTable, GAUSS_POINTS_COUNT>;
+
+	// [node i][node j][direction d][direction e]
+	using ReferenceBlocks = std::array<std::array<
+		std::array<Array3D, ELEMENT_DIMENSIONS_COUNT>, ELEMENT_NODES_COUNT>,
+		ELEMENT_NODES_COUNT>;
+
+	// The local coordinates (ksi, etta, psi) of the nodes, the same as the
+	// columns of getLocalCoordinate
+	constexpr ElementNodesTable REFERENCE_NODES = { {
+		{ 1.0, -1.0, -1.0 }, { 1.0, 1.0, -1.0 },
+		{ -1.0, 1.0, -1.0 }, { -1.0, -1.0, -1.0 },
+		{ 1.0, -1.0, 1.0 }, { 1.0, 1.0, 1.0 },
+		{ -1.0, 1.0, 1.0 }, { -1.0, -1.0, 1.0 } } };
+
+	// The Gauss points are in the order of the nodes
+	constexpr ElementNodesTable makeGaussPoints()
+	{
+		ElementNodesTable points{};
+		for (UnsignedType pointNum = 0; pointNum < GAUSS_POINTS_COUNT; ++pointNum)
+		{
+			for (UnsignedType dimension = 0; dimension < ELEMENT_DIMENSIONS_COUNT;
+				++dimension)
+			{
+				points[pointNum][dimension] =
+					GAUSS_POINT_COORDINATE * REFERENCE_NODES[pointNum][dimension];
+			}
+		}
+		return points;
+	}
+
+	constexpr ElementNodesTable GAUSS_POINTS = makeGaussPoints();
+
+	// The derivative of the shape function of the node by the direction
+	// multiplied by the dimension of the element in this direction
+	// (dShapeFuncKsi, dShapeFuncEtta, dShapeFuncPsi multiplied by the length,
+	// the width and the heigth)
+	constexpr ReferenceDerivatives makeReferenceDerivatives()
+	{
+		ReferenceDerivatives derivatives{};
+		for (UnsignedType pointNum = 0; pointNum < GAUSS_POINTS_COUNT; ++pointNum)
+		{
+			for (UnsignedType node = 0; node < ELEMENT_NODES_COUNT; ++node)
+			{
+				const Array3D& local = REFERENCE_NODES[node];
+				const Array3D& point = GAUSS_POINTS[pointNum];
+				for (UnsignedType dimension = 0; dimension < ELEMENT_DIMENSIONS_COUNT;
+					++dimension)
+				{
+					Real derivative = 1.0 / 4.0 * local[dimension];
+					for (UnsignedType other = 0; other < ELEMENT_DIMENSIONS_COUNT; ++other)
+					{
+						if (other != dimension)
+							derivative *= 1.0 + local[other] * point[other];
+					}
+					derivatives[pointNum][node][dimension] = derivative;
+				}
+			}
+		}
+		return derivatives;
+	}
+
+	constexpr ReferenceDerivatives REFERENCE_DERIVATIVES = makeReferenceDerivatives();
+
+	// The sums by the Gauss points of the products of the derivatives:
+	// blocks[i][j][d][e] = sum(REFERENCE_DERIVATIVES[g][i][d] *
+	// REFERENCE_DERIVATIVES[g][j][e])
+	constexpr ReferenceBlocks makeReferenceBlocks()
+	{
+		ReferenceBlocks blocks{};
+		for (UnsignedType nodeFirst = 0; nodeFirst < ELEMENT_NODES_COUNT; ++nodeFirst)
+		{
+			for (UnsignedType nodeSecond = 0; nodeSecond < ELEMENT_NODES_COUNT;
+				++nodeSecond)
+			{
+				for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+					++dimFirst)
+				{
+					for (UnsignedType dimSecond = 0;
+						dimSecond < ELEMENT_DIMENSIONS_COUNT; ++dimSecond)
+					{
+						Real sum = 0.0;
+						for (UnsignedType pointNum = 0; pointNum < GAUSS_POINTS_COUNT;
+							++pointNum)
+						{
+							sum += REFERENCE_DERIVATIVES[pointNum][nodeFirst][dimFirst] *
+								REFERENCE_DERIVATIVES[pointNum][nodeSecond][dimSecond];
+						}
+						blocks[nodeFirst][nodeSecond][dimFirst][dimSecond] = sum;
+					}
+				}
+			}
+		}
+		return blocks;
+	}
+
+	constexpr ReferenceBlocks REFERENCE_BLOCKS = makeReferenceBlocks();
+
+	static_assert(REFERENCE_DERIVATIVES[0][0][0] > 0.0,
+		"The reference derivatives are not calculated at compile time");
+}
+
+#endif
@@ -0,0 +1,228 @@
+// This file is used in the dinamic_solver files.
+// This file contains the sinks of the results of the dynamic problem. The
+// solvers do not keep the history of displacements: the displacements of
+// each step are passed to the sink, which decides what to keep (all steps
+// in memory, selected degrees of freedom in a text file, every k-th step).
+// Thus the memory of the solver does not depend on the number of steps.
+
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <MFE_lib/types/matrix_type.h>
+#include <MFE_lib/active_indices.h>
+#include <MFE_lib/write_functions.h>
+
+namespace MFE
+{
+	// The header of the results:
+	// deltaT - the time step;
+	// stepsCount - the expected number of steps (the calculation can stop
+	// earlier if the values go to infinity);
+	// firstStep - the number of the first step (not 0 if the run is
+	// continued from a checkpoint);
+	// dofCount - the number of degrees of freedom (after the symmetry
+	// conditions), the size of the displacement vector of a step.
+	struct MFE_LIB_EXPORT SinkHeader
+	{
+		Real deltaT = 0.0;
+		UnsignedType stepsCount = 0;
+		UnsignedType dofCount = 0;
+		UnsignedType firstStep = 0;
+	};
+
+	// The interface of the sink. The solver calls begin once, then record
+	// for the steps in ascending order, then end (also when the calculation
+	// stops early).
+	// isStuck - the step is obtained by sticking (the displacements did not
+	// change).
+	class MFE_LIB_EXPORT ResultSink
+	{
+	public:
+
+		virtual ~ResultSink() = default;
+
+		virtual void begin(const SinkHeader& header) = 0;
+
+		virtual void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) = 0;
+
+		virtual void end() = 0;
+
+	};
+
+	// The sink that keeps all recorded steps in memory, the rows of the
+	// displacement matrix are the recorded steps.
+	class MFE_LIB_EXPORT MemorySink : public ResultSink
+	{
+	public:
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+		const RealMatrix& getDisplacements() const;
+
+		// The numbers of the recorded steps
+		const std::vector<UnsignedType>& getSteps() const;
+
+		const SinkHeader& getHeader() const;
+
+	private:
+
+		SinkHeader m_header;
+		RealMatrix m_displacements;
+		std::vector<UnsignedType> m_steps;
+
+	};
+
+	// The sink that writes the displacements of the degrees of freedom
+	// "indices" to the text file, one line per step. The format is the same
+	// as in write_functions: the value for one degree of freedom,
+	// "index: value" separated by two spaces for several.
+	class MFE_LIB_EXPORT TextFileSink : public ResultSink
+	{
+	public:
+
+		explicit TextFileSink(const std::string& fileName,
+			const std::vector<UnsignedType>& indices =
+			std::vector<UnsignedType>(ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()));
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+		// false if the file was not opened or not all steps were written
+		bool isWritten() const;
+
+	private:
+
+		std::string m_fileName;
+		std::vector<UnsignedType> m_indices;
+		std::unique_ptr<TextWriter> m_writer;
+		bool m_isWritten = false;
+
+	};
+
+	// The sink that writes the time and the degrees of freedom "indices" to
+	// one CSV/TSV file (ChannelsWriter), the values with the shortest
+	// representation that is read back exactly.
+	class MFE_LIB_EXPORT ChannelsFileSink : public ResultSink
+	{
+	public:
+
+		explicit ChannelsFileSink(const std::string& fileName,
+			const std::vector<UnsignedType>& indices =
+			std::vector<UnsignedType>(ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()),
+			const TextLayout& layout = TEXT_LAYOUT_CSV);
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+		// false if the file was not opened or not all steps were written
+		bool isWritten() const;
+
+	private:
+
+		std::string m_fileName;
+		std::vector<UnsignedType> m_indices;
+		TextLayout m_layout = TEXT_LAYOUT_CSV;
+		std::unique_ptr<ChannelsWriter> m_writer;
+		Real m_deltaT = 0.0;
+		bool m_isWritten = false;
+
+	};
+
+	// The sink that passes the steps to several sinks (for example, to the
+	// file and to the series of the graph in one calculation)
+	class MFE_LIB_EXPORT SplitSink : public ResultSink
+	{
+	public:
+
+		explicit SplitSink(const std::vector<ResultSink*>& sinks);
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+	private:
+
+		std::vector<ResultSink*> m_sinks;
+
+	};
+
+	// The selection of every "stride"-th step counting from the first step
+	// and of the last step (the end of the motion is not lost). The steps
+	// are passed in ascending order; the step that is not selected is kept
+	// by the user as the last one until the next selected step.
+	class MFE_LIB_EXPORT StrideSelection
+	{
+	public:
+
+		explicit StrideSelection(const UnsignedType& stride = 1);
+
+		void begin(const UnsignedType& firstStep);
+
+		// true - the step is selected, false - it is the last step so far
+		bool select(const UnsignedType& step);
+
+		// The last step was not selected and must be added at the end
+		bool hasLast() const;
+
+		// The number of the selected steps of stepsCount steps
+		UnsignedType getSelectedCount(const UnsignedType& stepsCount) const;
+
+	private:
+
+		UnsignedType m_stride = 1;
+		UnsignedType m_firstStep = 0;
+		bool m_hasLast = false;
+
+	};
+
+	// The sink that passes every "stride"-th step to the target sink, the
+	// last step is always passed (StrideSelection).
+	class MFE_LIB_EXPORT DecimatingSink : public ResultSink
+	{
+	public:
+
+		DecimatingSink(ResultSink& target, const UnsignedType& stride);
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+	private:
+
+		ResultSink& m_target;
+		StrideSelection m_selection;
+
+		// The last step, if it was not passed
+		UnsignedType m_lastStep = 0;
+		RealVector m_lastDisplacement;
+		bool m_isLastStuck = false;
+
+	};
+
+}
+
+#endif
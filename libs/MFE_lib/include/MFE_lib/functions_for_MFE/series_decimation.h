@@ -0,0 +1,150 @@
+// This file is used in the dinamic_solver files and in the applications.
+// This file contains the decimation of the history of one degree of freedom
+// for the graphs: the series of millions of steps is reduced to a few
+// thousand points while it is calculated (the full history is not stored).
+// Policies:
+// DECIMATION_ALL - all steps;
+// DECIMATION_STRIDE - every k-th step and the last step (StrideSelection);
+// DECIMATION_M4 - the first, the last, the minimum and the maximum of each
+// bucket of steps (the peaks are not lost);
+// DECIMATION_LTTB - "Largest Triangle Three Buckets": one point per bucket,
+// which forms the largest triangle with the previous selected point and the
+// average of the next bucket (the shape of the curve is kept).
+
+#ifndef SERIES_DECIMATION_H
+#define SERIES_DECIMATION_H
+
+#include <MFE_lib/functions_for_MFE/result_sink.h>
+
+namespace MFE
+{
+	// The number of points of the series by default
+	constexpr UnsignedType POINTS_COUNT_DEFAULT = 4000;
+
+	enum DecimationPolicy
+	{
+		DECIMATION_ALL,
+		DECIMATION_STRIDE,
+		DECIMATION_M4,
+		DECIMATION_LTTB,
+	};
+
+	// The series for the graph: the time of the points and the values
+	struct MFE_LIB_EXPORT PlotSeries
+	{
+		RealVector time;
+		RealVector values;
+	};
+
+	// Decimation of the series step by step. The steps are added in
+	// ascending order; stepsCount is the expected number of steps, by which
+	// the size of the buckets is calculated (0 - unknown, all steps are kept);
+	// firstStep - the number of the first step.
+	// The memory does not depend on the number of steps: the series itself
+	// (about pointsCount points) and, for LTTB, two buckets of values.
+	class MFE_LIB_EXPORT SeriesDecimator
+	{
+	public:
+
+		explicit SeriesDecimator(const DecimationPolicy& policy = DECIMATION_M4,
+			const UnsignedType& pointsCount = POINTS_COUNT_DEFAULT);
+
+		void begin(const UnsignedType& stepsCount, const Real& deltaT,
+			const UnsignedType& firstStep = 0);
+
+		void add(const UnsignedType& step, const Real& value);
+
+		// The incomplete buckets and the last step are added to the series
+		void end();
+
+		const PlotSeries& getSeries() const;
+
+	private:
+
+		struct Point
+		{
+			UnsignedType step = 0;
+			Real value = 0.0;
+		};
+
+		void addPoint(const Point& point);
+
+		UnsignedType getBucket(const UnsignedType& step) const;
+
+		void addStride(const Point& point);
+
+		void addM4(const Point& point);
+		void flushM4();
+
+		void addLTTB(const Point& point);
+		void selectLTTB(const std::vector<Point>& bucket, const Real& stepNext,
+			const Real& valueNext);
+
+		DecimationPolicy m_policy = DECIMATION_M4;
+		UnsignedType m_pointsCount = POINTS_COUNT_DEFAULT;
+
+		PlotSeries m_series;
+		Real m_deltaT = 0.0;
+		UnsignedType m_stepsCount = 0;
+		UnsignedType m_firstStep = 0;
+		bool m_isAll = true;
+
+		// The steps of DECIMATION_STRIDE, the number of buckets of M4 and LTTB
+		StrideSelection m_selection;
+		UnsignedType m_bucketsCount = 0;
+
+		// The last added point of DECIMATION_STRIDE, if it is not in the series
+		Point m_last;
+
+		// The current bucket of M4
+		UnsignedType m_bucket = 0;
+		bool m_isBucketEmpty = true;
+		Point m_first;
+		Point m_min;
+		Point m_max;
+
+		// The buckets of LTTB: the point is selected from the previous bucket
+		// when the current bucket is filled
+		Point m_selected;
+		bool m_hasSelected = false;
+		std::vector<Point> m_bucketPrevious;
+		std::vector<Point> m_bucketCurrent;
+		UnsignedType m_bucketCurrentNum = 0;
+
+	};
+
+	// The sink that keeps the decimated series of the degree of freedom
+	// "index" (node 2 in the direction of movement by default)
+	class MFE_LIB_EXPORT SeriesSink : public ResultSink
+	{
+	public:
+
+		explicit SeriesSink(const DecimationPolicy& policy = DECIMATION_M4,
+			const UnsignedType& pointsCount = POINTS_COUNT_DEFAULT,
+			const UnsignedType& index = ACTIVE_INDICES[1]);
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+		const PlotSeries& getSeries() const;
+
+	private:
+
+		SeriesDecimator m_decimator;
+		UnsignedType m_index = 0;
+
+	};
+
+	// Decimation of the already calculated values of the steps
+	// (for example, getDispSecondNode)
+	MFE_LIB_EXPORT PlotSeries decimateSeries(const RealVector& values,
+		const Real& deltaT, const DecimationPolicy& policy = DECIMATION_M4,
+		const UnsignedType& pointsCount = POINTS_COUNT_DEFAULT);
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+// This file is used in the dinamic_solver files.
+// This file contains the configuration of one simulation of the dynamic
+// problem: the finite element, the time, the initial conditions, the friction
+// mode with its parameters and the time integrator. The configuration is
+// filled either from a scenario file (one or many scenarios per file) or
+// interactively from the console, the solvers do not read the console.
+//
+// Scenario file format:
+// # comment
+// [name of the scenario]
+// key = value
+// A comment is a whole line that starts with '#', the '#' characters in
+// the names and in the values are kept (for example, outputFile = out#1.txt).
+// The keys are the names of the fields of SimulationConfig and FiniteElement
+// (for example: frictionMode = 2, deltaT = 1e-7, dencity = 2700).
+// The values that are not set are taken from makeDefaultConfig for the
+// friction mode of the scenario. integrationScheme is set by the name:
+// newmark, hht_alpha, generalized_alpha.
+
+#ifndef SIMULATION_CONFIG_H
+#define SIMULATION_CONFIG_H
+
+#include <string>
+#include <vector>
+
+#include <MFE_lib/functions_for_MFE/matrix_MFE.h>
+#include <MFE_lib/functions_for_MFE/solver_utils.h>
+#include <MFE_lib/functions_for_MFE/time_integrator.h>
+
+namespace MFE
+{
+	// The problems of the dynamic solver (the numbers are the same as in the
+	// choice of the problem in getFrictionMode)
+	enum FrictionMode
+	{
+		FRICTION_DRY_FREE = 1,
+		FRICTION_DRY_DRIVE = 2,
+		FRICTION_VISCOUS_DRIVE = 3,
+	};
+
+	// Configuration of the simulation, the fields that are not used by the
+	// friction mode are ignored:
+	// time, deltaT - the oscillation time and the time step;
+	// initialStaticLoad - the static load on the edge for the initial
+	// displacements (0 - zero initial displacements);
+	// frequencyCoeff - the coefficient before PI in the frequency of the
+	// driving force;
+	// normalReaction - the normal reaction to one degree of freedom;
+	// outputFile - the file of the displacements of the batch runner
+	// (empty - "<name>_displacements.txt");
+	// checkpointFile, checkpointInterval - the file, to which the state of
+	// the solver is written every checkpointInterval steps and at the end of
+	// the run (0 - only at the end, empty file - no checkpoints);
+	// restartFile - the checkpoint, from which the run is continued (empty -
+	// the run starts from t = 0), the time can be greater than the time of
+	// the run of the checkpoint;
+	// profileFile - the file of the report of the profiling of the run in
+	// JSON (empty - not written; the library must be built with
+	// MFE_LIB_ENABLE_PROFILING, profiling.h).
+	struct MFE_LIB_EXPORT SimulationConfig
+	{
+		std::string name = "scenario";
+		FiniteElement finiteElement;
+
+		Real time = 0.0;
+		Real deltaT = 0.0;
+
+		Real initialStaticLoad = 0.0;
+		Real initialAcceleration = 0.0;
+		Real initialSpeed = 0.0;
+
+		FrictionMode frictionMode = FRICTION_DRY_FREE;
+		Real coeffDryFrictionRest = 0.0;
+		Real coeffDryFrictionSliding = 0.0;
+		Real coeffViscousFriction = 0.0;
+		Real normalReaction = NORMAL_REACTION_FREE;
+
+		Real frequencyCoeff = FREQUENCY_COEFF_DRY;
+		Real amplitudeForce = AMPLITUDE_FORCE_DRY;
+
+		IntegrationScheme integrationScheme = INTEGRATION_NEWMARK;
+		Real spectralRadius = SPECTRAL_RADIUS_DEFAULT;
+
+		std::string outputFile = "";
+
+		std::string checkpointFile = "";
+		UnsignedType checkpointInterval = 0;
+		std::string restartFile = "";
+
+		std::string profileFile = "";
+	};
+
+	// The configuration with the default values of the driving force and
+	// the normal reaction for the friction mode (as in the console prompts)
+	MFE_LIB_EXPORT SimulationConfig makeDefaultConfig(const FrictionMode& frictionMode);
+
+	// Checking the configuration, an exception is thrown if the values
+	// are incorrect
+	MFE_LIB_EXPORT void validateConfig(const SimulationConfig& config);
+
+	// The frequency of the driving force (rad/s) of the configuration
+	MFE_LIB_EXPORT Real getFrequencyForce(const SimulationConfig& config);
+
+	// The parameters of the time integrator of the configuration
+	MFE_LIB_EXPORT IntegratorParameters getIntegratorParameters(
+		const SimulationConfig& config);
+
+	// Reading the scenarios from the file, the scenarios are checked by
+	// validateConfig. An exception is thrown with the line number if the file
+	// is written incorrectly.
+	MFE_LIB_EXPORT std::vector<SimulationConfig> readScenarioFile(
+		const std::string& fileName);
+
+	// Reading the scenarios from a stream (the format of the scenario file)
+	MFE_LIB_EXPORT std::vector<SimulationConfig> readScenarios(std::istream& input);
+
+	// Writing the configuration to a stream in the format of the scenario
+	// file (all keys, the values with full precision), readScenarios gets
+	// the same configuration back
+	MFE_LIB_EXPORT void writeScenario(std::ostream& output,
+		const SimulationConfig& config);
+
+	// The console front end: the finite element, the time, the time step and
+	// the parameters of the solver are entered in the same order as before
+	MFE_LIB_EXPORT SimulationConfig inputSimulationConfig();
+
+	// Entering the initial conditions, the friction mode and the parameters
+	// of the solver from the console (time, deltaT and the finite element
+	// are not changed)
+	MFE_LIB_EXPORT void inputSolverParameters(SimulationConfig& config);
+
+}
+
+#endif
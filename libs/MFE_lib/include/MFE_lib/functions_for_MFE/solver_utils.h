@@ -12,6 +12,12 @@ namespace MFE
 	constexpr Real PI = 3.14159265358979323846;
 	constexpr Real NORMAL_REACTION_FREE = 400.0;
 	constexpr Real NORMAL_REACTION_DRIVE = 100.0;
+	// Default amplitudes of the driving force acting on the final element and
+	// coefficients before PI in the frequency of the driving force
+	constexpr Real AMPLITUDE_FORCE_DRY = 300.0;
+	constexpr Real AMPLITUDE_FORCE_VISCOUS = 220.0;
+	constexpr Real FREQUENCY_COEFF_DRY = 40.0;
+	constexpr Real FREQUENCY_COEFF_VISCOUS = 2.0;
 	constexpr Real EPS = 1.0e-4;
 	constexpr bool HAS_DRIVE_FORCE_DRY = true;
 	constexpr bool NO_DRIVE_FORCE_DRY = !HAS_DRIVE_FORCE_DRY;
@@ -48,6 +54,10 @@ namespace MFE
 	// For dry, the default is 40 * PI, for viscous 2 * PI
 	MFE_LIB_EXPORT Real getFrequencyForce(const bool& isDriveForceDry);
 
+	// The function of obtaining the coefficient before PI in the frequency of
+	// the driving force (the choice of getFrequencyForce).
+	MFE_LIB_EXPORT Real inputFrequencyCoeff(const bool& isDriveForceDry);
+
 	// The function choice of the solver depending on the friction: 1 - dry friction 
 	// without a driving force; 2 - dry friction with a driving force;
 	// 3 - viscous friction with a driving force.
@@ -62,9 +72,14 @@ namespace MFE
 	// is dry friction without forcing or dry friction with a forcing force.
 	// For friction without a driving force, the normal wall response is
 	// NORMAL_REACTION_FREE by default,
-	// with a driving force NORMAL_REACTION_DRIVE
+	// with a driving force NORMAL_REACTION_DRIVE.
+	// The function asks to change the default value on each call.
 	MFE_LIB_EXPORT Real getNormReaction(const bool& isDriveForce);
 
+	// The default normal reaction without the console: NORMAL_REACTION_DRIVE
+	// with a driving force, NORMAL_REACTION_FREE without it
+	MFE_LIB_EXPORT Real getNormReactionDefault(const bool& isDriveForce);
+
 	// The function returns the sign of the friction force in a problem with
 	// a driving force depending on the average velocity or, if the velocity is
 	// less than EPS, then on the direction of the resulting force projected on ksi.
@@ -77,10 +92,17 @@ namespace MFE
 	MFE_LIB_EXPORT Real getSignFrictionFree(const Real& elasticForce,
 		const Real& averagePointsSpeed);
 
-	// The function returns the total dry friction force across the nodes.
-	MFE_LIB_EXPORT Real getSumFrictionForce(const Real& signForce,
+	// The function returns the total dry friction force across the nodes
+	// for the default normal reaction (getNormReactionDefault).
+	MFE_LIB_EXPORT Real getSumFrictionForceDefault(const Real& signForce,
 		const Real& coeffDryFrictionRest, const Real& coeffDryFrictionSliding,
 		const Real& averagePointsSpeed, const bool& isDriveForce);
+
+	// The function returns the total dry friction force across the nodes
+	// for the given normal reaction to one degree of freedom.
+	MFE_LIB_EXPORT Real getSumFrictionForce(const Real& signForce,
+		const Real& coeffDryFrictionRest, const Real& coeffDryFrictionSliding,
+		const Real& averagePointsSpeed, const Real& normalReaction);
 	
 	// The function of obtaining a resultant force
 	MFE_LIB_EXPORT Real getResultantForce(const RealVector& force);
@@ -89,10 +111,15 @@ namespace MFE
 	MFE_LIB_EXPORT void setForceElastic(const RealVector& displacement,
 		const RealMatrix& matrixStiffness, RealVector& force);
 
-	// Setting the normal reaction at the nodes (corresponding to degrees of freedom)
+	// Setting the default normal reaction at the nodes (corresponding to
+	// degrees of freedom) affected by the normal reaction from the walls
+	MFE_LIB_EXPORT void setForceNormReactionDefault(RealVector& force,
+		const bool& isDriveForce);
+
+	// Setting the given normal reaction to one degree of freedom at the nodes
 	// affected by the normal reaction from the walls
 	MFE_LIB_EXPORT void setForceNormReaction(RealVector& force,
-		const bool& isDriveForce);
+		const Real& normalReaction);
 
 	// Setting the friction force at the nodes(degrees of freedom in the direction
 	// of motion) for the problem of dry friction without a driving force
@@ -0,0 +1,80 @@
+// This file is used in the dinamic_solver files.
+// This file contains the implicit time integrators of the generalized-alpha
+// family: the Newmark method (average acceleration, without numerical
+// damping), the HHT-alpha method and the generalized-alpha method. The last
+// two damp the high frequencies (stick-slip chatter), the damping is set by
+// the spectral radius at infinite frequency: 1 - no damping, 0 (0.5 for
+// HHT-alpha) - maximum damping.
+//
+// The equation of motion is balanced between the old and the new step:
+// (1 - alphaM) * M * a1 + alphaM * M * a0 + (1 - alphaF) * C * v1 +
+// alphaF * C * v0 + (1 - alphaF) * K * u1 + alphaF * K * u0 = F,
+// where F is the force model evaluated by the solver on the current step.
+
+#ifndef TIME_INTEGRATOR_H
+#define TIME_INTEGRATOR_H
+
+#include <MFE_lib/math_functions.h>
+
+namespace MFE
+{
+	// Coefficients that are present in the displacement equations.
+	// These values ensure high accuracy and stability of the solution when using
+	// the Newmark method.
+	constexpr Real ALPHA = 0.25;
+	constexpr Real DELTA = 0.5;
+
+	// Spectral radius at infinite frequency by default for the schemes
+	// with numerical damping
+	constexpr Real SPECTRAL_RADIUS_DEFAULT = 0.8;
+	// The lower limit of the spectral radius for the HHT-alpha method
+	constexpr Real MIN_SPECTRAL_RADIUS_HHT = 0.5;
+
+	enum IntegrationScheme
+	{
+		INTEGRATION_NEWMARK,
+		INTEGRATION_HHT_ALPHA,
+		INTEGRATION_GENERALIZED_ALPHA,
+	};
+
+	// Parameters of the integrator, by default - the Newmark method:
+	// alphaM, alphaF - weights of the old step in the inertial and the
+	// elastic (damping) forces;
+	// beta, gamma - Newmark coefficients (ALPHA and DELTA).
+	struct MFE_LIB_EXPORT IntegratorParameters
+	{
+		Real alphaM = 0.0;
+		Real alphaF = 0.0;
+		Real beta = ALPHA;
+		Real gamma = DELTA;
+	};
+
+	// Getting the parameters of the integrator by the scheme and the
+	// spectral radius at infinite frequency (not used for the Newmark method)
+	MFE_LIB_EXPORT IntegratorParameters makeIntegratorParameters(
+		const IntegrationScheme& scheme,
+		const Real& spectralRadius = SPECTRAL_RADIUS_DEFAULT);
+
+	// The matrix of coefficients of the step, it does not change between steps:
+	// (1 - alphaM) * M + (1 - alphaF) * gamma * deltaT * C +
+	// (1 - alphaF) * beta * deltaT^2 * K.
+	// matrixDamping can be empty (no damping).
+	MFE_LIB_EXPORT RealMatrix makeMatrixCoeffsIntegrator(
+		const IntegratorParameters& integrator, const Real& deltaT,
+		const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+		const RealMatrix& matrixDamping);
+
+	// One step of the integrator: the displacements of the new step are
+	// calculated by the reflection method, the speed and the acceleration
+	// are replaced by the values of the new step.
+	// matrixCoeffs - the result of makeMatrixCoeffsIntegrator.
+	MFE_LIB_EXPORT void stepIntegrator(const IntegratorParameters& integrator,
+		const Real& deltaT, const RealMatrix& matrixStiffness,
+		const RealMatrix& matrixMass, const RealMatrix& matrixDamping,
+		const RealMatrix& matrixCoeffs, const RealVector& force,
+		const RealVector& displacementOld, RealVector& displacementNew,
+		RealVector& speed, RealVector& acceleration);
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+// This file contains the driver for the uncertainty quantification of the
+// dynamic problem (Monte Carlo method). The properties of the finite element
+// and the coefficients of dry friction are sampled from the given
+// distributions by the Latin hypercube or the Sobol sequence, the samples
+// are calculated in parallel, and only the running statistics of the
+// response (peak displacement, stick fraction, settling time) are kept.
+
+#ifndef UNCERTAINTY_MFE_H
+#define UNCERTAINTY_MFE_H
+
+#include <cfloat>
+#include <functional>
+
+#include <MFE_lib/functions_for_MFE/dinamic_solver_MFE.h>
+#include <MFE_lib/active_indices.h>
+
+namespace MFE
+{
+	// The number of uncertain parameters: six fields of the FiniteElement
+	// and two coefficients of dry friction.
+	constexpr UnsignedType UNCERTAIN_PARAMETERS_COUNT = 8;
+
+	// The quantile of the normal distribution for the 95% confidence interval
+	constexpr Real CONFIDENCE_QUANTILE_95 = 1.959963984540054;
+
+	enum Distribution
+	{
+		DISTRIBUTION_UNIFORM,
+		DISTRIBUTION_NORMAL,
+		DISTRIBUTION_LOG_NORMAL,
+	};
+
+	enum SamplingMethod
+	{
+		SAMPLING_LATIN_HYPERCUBE,
+		SAMPLING_SOBOL,
+	};
+
+	// Distribution of the uncertain parameter:
+	// uniform - "first" is the minimum, "second" is the maximum;
+	// normal - "first" is the mean, "second" is the standard deviation;
+	// log-normal - "first" and "second" are the mean and the standard
+	// deviation of the logarithm of the value.
+	// A fixed value is a uniform distribution with first == second.
+	struct MFE_LIB_EXPORT UncertainParameter
+	{
+		Distribution distribution = DISTRIBUTION_UNIFORM;
+		Real first = 0.0;
+		Real second = 0.0;
+	};
+
+	// Distributions of all uncertain parameters, by default all of them are
+	// fixed to the default values of the FiniteElement structure and
+	// the coefficients of dry friction 0.5 (rest) and 0.3 (sliding).
+	struct MFE_LIB_EXPORT UncertaintyInput
+	{
+		UncertainParameter modulusElastic{ DISTRIBUTION_UNIFORM, 7e10, 7e10 };
+		UncertainParameter poissonRatio{ DISTRIBUTION_UNIFORM, 0.33, 0.33 };
+		UncertainParameter dencity{ DISTRIBUTION_UNIFORM, 2700.0, 2700.0 };
+		UncertainParameter length{ DISTRIBUTION_UNIFORM, 0.10, 0.10 };
+		UncertainParameter width{ DISTRIBUTION_UNIFORM, 0.06, 0.06 };
+		UncertainParameter heigth{ DISTRIBUTION_UNIFORM, 0.05, 0.05 };
+		UncertainParameter coeffDryFrictionRest{ DISTRIBUTION_UNIFORM, 0.5, 0.5 };
+		UncertainParameter coeffDryFrictionSliding{ DISTRIBUTION_UNIFORM, 0.3, 0.3 };
+	};
+
+	// One realization of the uncertain parameters
+	struct MFE_LIB_EXPORT UncertaintySample
+	{
+		FiniteElement finiteElement;
+		Real coeffDryFrictionRest = 0.5;
+		Real coeffDryFrictionSliding = 0.3;
+	};
+
+	// The response of one calculation:
+	// peakDisplacement - the maximum modulus of the displacement of the
+	// active degrees of freedom;
+	// stickFraction - the fraction of time steps at which the element sticks;
+	// settlingTime - the time of the last sliding step.
+	struct MFE_LIB_EXPORT SampleResponse
+	{
+		Real peakDisplacement = 0.0;
+		Real stickFraction = 0.0;
+		Real settlingTime = 0.0;
+	};
+
+	// The calculation of one sample. It is called from several threads at
+	// once, so it must not use a shared state.
+	using SampleModel = std::function<SampleResponse(const UncertaintySample&)>;
+
+	// Settings of the driver:
+	// maxSamples - the maximum number of samples;
+	// batchSize - the number of samples calculated in parallel between
+	// the convergence checks;
+	// threadsCount - the number of threads (0 - by the number of cores);
+	// minSamples - the number of samples before the first convergence check;
+	// relativeHalfWidth - the required half-width of the confidence interval
+	// relative to the mean value (for all statistics of the response);
+	// absoluteHalfWidth - the half-width that is enough whatever the mean
+	// value is (the statistic with the mean value about 0 converges by it),
+	// the statistic is converged if the half-width is not greater than
+	// max(relativeHalfWidth * |mean|, absoluteHalfWidth);
+	// confidenceQuantile - the quantile of the normal distribution;
+	// seed - the seed of the random generator.
+	struct MFE_LIB_EXPORT UncertaintySettings
+	{
+		SamplingMethod samplingMethod = SAMPLING_LATIN_HYPERCUBE;
+		UnsignedType maxSamples = 1000;
+		UnsignedType batchSize = 64;
+		UnsignedType threadsCount = 0;
+		UnsignedType minSamples = 32;
+		Real relativeHalfWidth = 0.01;
+		Real absoluteHalfWidth = DBL_EPSILON;
+		Real confidenceQuantile = CONFIDENCE_QUANTILE_95;
+		unsigned long long seed = 1;
+	};
+
+	// Running statistics (Welford's algorithm): the values themselves
+	// are not stored.
+	class MFE_LIB_EXPORT RunningStatistics
+	{
+	public:
+
+		void add(const Real& value);
+
+		void merge(const RunningStatistics& other);
+
+		UnsignedType count() const;
+
+		Real mean() const;
+
+		Real variance() const;
+
+		Real standardDeviation() const;
+
+		Real min() const;
+
+		Real max() const;
+
+		// The half-width of the confidence interval of the mean value
+		Real halfWidth(const Real& confidenceQuantile) const;
+
+	private:
+
+		UnsignedType m_count = 0;
+		Real m_mean = 0.0;
+		Real m_sumSquares = 0.0;
+		Real m_min = 0.0;
+		Real m_max = 0.0;
+
+	};
+
+	// Accumulation of the response of one calculation step by step: the
+	// history of displacements is not stored. isStuck - the state of the
+	// knot in which the displacements of the step were reached (as the
+	// solver passes it to ResultSink::record).
+	class MFE_LIB_EXPORT ResponseAccumulator
+	{
+	public:
+
+		explicit ResponseAccumulator(const Real& deltaT);
+
+		void addStep(const RealVector& displacement, const bool& isStuck);
+
+		SampleResponse getResponse() const;
+
+	private:
+
+		Real m_deltaT = 0.0;
+		UnsignedType m_steps = 0;
+		UnsignedType m_stuckSteps = 0;
+		UnsignedType m_lastSlidingStep = 0;
+		Real m_peakDisplacement = 0.0;
+
+	};
+
+	// The sink of the dynamic solver that accumulates the response of the
+	// calculation without storing the displacements of the steps
+	class MFE_LIB_EXPORT ResponseSink : public ResultSink
+	{
+	public:
+
+		void begin(const SinkHeader& header) override;
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override;
+
+		void end() override;
+
+		SampleResponse getResponse() const;
+
+	private:
+
+		ResponseAccumulator m_accumulator = ResponseAccumulator(0.0);
+
+	};
+
+	struct MFE_LIB_EXPORT UncertaintyResult
+	{
+		RunningStatistics peakDisplacement;
+		RunningStatistics stickFraction;
+		RunningStatistics settlingTime;
+		UnsignedType samplesCount = 0;
+		bool isConverged = false;
+	};
+
+	// Getting the response from the displacement matrix of the dynamic problem
+	// (the state of the knot is not stored in it: the step is considered
+	// stuck if the displacements did not change during it)
+	MFE_LIB_EXPORT SampleResponse getSampleResponse(const RealMatrix& displacements,
+		const Real& deltaT);
+
+	// Generation of "count" samples starting from the number "first".
+	// The Latin hypercube is built on the "count" samples themselves (the
+	// "first" number only changes the random generator), the Sobol sequence
+	// continues from the point "first".
+	MFE_LIB_EXPORT std::vector<UncertaintySample> makeSamples(
+		const UncertaintyInput& input, const SamplingMethod& samplingMethod,
+		const UnsignedType& first, const UnsignedType& count,
+		const unsigned long long& seed);
+
+	// The Monte Carlo driver: the samples are calculated by batches in
+	// parallel, after each batch the statistics are updated and the calculation
+	// stops if the confidence intervals have reached the required width.
+	MFE_LIB_EXPORT UncertaintyResult runUncertainty(const UncertaintyInput& input,
+		const UncertaintySettings& settings, const SampleModel& model);
+
+	// The configuration of the sample: the finite element and the
+	// coefficients of dry friction of the sample, the rest from "config"
+	MFE_LIB_EXPORT SimulationConfig makeSampleConfig(const SimulationConfig& config,
+		const UncertaintySample& sample);
+
+	// The Monte Carlo driver for the dynamic solver: each sample is calculated
+	// by runSimulation with the configuration of the sample
+	// (makeSampleConfig) into ResponseSink, the runs of the samples do not
+	// share a state and do not store the displacements of the steps.
+	MFE_LIB_EXPORT UncertaintyResult runUncertainty(const SimulationConfig& config,
+		const UncertaintyInput& input, const UncertaintySettings& settings);
+
+}
+
+#endif
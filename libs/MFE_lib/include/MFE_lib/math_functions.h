@@ -1,8 +1,8 @@
 // This file is used in the initial_conditions files and indirectly in the
 // files dinamic_solver.
 // This file contains mathematical functions : creating a Cholesky matrix for
-// solving a static problem, transposing, and solving by the Gauss method with
-// the choice of a leading element.
+// solving a static problem, transposing, solving by the Gauss method with
+// the choice of a leading element and the eigenproblem of a symmetric matrix.
 
 #ifndef MATH_FUNCTION_H
 #define MATH_FUNCTION_H
@@ -29,6 +29,13 @@ namespace MFE
 	// Solving a system of linear equations by reflection method
 	MFE_LIB_EXPORT RealVector solveReflectionMethod(const RealMatrix matrixCoefficients,
 		const RealVector freeTerms);
+
+	// Eigenvalues and eigenvectors of a symmetric matrix by the Jacobi
+	// rotation method. The eigenvectors are written in the rows of the matrix
+	// "eigenvectors" in the order of the eigenvalues. If the off-diagonal
+	// elements do not vanish in 100 sweeps, a warning is issued.
+	MFE_LIB_EXPORT void calculateEigenSymmetric(const RealMatrix& matrix,
+		RealVector& eigenvalues, RealMatrix& eigenvectors);
 }
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,111 @@
+// This file is used in the hex_mesh files.
+// This file contains the sparse matrix in the compressed sparse row format
+// (CSR) and the functions for it: the product by a vector and the solution
+// of a system of linear equations with a symmetric positive definite matrix
+// by the conjugate gradient method with the diagonal (Jacobi) preconditioner.
+// The method needs only the product of the matrix by a vector, so it also
+// takes the matrices without storage (LinearOperator).
+
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <vector>
+
+#include <MFE_lib/types/matrix_type.h>
+
+namespace MFE
+{
+	constexpr Real CONJUGATE_GRADIENT_TOLERANCE = 1.0e-10;
+
+	// The columns of the row "rowNum" are columns[rowOffsets[rowNum]] ...
+	// columns[rowOffsets[rowNum + 1] - 1] in ascending order, the values are
+	// in the same positions of "values"
+	struct MFE_LIB_EXPORT SparseMatrix
+	{
+		UnsignedType rows = 0;
+		std::vector<UnsignedType> rowOffsets;
+		std::vector<UnsignedType> columns;
+		RealVector values;
+	};
+
+	// tolerance - the norm of the residual relative to the norm of the free
+	// terms; maxIterations - 0 is the number of the rows of the matrix
+	struct MFE_LIB_EXPORT IterativeSolverOptions
+	{
+		Real tolerance = CONJUGATE_GRADIENT_TOLERANCE;
+		UnsignedType maxIterations = 0;
+	};
+
+	// The solution and the relative norm of its residual
+	struct MFE_LIB_EXPORT IterativeSolution
+	{
+		RealVector solution;
+		UnsignedType iterations = 0;
+		Real residual = 0.0;
+		bool isConverged = false;
+	};
+
+	// The matrix given by its product by a vector (the matrix may not be
+	// stored) and its diagonal (for the preconditioner)
+	class MFE_LIB_EXPORT LinearOperator
+	{
+	public:
+
+		virtual ~LinearOperator() = default;
+
+		virtual UnsignedType sizeRows() const = 0;
+
+		// result = matrix * vec
+		virtual void apply(const RealVector& vec, RealVector& result) const = 0;
+
+		virtual RealVector getDiagonal() const = 0;
+
+	};
+
+	// The operator of the sparse matrix, the matrix must exist while the
+	// operator is used
+	class MFE_LIB_EXPORT SparseOperator : public LinearOperator
+	{
+	public:
+
+		explicit SparseOperator(const SparseMatrix& matrix);
+
+		UnsignedType sizeRows() const override;
+
+		void apply(const RealVector& vec, RealVector& result) const override;
+
+		RealVector getDiagonal() const override;
+
+	private:
+
+		const SparseMatrix& m_matrix;
+
+	};
+
+	// The value of the matrix in the position, the position must be in the
+	// pattern of the matrix
+	MFE_LIB_EXPORT Real& getSparseValue(SparseMatrix& matrix,
+		const UnsignedType& rowNum, const UnsignedType& columnNum);
+
+	// The product of the sparse matrix and the vector: result = matrix * vec
+	MFE_LIB_EXPORT void multiplySparse(const SparseMatrix& matrix,
+		const RealVector& vec, RealVector& result);
+
+	// The dense matrix of the sparse matrix
+	MFE_LIB_EXPORT RealMatrix makeDenseMatrix(const SparseMatrix& matrix);
+
+	// Solving a system of linear equations with a symmetric positive definite
+	// matrix by the preconditioned conjugate gradient method. The iterations
+	// are added to the counter PROFILE_SOLVER_ITERATIONS of the profiling.
+	// If the method does not converge, the warning is given.
+	MFE_LIB_EXPORT IterativeSolution solveConjugateGradient(
+		const SparseMatrix& matrix, const RealVector& freeTerms,
+		const IterativeSolverOptions& options = IterativeSolverOptions());
+
+	// The same for the matrix given by the operator
+	MFE_LIB_EXPORT IterativeSolution solveConjugateGradient(
+		const LinearOperator& matrix, const RealVector& freeTerms,
+		const IterativeSolverOptions& options = IterativeSolverOptions());
+}
+
+#endif
@@ -1,6 +1,10 @@
 // This file contains functions for writing to a file "displacements.txt" moving
 // nodes in the direction of movement, as well as the function of writing time
 // steps to a file "time.txt ".
+// The numbers are formatted by std::to_chars into a large buffer, which is
+// written to the file by blocks (TextWriter), instead of the insertion of
+// each value into the stream. writeChannels writes several degrees of
+// freedom with the time into one CSV/TSV file.
 
 #ifndef WRITE_H
 #define WRITE_H
@@ -8,39 +12,147 @@
 #include <iostream>
 #include <fstream>
 #include <array>
+#include <string>
+#include <vector>
 
 #include <MFE_lib/types/matrix_type.h>
 #include <MFE_lib/active_indices.h>
 
 namespace MFE
 {
+	// The size of the buffer of TextWriter by default
+	constexpr UnsignedType TEXT_BUFFER_SIZE = 1 << 20;
+
+	// The precision of the values: the shortest representation that is read
+	// back exactly, and the precision of the streams by default (the format
+	// of the writeDisp functions). The precision is from 0 to
+	// TEXT_PRECISION_MAX: the digits beyond 17 do not change the value read
+	// back.
+	constexpr int TEXT_PRECISION_SHORTEST = 0;
+	constexpr int TEXT_PRECISION_STREAM = 6;
+	constexpr int TEXT_PRECISION_MAX = 17;
+
+	// The layout of writeChannels: comma or tab separated values
+	enum TextLayout
+	{
+		TEXT_LAYOUT_CSV,
+		TEXT_LAYOUT_TSV,
+	};
+
+	// The buffered text file: the values are formatted into the buffer, the
+	// filled buffer is written to the file by one block.
+	class MFE_LIB_EXPORT TextWriter
+	{
+	public:
+
+		explicit TextWriter(const std::string& fileName,
+			const int& precision = TEXT_PRECISION_SHORTEST,
+			const UnsignedType& bufferSize = TEXT_BUFFER_SIZE);
+
+		~TextWriter();
+
+		TextWriter(const TextWriter&) = delete;
+		TextWriter& operator=(const TextWriter&) = delete;
+
+		bool isOpen() const;
+
+		void writeValue(const Real& value);
+
+		void writeValue(const UnsignedType& value);
+
+		void writeText(const std::string& text);
+
+		void writeChar(const char& symbol);
+
+		// Writing the buffer and closing the file, false if not all values
+		// were written
+		bool close();
+
+	private:
+
+		// Writing the buffer to the file if it has less than "size" free bytes
+		void reserve(const UnsignedType& size);
+
+		void flush();
+
+		std::ofstream m_fout;
+		std::vector<char> m_buffer;
+		UnsignedType m_size = 0;
+		int m_precision = TEXT_PRECISION_SHORTEST;
+		bool m_isWritten = false;
+
+	};
+
+	// Writing the degrees of freedom "indices" into one file:
+	// the header "time,u0,u1,u4,u6", then the row of each step
+	// (the time and the displacements).
+	class MFE_LIB_EXPORT ChannelsWriter
+	{
+	public:
+
+		ChannelsWriter(const std::string& fileName,
+			const std::vector<UnsignedType>& indices,
+			const TextLayout& layout = TEXT_LAYOUT_CSV,
+			const int& precision = TEXT_PRECISION_SHORTEST);
+
+		bool isOpen() const;
+
+		void writeRow(const Real& time, const RealVector& displacement);
+
+		bool close();
+
+	private:
+
+		TextWriter m_writer;
+		std::vector<UnsignedType> m_indices;
+		char m_separator = ',';
+
+	};
+
 	// If it is not written to the file, the functions return false, otherwise true.
+	// fileName - the name of the file, by default "displacements.txt"
+	// ("time.txt" for the time steps).
 	
 	// Writing to the file the displacements of nodes 1, 2, 5, 6 in the direction of 
 	// movement in a time step deltaT during time "time".
 	// rows is the number of rows of the displacement matrix, and displacements is
 	// the displacement matrix.
-	MFE_LIB_EXPORT bool writeDispAllNodes(const RealMatrix& displacements);
+	MFE_LIB_EXPORT bool writeDispAllNodes(const RealMatrix& displacements,
+		const std::string& fileName = "displacements.txt");
 
 	// Writing to the file the displacements of node 1 in the direction of 
 	// movement in a time step deltaT during time "time".
-	MFE_LIB_EXPORT bool writeDispFirstNode(const RealMatrix& displacements);
+	MFE_LIB_EXPORT bool writeDispFirstNode(const RealMatrix& displacements,
+		const std::string& fileName = "displacements.txt");
 
 	// Writing to the file the displacements of node 2 in the direction of 
 	// movement in a time step deltaT during time "time".
-	MFE_LIB_EXPORT bool writeDispSecondNode(const RealMatrix& displacements);
+	MFE_LIB_EXPORT bool writeDispSecondNode(const RealMatrix& displacements,
+		const std::string& fileName = "displacements.txt");
 
 	// Writing to the file the displacements of node 5 in the direction of 
 	// movement in a time step deltaT during time "time".
-	MFE_LIB_EXPORT bool writeDispFifthNode(const RealMatrix& displacements);
+	MFE_LIB_EXPORT bool writeDispFifthNode(const RealMatrix& displacements,
+		const std::string& fileName = "displacements.txt");
 
 	// Writing to the file the displacements of node 6 in the direction of 
 	// movement in a time step deltaT during time "time".
-	MFE_LIB_EXPORT bool writeDispSixthNode(const RealMatrix& displacements);
+	MFE_LIB_EXPORT bool writeDispSixthNode(const RealMatrix& displacements,
+		const std::string& fileName = "displacements.txt");
+
+	// Writing to one file the time and the displacements of the degrees of
+	// freedom "indices" of each row of the displacement matrix (the nodes
+	// 1, 2, 5, 6 in the direction of movement by default)
+	MFE_LIB_EXPORT bool writeChannels(const RealMatrix& displacements,
+		const Real& deltaT, const std::string& fileName,
+		const std::vector<UnsignedType>& indices =
+		std::vector<UnsignedType>(ACTIVE_INDICES.begin(), ACTIVE_INDICES.end()),
+		const TextLayout& layout = TEXT_LAYOUT_CSV);
 
 	// Writing deltaT time intervals to a file during the "time" time.
 	// steps = time / deltaT
-	MFE_LIB_EXPORT bool writeStepsTime(const UnsignedType& steps, const Real& deltaT);
+	MFE_LIB_EXPORT bool writeStepsTime(const UnsignedType& steps, const Real& deltaT,
+		const std::string& fileName = "time.txt");
 
 }
 
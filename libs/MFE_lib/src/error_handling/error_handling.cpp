@@ -9,32 +9,11 @@ void assertError(bool condition, const std::string& msg, const char* file)
 	}
 }
 
+// The message is put into the queue of the logger, the file is written
+// by the background thread
 void log(LogLevel level, const std::string& message)
 {
-	std::ofstream logFile("error_log.txt", std::ios::app);
-	if (logFile.is_open())
-	{
-		std::time_t now = std::time(nullptr);
-		std::tm* localTime = std::localtime(&now);
-
-		std::ostringstream timeStream;
-		timeStream << std::put_time(localTime, "%Y-%m-%d %H:%M:%S");
-		std::string timestamp = timeStream.str();
-
-		std::string levelStr = "Nothing";
-		switch (level)
-		{
-		case LogLevel::WARNING:
-			levelStr = "WARNING";
-			break;
-		case LogLevel::ERROR:
-			levelStr = "ERROR";
-			break;
-		}
-
-		logFile << "[" << timestamp << "] : " << levelStr << " : " 
-				<< message << "\n\n";
-	}
+	Logger::getInstance().push(level, message);
 }
 
 void error(std::string msg, const char* file, const long& line)
@@ -45,7 +24,12 @@ void error(std::string msg, const char* file, const long& line)
 	msg += "Line error: ";
 	msg += std::to_string(line) + "\n\n";
 
-	log(LogLevel::ERROR, msg);
+#if MFE_LIB_LOG_LEVEL <= MFE_LIB_LOG_LEVEL_ERROR
+	// The error can end the program, so the log is written at once
+	Logger& logger = Logger::getInstance();
+	logger.push(LogLevel::ERROR, msg);
+	logger.flush();
+#endif
 	throw std::runtime_error(msg);
 }
 
@@ -56,7 +40,9 @@ void warning(std::string msg, const char* file, const long& line)
 
 	msg += "Line error: ";
 	msg += std::to_string(line) + "\n\n";
-	log(LogLevel::WARNING, msg);
+
+	// The warnings of one place are limited, the time loop is not stopped
+	Logger::getInstance().push(LogLevel::WARNING, msg, file, line);
 }
 
 static std::string messageOutOfRange()
@@ -7,6 +7,9 @@
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <mutex>
+
+#include "logger.h"
 
 #ifdef NDEBUG
 	#define ASSERT(cond, msg) ((void)0)
@@ -15,11 +18,14 @@
 #endif
 
 #define ERROR(msg) error(msg, __FILE__, __LINE__)
- 
-#define WARNING(msg) warning(msg ,__FILE__, __LINE__)
 
+// The warnings are removed at compile time if the level of the log is higher
+#if MFE_LIB_LOG_LEVEL > MFE_LIB_LOG_LEVEL_WARNING
+	#define WARNING(msg) ((void)0)
+#else
+	#define WARNING(msg) warning(msg ,__FILE__, __LINE__)
+#endif
 
-enum class LogLevel {WARNING, ERROR};
 
 void assertError(bool condition, const std::string& msg, const char* file);
 
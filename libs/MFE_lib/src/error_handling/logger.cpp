@@ -0,0 +1,281 @@
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+// The local time without the shared buffer of std::localtime
+static std::tm getLocalTime(const std::time_t& time)
+{
+	std::tm localTime{};
+#ifdef _WIN32
+	localtime_s(&localTime, &time);
+#else
+	localtime_r(&time, &localTime);
+#endif
+	return localTime;
+}
+
+static std::string getLevelName(const LogLevel& level)
+{
+	switch (level)
+	{
+	case LogLevel::WARNING:
+		return "WARNING";
+	case LogLevel::ERROR:
+		return "ERROR";
+	}
+
+	return "Nothing";
+}
+
+Logger::Logger(const std::string& fileName) :
+	m_fileName(fileName)
+{
+	static_assert((LOG_QUEUE_SIZE & (LOG_QUEUE_SIZE - 1)) == 0,
+		"The size of the queue of the log must be a power of 2");
+
+	for (std::size_t messageNum = 0; messageNum < LOG_QUEUE_SIZE; ++messageNum)
+		m_messages[messageNum].sequence.store(messageNum, std::memory_order_relaxed);
+
+	m_thread = std::thread(&Logger::write, this);
+}
+
+Logger::~Logger()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isFinished = true;
+	}
+	m_condition.notify_one();
+
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+Logger& Logger::getInstance()
+{
+	static Logger logger("error_log.txt");
+	return logger;
+}
+
+// The limit of the messages of the place of the code for the current second.
+// The counters are approximate if several threads log from one place at
+// once, it is enough for the limit.
+bool Logger::isSiteAllowed(const char* site, const long& line,
+	std::uint32_t& suppressedCount)
+{
+	const std::uintptr_t key = reinterpret_cast<std::uintptr_t>(site) ^
+		(static_cast<std::uintptr_t>(line) << 16) ^ 1;
+
+	Site* siteFound = nullptr;
+	const std::size_t first = (key * 0x9E3779B97F4A7C15ULL >> 32) % LOG_SITES_COUNT;
+	for (std::size_t siteNum = 0; siteNum < LOG_SITES_COUNT; ++siteNum)
+	{
+		Site& siteCurrent = m_sites[(first + siteNum) % LOG_SITES_COUNT];
+		std::uintptr_t keyCurrent = siteCurrent.key.load(std::memory_order_acquire);
+		if (keyCurrent == 0 &&
+			siteCurrent.key.compare_exchange_strong(keyCurrent, key))
+			keyCurrent = key;
+
+		if (keyCurrent == key)
+		{
+			siteFound = &siteCurrent;
+			break;
+		}
+	}
+
+	// All places are taken, the message is not limited
+	if (siteFound == nullptr)
+		return true;
+
+	const std::int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	std::int64_t secondOld = siteFound->second.load(std::memory_order_relaxed);
+	if (secondOld != second &&
+		siteFound->second.compare_exchange_strong(secondOld, second))
+	{
+		siteFound->count.store(0, std::memory_order_relaxed);
+		suppressedCount = siteFound->suppressedCount.exchange(0);
+	}
+
+	if (siteFound->count.fetch_add(1, std::memory_order_relaxed) >= LOG_SITE_LIMIT)
+	{
+		siteFound->suppressedCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	return true;
+}
+
+// The bounded queue of many writers and one reader: the position of the
+// message is taken by compare-and-swap, the message is published by its
+// sequence number
+void Logger::push(const LogLevel& level, const std::string& message,
+	const char* site, const long& line)
+{
+	std::uint32_t suppressedCount = 0;
+	if (site != nullptr && !isSiteAllowed(site, line, suppressedCount))
+		return;
+
+	std::size_t pos = m_pushPos.load(std::memory_order_relaxed);
+	Message* messageQueue = nullptr;
+	while (true)
+	{
+		messageQueue = &m_messages[pos & (LOG_QUEUE_SIZE - 1)];
+		const std::size_t sequence =
+			messageQueue->sequence.load(std::memory_order_acquire);
+		const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) -
+			static_cast<std::ptrdiff_t>(pos);
+
+		if (difference == 0)
+		{
+			if (m_pushPos.compare_exchange_weak(pos, pos + 1,
+				std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			// The queue is full, the calculation does not wait
+			m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+			pos = m_pushPos.load(std::memory_order_relaxed);
+	}
+
+	messageQueue->level = level;
+	messageQueue->time = std::time(nullptr);
+	messageQueue->suppressedCount = suppressedCount;
+	messageQueue->size = std::min(message.size(), LOG_MESSAGE_SIZE);
+	std::copy(message.begin(), message.begin() + messageQueue->size,
+		messageQueue->text.begin());
+	messageQueue->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void Logger::flush()
+{
+	const std::size_t pos = m_pushPos.load(std::memory_order_acquire);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_isFlushed = true;
+	m_condition.notify_one();
+	m_writtenCondition.wait(lock, [this, pos]()
+		{
+			return m_writtenPos.load(std::memory_order_acquire) >= pos ||
+				m_isFinished;
+		});
+}
+
+void Logger::write()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_condition.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_PERIOD),
+			[this]()
+			{
+				return m_isFlushed || m_isFinished;
+			});
+
+		const bool isFinished = m_isFinished;
+		m_isFlushed = false;
+		lock.unlock();
+
+		writeQueue();
+		if (isFinished)
+		{
+			writeRepeated();
+
+			std::uint64_t suppressedCount = 0;
+			for (auto& site : m_sites)
+				suppressedCount += site.suppressedCount.exchange(0);
+			if (suppressedCount != 0)
+			{
+				writeMessage("Messages suppressed by the limit of the log: " +
+					std::to_string(suppressedCount) + "\n\n");
+			}
+
+			if (m_file.is_open())
+				m_file.flush();
+		}
+
+		lock.lock();
+		m_writtenCondition.notify_all();
+		if (isFinished)
+			return;
+	}
+}
+
+void Logger::writeQueue()
+{
+	bool isWritten = false;
+	while (true)
+	{
+		Message& message = m_messages[m_popPos & (LOG_QUEUE_SIZE - 1)];
+		if (message.sequence.load(std::memory_order_acquire) != m_popPos + 1)
+			break;
+
+		std::string text = getLevelName(message.level) + " : " +
+			std::string(message.text.data(), message.size);
+		if (message.suppressedCount != 0)
+		{
+			text += "(" + std::to_string(message.suppressedCount) +
+				" messages of this place were suppressed)";
+		}
+		text += "\n\n";
+
+		if (text == m_previous)
+			++m_repeatedCount;
+		else
+		{
+			writeRepeated();
+
+			const std::tm localTime = getLocalTime(message.time);
+			std::ostringstream timeStream;
+			timeStream << std::put_time(&localTime, "%Y-%m-%d %H:%M:%S");
+			writeMessage("[" + timeStream.str() + "] : " + text);
+
+			m_previous = std::move(text);
+		}
+
+		message.sequence.store(m_popPos + LOG_QUEUE_SIZE, std::memory_order_release);
+		++m_popPos;
+		isWritten = true;
+	}
+
+	const std::uint64_t droppedCount = m_droppedCount.exchange(0);
+	if (droppedCount != 0)
+	{
+		writeRepeated();
+		writeMessage("Messages dropped (the queue of the log is full): " +
+			std::to_string(droppedCount) + "\n\n");
+		m_previous.clear();
+	}
+
+	if (isWritten && m_file.is_open())
+		m_file.flush();
+
+	m_writtenPos.store(m_popPos, std::memory_order_release);
+}
+
+void Logger::writeMessage(const std::string& message)
+{
+	// The file is opened by the first message
+	if (!m_file.is_open())
+		m_file.open(m_fileName, std::ios::app);
+
+	if (m_file.is_open())
+		m_file << message;
+}
+
+void Logger::writeRepeated()
+{
+	if (m_repeatedCount == 0)
+		return;
+
+	writeMessage("The previous message is repeated " +
+		std::to_string(m_repeatedCount) + " times\n\n");
+	m_repeatedCount = 0;
+}
@@ -0,0 +1,133 @@
+// This file is used in the error_handling files.
+// This file contains the asynchronous logger of the library. The messages
+// are put into a bounded lock-free queue (the thread that logs does not wait
+// for the file and does not take a lock), and the background thread writes
+// them to the log file. The logger never stalls the calculation: if the
+// queue is full, the message is dropped and counted.
+// The messages of one place of the code (file and line) are limited by
+// LOG_SITE_LIMIT per second, the rest are counted and reported with the
+// next message of the place. The same consecutive messages are written
+// once with the number of repetitions.
+
+#ifndef ERROR_LOGGER_H
+#define ERROR_LOGGER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// The levels of the messages for the filtering at compile time
+// (MFE_LIB_LOG_LEVEL): the messages below the level are not logged
+#define MFE_LIB_LOG_LEVEL_WARNING 0
+#define MFE_LIB_LOG_LEVEL_ERROR 1
+#define MFE_LIB_LOG_LEVEL_NONE 2
+
+#ifndef MFE_LIB_LOG_LEVEL
+	#define MFE_LIB_LOG_LEVEL MFE_LIB_LOG_LEVEL_WARNING
+#endif
+
+enum class LogLevel {WARNING, ERROR};
+
+// The number of messages of the queue (a power of 2) and the maximum
+// size of a message (the longer messages are cut)
+constexpr std::size_t LOG_QUEUE_SIZE = 1024;
+constexpr std::size_t LOG_MESSAGE_SIZE = 512;
+
+// The number of places of the code, which are limited separately, and
+// the number of messages of a place per second
+constexpr std::size_t LOG_SITES_COUNT = 256;
+constexpr std::uint32_t LOG_SITE_LIMIT = 10;
+
+// The period of writing of the background thread (milliseconds)
+constexpr long LOG_FLUSH_PERIOD = 50;
+
+class Logger
+{
+public:
+
+	explicit Logger(const std::string& fileName);
+
+	// The messages of the queue are written before the end
+	~Logger();
+
+	Logger(const Logger&) = delete;
+	Logger& operator=(const Logger&) = delete;
+
+	// Putting the message into the queue. site - the place of the code
+	// (nullptr - the message is not limited)
+	void push(const LogLevel& level, const std::string& message,
+		const char* site = nullptr, const long& line = 0);
+
+	// Waiting until the messages of the queue are written
+	void flush();
+
+	// The logger of the library (the file "error_log.txt")
+	static Logger& getInstance();
+
+private:
+
+	struct Message
+	{
+		std::atomic<std::size_t> sequence{ 0 };
+		LogLevel level = LogLevel::WARNING;
+		std::time_t time = 0;
+		std::uint32_t suppressedCount = 0;
+		std::size_t size = 0;
+		std::array<char, LOG_MESSAGE_SIZE> text{};
+	};
+
+	struct Site
+	{
+		std::atomic<std::uintptr_t> key{ 0 };
+		std::atomic<std::int64_t> second{ 0 };
+		std::atomic<std::uint32_t> count{ 0 };
+		std::atomic<std::uint32_t> suppressedCount{ 0 };
+	};
+
+	// false if the message of the place is over the limit; the number of
+	// the suppressed messages of the last second is taken
+	bool isSiteAllowed(const char* site, const long& line,
+		std::uint32_t& suppressedCount);
+
+	// The background thread
+	void write();
+
+	// Writing the messages of the queue to the file
+	void writeQueue();
+
+	void writeMessage(const std::string& message);
+
+	void writeRepeated();
+
+	std::array<Message, LOG_QUEUE_SIZE> m_messages;
+	std::atomic<std::size_t> m_pushPos{ 0 };
+	std::size_t m_popPos = 0;
+	std::atomic<std::size_t> m_writtenPos{ 0 };
+	std::atomic<std::uint64_t> m_droppedCount{ 0 };
+
+	std::array<Site, LOG_SITES_COUNT> m_sites;
+
+	std::string m_fileName;
+	std::ofstream m_file;
+
+	// The previous message and the number of its repetitions
+	std::string m_previous;
+	std::uint64_t m_repeatedCount = 0;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::condition_variable m_writtenCondition;
+	bool m_isFlushed = false;
+	bool m_isFinished = false;
+
+	std::thread m_thread;
+
+};
+
+#endif
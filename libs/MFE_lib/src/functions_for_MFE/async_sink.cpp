@@ -0,0 +1,186 @@
+#include <MFE_lib/functions_for_MFE/async_sink.h>
+
+#include <algorithm>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+AsyncSink::AsyncSink(ResultSink& target, const UnsignedType& blockSteps,
+	const UnsignedType& blocksCount) :
+	m_target(target), m_blockSteps(blockSteps), m_blocks(blocksCount)
+{
+	// One block is filled by the solver, at least one is written
+	if (m_blockSteps == 0 || blocksCount < 2)
+	{
+		std::string msg = "The asynchronous sink needs at least 2 blocks "
+			"of at least 1 step. ";
+		ERROR(msg);
+	}
+}
+
+AsyncSink::~AsyncSink()
+{
+	// The calculation was interrupted by an exception before end
+	stop();
+}
+
+void AsyncSink::begin(const SinkHeader& header)
+{
+	if (m_thread.joinable())
+	{
+		std::string msg = "The asynchronous sink is already started. ";
+		ERROR(msg);
+	}
+
+	m_dofCount = header.dofCount;
+	for (auto& block : m_blocks)
+	{
+		block.steps.resize(m_blockSteps);
+		block.isStuck.resize(m_blockSteps);
+		block.displacements.resize(m_blockSteps * m_dofCount);
+		block.count = 0;
+	}
+
+	m_current = 0;
+	m_filled.clear();
+	m_free.clear();
+	for (UnsignedType blockNum = 1; blockNum < m_blocks.size(); ++blockNum)
+		m_free.push_back(blockNum);
+	m_isFinished = false;
+	m_error = nullptr;
+
+	m_target.begin(header);
+	m_thread = std::thread(&AsyncSink::write, this);
+}
+
+void AsyncSink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool& isStuck)
+{
+	if (displacement.size() != m_dofCount)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	Block& block = m_blocks[m_current];
+	block.steps[block.count] = step;
+	block.isStuck[block.count] = isStuck;
+	std::copy(displacement.begin(), displacement.end(),
+		block.displacements.begin() + block.count * m_dofCount);
+	++block.count;
+
+	if (block.count == m_blockSteps)
+		submit();
+}
+
+void AsyncSink::end()
+{
+	if (!m_thread.joinable())
+		return;
+
+	if (m_blocks[m_current].count != 0)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_filled.push_back(m_current);
+	}
+
+	stop();
+	m_target.end();
+	rethrowError();
+}
+
+void AsyncSink::submit()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_filled.push_back(m_current);
+	m_filledCondition.notify_one();
+
+	// Backpressure: the solver waits until the writer frees a block
+	m_freeCondition.wait(lock, [this]()
+		{
+			return !m_free.empty() || m_error != nullptr;
+		});
+
+	if (m_error != nullptr)
+	{
+		lock.unlock();
+		stop();
+		rethrowError();
+	}
+
+	m_current = m_free.front();
+	m_free.pop_front();
+	m_blocks[m_current].count = 0;
+}
+
+void AsyncSink::write()
+{
+	RealVector displacement(m_dofCount, 0.0);
+	while (true)
+	{
+		UnsignedType blockNum = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_filledCondition.wait(lock, [this]()
+				{
+					return !m_filled.empty() || m_isFinished;
+				});
+
+			if (m_filled.empty())
+				return;
+
+			blockNum = m_filled.front();
+			m_filled.pop_front();
+		}
+
+		Block& block = m_blocks[blockNum];
+		try
+		{
+			for (UnsignedType stepNum = 0; stepNum < block.count; ++stepNum)
+			{
+				const auto first = block.displacements.begin() +
+					stepNum * m_dofCount;
+				std::copy(first, first + m_dofCount, displacement.begin());
+				m_target.record(block.steps[stepNum], displacement,
+					block.isStuck[stepNum] != 0);
+			}
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_error = std::current_exception();
+			m_freeCondition.notify_one();
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		block.count = 0;
+		m_free.push_back(blockNum);
+		m_freeCondition.notify_one();
+	}
+}
+
+// Finishing the writer thread after the filled blocks are written
+void AsyncSink::stop()
+{
+	if (!m_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isFinished = true;
+	}
+	m_filledCondition.notify_one();
+	m_thread.join();
+}
+
+void AsyncSink::rethrowError()
+{
+	if (m_error == nullptr)
+		return;
+
+	std::exception_ptr error = m_error;
+	m_error = nullptr;
+	std::rethrow_exception(error);
+}
@@ -0,0 +1,393 @@
+#include <MFE_lib/functions_for_MFE/binary_results.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+// wingdi.h defines ERROR, the macro of error_handling is used
+#undef ERROR
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+static_assert(sizeof(Real) == sizeof(std::uint64_t),
+	"The channels of the binary results are float64");
+static_assert(sizeof(BinaryHeader) == 64, "The header must be 64 bytes");
+
+std::string messageBinaryDamaged(const std::string& fileName)
+{
+	return "The binary results \"" + fileName + "\" are damaged. ";
+}
+
+// The size of the part before the data, rounded up to the alignment
+static std::uint64_t getDataOffset(const std::uint64_t& channelsCount,
+	const std::uint64_t& configSize)
+{
+	const std::uint64_t size = sizeof(BinaryHeader) +
+		channelsCount * sizeof(std::uint64_t) + configSize;
+
+	return (size + BINARY_DATA_ALIGNMENT - 1) / BINARY_DATA_ALIGNMENT *
+		BINARY_DATA_ALIGNMENT;
+}
+
+// The offset of the column: 0 - the step numbers, 1, 2, ... - the channels
+static std::uint64_t getColumnOffset(const BinaryHeader& header,
+	const std::uint64_t& columnNum)
+{
+	return header.dataOffset + columnNum * header.capacity * sizeof(Real);
+}
+
+BinaryFileSink::BinaryFileSink(const std::string& fileName,
+	const std::vector<UnsignedType>& indices) :
+	m_fileName(fileName), m_indices(indices)
+{
+	if (m_indices.empty())
+	{
+		std::string msg = "The indices of the binary file are not set. ";
+		ERROR(msg);
+	}
+}
+
+BinaryFileSink::BinaryFileSink(const std::string& fileName,
+	const SimulationConfig& config, const std::vector<UnsignedType>& indices) :
+	BinaryFileSink(fileName, indices)
+{
+	std::ostringstream output;
+	writeScenario(output, config);
+	m_config = output.str();
+}
+
+void BinaryFileSink::begin(const SinkHeader& header)
+{
+	const UnsignedType lastIndex =
+		*std::max_element(m_indices.begin(), m_indices.end());
+	if (lastIndex >= header.dofCount)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	m_header = BinaryHeader();
+	std::memcpy(m_header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	m_header.deltaT = header.deltaT;
+	m_header.capacity = header.stepsCount;
+	m_header.channelsCount = m_indices.size();
+	m_header.configSize = m_config.size();
+	m_header.dataOffset = getDataOffset(m_header.channelsCount,
+		m_header.configSize);
+
+	m_writtenCount = 0;
+	m_steps.clear();
+
+	m_fout.open(m_fileName, std::ios::binary | std::ios::trunc);
+	m_isWritten = m_fout.is_open();
+	if (!m_isWritten)
+	{
+		std::string msg = "The file \"" + m_fileName + "\" was not opened. ";
+		WARNING(msg);
+		return;
+	}
+
+	std::vector<std::uint64_t> indices(m_indices.begin(), m_indices.end());
+	m_fout.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+	m_fout.write(reinterpret_cast<const char*>(indices.data()),
+		indices.size() * sizeof(std::uint64_t));
+	m_fout.write(m_config.data(), m_config.size());
+
+	// The file has the full size at once, the columns are filled by chunks
+	const std::uint64_t fileSize = getColumnOffset(m_header,
+		m_header.channelsCount + 1);
+	if (fileSize > static_cast<std::uint64_t>(m_fout.tellp()))
+	{
+		m_fout.seekp(fileSize - 1);
+		m_fout.put('\0');
+	}
+
+	const UnsignedType chunkSteps = std::min(BINARY_CHUNK_STEPS,
+		std::max<UnsignedType>(header.stepsCount, 1));
+	m_steps.reserve(chunkSteps);
+	m_channels = RealMatrix(m_indices.size(), chunkSteps);
+}
+
+void BinaryFileSink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool&)
+{
+	if (!m_isWritten)
+		return;
+
+	if (m_writtenCount + m_steps.size() == m_header.capacity)
+	{
+		std::string msg = "The number of steps is more than expected, "
+			"the steps after " + std::to_string(m_header.capacity) +
+			" are not written. ";
+		WARNING(msg);
+		m_isWritten = false;
+		return;
+	}
+
+	const UnsignedType stepNum = m_steps.size();
+	const UnsignedType channelsCount = m_indices.size();
+	for (UnsignedType channelNum = 0; channelNum < channelsCount; ++channelNum)
+		m_channels[channelNum][stepNum] = displacement[m_indices[channelNum]];
+	m_steps.push_back(step);
+
+	if (m_steps.size() == m_channels.sizeColumns())
+		flush();
+}
+
+void BinaryFileSink::end()
+{
+	if (!m_fout.is_open())
+		return;
+
+	flush();
+
+	// The number of written steps is known only at the end
+	m_header.stepsCount = m_writtenCount;
+	m_fout.seekp(0);
+	m_fout.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+
+	m_fout.close();
+	if (m_fout.fail())
+	{
+		std::string msg = "The displacements are not recorded. ";
+		WARNING(msg);
+		m_isWritten = false;
+	}
+}
+
+bool BinaryFileSink::isWritten() const
+{
+	return m_isWritten;
+}
+
+// Writing the buffered steps to the columns
+void BinaryFileSink::flush()
+{
+	const UnsignedType count = m_steps.size();
+	if (count == 0)
+		return;
+
+	const std::uint64_t position = m_writtenCount * sizeof(Real);
+	m_fout.seekp(getColumnOffset(m_header, 0) + position);
+	m_fout.write(reinterpret_cast<const char*>(m_steps.data()),
+		count * sizeof(std::uint64_t));
+
+	const UnsignedType channelsCount = m_indices.size();
+	for (UnsignedType channelNum = 0; channelNum < channelsCount; ++channelNum)
+	{
+		m_fout.seekp(getColumnOffset(m_header, channelNum + 1) + position);
+		m_fout.write(reinterpret_cast<const char*>(m_channels[channelNum].data()),
+			count * sizeof(Real));
+	}
+
+	m_writtenCount += count;
+	m_steps.clear();
+}
+
+BinaryResultsReader::BinaryResultsReader(const std::string& fileName) :
+	m_fileName(fileName)
+{
+	std::string msgOpen = "The binary results \"" + fileName +
+		"\" were not opened. ";
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		ERROR(msgOpen);
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(BinaryHeader)))
+	{
+		unmap();
+		std::string msg = messageBinaryDamaged(fileName);
+		ERROR(msg);
+	}
+	m_size = static_cast<UnsignedType>(size.QuadPart);
+
+	m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping != nullptr)
+	{
+		m_data = static_cast<const char*>(MapViewOfFile(m_mapping,
+			FILE_MAP_READ, 0, 0, 0));
+	}
+	if (m_data == nullptr)
+	{
+		unmap();
+		ERROR(msgOpen);
+	}
+#else
+	const int file = open(fileName.c_str(), O_RDONLY);
+	if (file < 0)
+		ERROR(msgOpen);
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 ||
+		fileStat.st_size < static_cast<off_t>(sizeof(BinaryHeader)))
+	{
+		close(file);
+		std::string msg = messageBinaryDamaged(fileName);
+		ERROR(msg);
+	}
+	m_size = static_cast<UnsignedType>(fileStat.st_size);
+
+	void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (data == MAP_FAILED)
+		ERROR(msgOpen);
+	m_data = static_cast<const char*>(data);
+#endif
+
+	try
+	{
+		std::memcpy(&m_header, m_data, sizeof(m_header));
+
+		const bool isBinaryResults =
+			std::memcmp(m_header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0 &&
+			m_header.version == BINARY_VERSION;
+		if (!isBinaryResults)
+		{
+			std::string msg = "The file \"" + fileName +
+				"\" is not the binary results. ";
+			ERROR(msg);
+		}
+
+		if (m_header.byteOrder != BINARY_BYTE_ORDER)
+		{
+			std::string msg = "The binary results \"" + fileName +
+				"\" were written with a different byte order. ";
+			ERROR(msg);
+		}
+
+		// The sizes are checked before the offsets are calculated
+		const std::uint64_t maxValues = m_size / sizeof(Real);
+		const bool isHeaderCorrect =
+			m_header.channelsCount < maxValues &&
+			m_header.configSize < m_size &&
+			m_header.stepsCount <= m_header.capacity &&
+			m_header.capacity <= maxValues / (m_header.channelsCount + 1) &&
+			m_header.dataOffset == getDataOffset(m_header.channelsCount,
+				m_header.configSize) &&
+			getColumnOffset(m_header, m_header.channelsCount + 1) <= m_size;
+		if (!isHeaderCorrect)
+		{
+			std::string msg = messageBinaryDamaged(fileName);
+			ERROR(msg);
+		}
+
+		const char* indicesData = m_data + sizeof(BinaryHeader);
+		std::vector<std::uint64_t> indices(m_header.channelsCount);
+		std::memcpy(indices.data(), indicesData,
+			indices.size() * sizeof(std::uint64_t));
+		m_indices.assign(indices.begin(), indices.end());
+
+		m_hasConfig = m_header.configSize != 0;
+		if (m_hasConfig)
+		{
+			const char* configData = indicesData +
+				indices.size() * sizeof(std::uint64_t);
+			std::istringstream input(std::string(configData,
+				m_header.configSize));
+			m_config = readScenarios(input).front();
+		}
+	}
+	catch (...)
+	{
+		unmap();
+		throw;
+	}
+}
+
+BinaryResultsReader::~BinaryResultsReader()
+{
+	unmap();
+}
+
+Real BinaryResultsReader::getDeltaT() const
+{
+	return m_header.deltaT;
+}
+
+UnsignedType BinaryResultsReader::getStepsCount() const
+{
+	return m_header.stepsCount;
+}
+
+const std::vector<UnsignedType>& BinaryResultsReader::getIndices() const
+{
+	return m_indices;
+}
+
+bool BinaryResultsReader::hasConfig() const
+{
+	return m_hasConfig;
+}
+
+const SimulationConfig& BinaryResultsReader::getConfig() const
+{
+	if (!m_hasConfig)
+	{
+		std::string msg = "The binary results \"" + m_fileName +
+			"\" have no configuration. ";
+		ERROR(msg);
+	}
+
+	return m_config;
+}
+
+StepsView BinaryResultsReader::getSteps() const
+{
+	const char* data = m_data + getColumnOffset(m_header, 0);
+
+	return StepsView(reinterpret_cast<const std::uint64_t*>(data),
+		m_header.stepsCount);
+}
+
+ChannelView BinaryResultsReader::getChannel(const UnsignedType& index) const
+{
+	const auto channel = std::find(m_indices.begin(), m_indices.end(), index);
+	if (channel == m_indices.end())
+	{
+		std::string msg = "The degree of freedom " + std::to_string(index) +
+			" is not in the binary results. ";
+		ERROR(msg);
+	}
+
+	const UnsignedType channelNum = channel - m_indices.begin();
+	const char* data = m_data + getColumnOffset(m_header, channelNum + 1);
+
+	return ChannelView(reinterpret_cast<const Real*>(data), m_header.stepsCount);
+}
+
+void BinaryResultsReader::unmap()
+{
+#ifdef _WIN32
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != nullptr)
+		CloseHandle(m_file);
+	m_mapping = nullptr;
+	m_file = nullptr;
+#else
+	if (m_data != nullptr)
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
@@ -0,0 +1,275 @@
+#include <MFE_lib/functions_for_MFE/checkpoint.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+namespace
+{
+	constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ULL;
+	constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+	// The upper limit of the sizes of the file (the checkpoint is small)
+	constexpr std::uint64_t CHECKPOINT_SIZE_MAX = 1ULL << 32;
+}
+
+static void writeValue(std::ofstream& fout, const std::uint64_t& value)
+{
+	fout.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void writeValue(std::ofstream& fout, const Real& value)
+{
+	fout.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void writeVector(std::ofstream& fout, const RealVector& values)
+{
+	writeValue(fout, static_cast<std::uint64_t>(values.size()));
+	fout.write(reinterpret_cast<const char*>(values.data()),
+		values.size() * sizeof(Real));
+}
+
+static std::uint64_t readUnsigned(std::ifstream& fin)
+{
+	std::uint64_t value = 0;
+	fin.read(reinterpret_cast<char*>(&value), sizeof(value));
+	return value;
+}
+
+static Real readReal(std::ifstream& fin)
+{
+	Real value = 0.0;
+	fin.read(reinterpret_cast<char*>(&value), sizeof(value));
+	return value;
+}
+
+static RealVector readVector(std::ifstream& fin, const std::string& msg)
+{
+	const std::uint64_t size = readUnsigned(fin);
+	if (!fin.good() || size >= CHECKPOINT_SIZE_MAX / sizeof(Real))
+		ERROR(msg);
+
+	RealVector values(size, 0.0);
+	fin.read(reinterpret_cast<char*>(values.data()), size * sizeof(Real));
+	return values;
+}
+
+// The configuration without the values, by which the runs of the same
+// problem can differ
+static std::string getProblemScenario(SimulationConfig config)
+{
+	config.name = "";
+	config.time = 0.0;
+	config.outputFile = "";
+	config.checkpointFile = "";
+	config.checkpointInterval = 0;
+	config.restartFile = "";
+	config.profileFile = "";
+
+	std::ostringstream output;
+	writeScenario(output, config);
+	return output.str();
+}
+
+static void hashMatrix(const RealMatrix& matrix, std::uint64_t& hash)
+{
+	const UnsignedType rows = matrix.sizeRows();
+	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
+	{
+		for (const auto& value : matrix[rowNum])
+		{
+			unsigned char bytes[sizeof(Real)] = {};
+			std::memcpy(bytes, &value, sizeof(Real));
+			for (const auto& byte : bytes)
+			{
+				hash ^= byte;
+				hash *= FNV_PRIME;
+			}
+		}
+	}
+}
+
+std::uint64_t MFE::hashMatrices(const RealMatrix& matrixStiffness,
+	const RealMatrix& matrixMass)
+{
+	std::uint64_t hash = FNV_OFFSET;
+	hashMatrix(matrixStiffness, hash);
+	hashMatrix(matrixMass, hash);
+
+	return hash;
+}
+
+bool MFE::writeCheckpoint(const Checkpoint& checkpoint,
+	const std::string& fileName)
+{
+	const std::string fileNameTemp = fileName + ".tmp";
+	std::ofstream fout(fileNameTemp, std::ios::binary);
+	if (!fout.is_open())
+	{
+		std::string msg = "The file \"" + fileNameTemp + "\" was not opened. ";
+		WARNING(msg);
+		return false;
+	}
+
+	std::ostringstream scenario;
+	writeScenario(scenario, checkpoint.config);
+	const std::string scenarioText = scenario.str();
+
+	const std::uint32_t version[2] = { CHECKPOINT_VERSION, CHECKPOINT_BYTE_ORDER };
+	fout.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	fout.write(reinterpret_cast<const char*>(version), sizeof(version));
+	writeValue(fout, static_cast<std::uint64_t>(scenarioText.size()));
+	fout.write(scenarioText.data(), scenarioText.size());
+
+	const IntegratorParameters& integrator = checkpoint.integrator;
+	writeValue(fout, integrator.alphaM);
+	writeValue(fout, integrator.alphaF);
+	writeValue(fout, integrator.beta);
+	writeValue(fout, integrator.gamma);
+	writeValue(fout, static_cast<std::uint64_t>(checkpoint.dofCount));
+	writeValue(fout, checkpoint.matrixHash);
+
+	const SolverContext& context = checkpoint.context;
+	writeValue(fout, static_cast<std::uint64_t>(context.step));
+	writeValue(fout, static_cast<std::uint64_t>(context.isStuck));
+	writeValue(fout, static_cast<std::uint64_t>(context.isAccelInitialNoZero));
+	writeValue(fout, static_cast<std::uint64_t>(context.isFirstForce));
+	writeValue(fout, static_cast<std::uint64_t>(checkpoint.isStepRecorded));
+	writeValue(fout, context.averagePointsSpeedOld);
+	writeValue(fout, context.sumSteps);
+	writeValue(fout, context.firstSumForce);
+	writeVector(fout, context.displacement);
+	writeVector(fout, context.speed);
+	writeVector(fout, context.acceleration);
+
+	fout.close();
+	if (fout.fail())
+	{
+		std::string msg = "The checkpoint is not recorded. ";
+		WARNING(msg);
+		std::remove(fileNameTemp.c_str());
+		return false;
+	}
+
+	// The existing checkpoint is replaced by one operation (also on Windows,
+	// where std::rename does not replace the file)
+	std::error_code errorCode;
+	std::filesystem::rename(fileNameTemp, fileName, errorCode);
+	if (errorCode)
+	{
+		std::string msg = "The checkpoint \"" + fileName + "\" is not replaced. ";
+		WARNING(msg);
+		return false;
+	}
+
+	return true;
+}
+
+Checkpoint MFE::readCheckpoint(const std::string& fileName)
+{
+	std::ifstream fin(fileName, std::ios::binary);
+	if (!fin.is_open())
+	{
+		std::string msg = "The file \"" + fileName + "\" was not opened. ";
+		ERROR(msg);
+	}
+
+	const std::string msg = "The checkpoint \"" + fileName + "\" is damaged. ";
+
+	char magic[sizeof(CHECKPOINT_MAGIC)] = {};
+	std::uint32_t version[2] = {};
+	fin.read(magic, sizeof(magic));
+	fin.read(reinterpret_cast<char*>(version), sizeof(version));
+	const std::uint64_t scenarioSize = readUnsigned(fin);
+
+	const bool isCorrect = fin.good() &&
+		std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) == 0 &&
+		version[0] == CHECKPOINT_VERSION && version[1] == CHECKPOINT_BYTE_ORDER &&
+		scenarioSize < CHECKPOINT_SIZE_MAX;
+	if (!isCorrect)
+		ERROR(msg);
+
+	std::string scenarioText(scenarioSize, '\0');
+	fin.read(&scenarioText[0], scenarioSize);
+	if (!fin.good())
+		ERROR(msg);
+
+	Checkpoint checkpoint;
+	std::istringstream scenario(scenarioText);
+	std::vector<SimulationConfig> configs = readScenarios(scenario);
+	if (configs.size() != 1)
+		ERROR(msg);
+	checkpoint.config = configs.front();
+
+	IntegratorParameters& integrator = checkpoint.integrator;
+	integrator.alphaM = readReal(fin);
+	integrator.alphaF = readReal(fin);
+	integrator.beta = readReal(fin);
+	integrator.gamma = readReal(fin);
+	checkpoint.dofCount = readUnsigned(fin);
+	checkpoint.matrixHash = readUnsigned(fin);
+
+	SolverContext& context = checkpoint.context;
+	context.step = readUnsigned(fin);
+	context.isStuck = readUnsigned(fin) != 0;
+	context.isAccelInitialNoZero = readUnsigned(fin) != 0;
+	context.isFirstForce = readUnsigned(fin) != 0;
+	checkpoint.isStepRecorded = readUnsigned(fin) != 0;
+	context.averagePointsSpeedOld = readReal(fin);
+	context.sumSteps = readReal(fin);
+	context.firstSumForce = readReal(fin);
+	context.displacement = readVector(fin, msg);
+	context.speed = readVector(fin, msg);
+	context.acceleration = readVector(fin, msg);
+
+	const UnsignedType dofCount = checkpoint.dofCount;
+	const bool isStateCorrect = fin.good() &&
+		context.displacement.size() == dofCount &&
+		context.speed.size() == dofCount &&
+		context.acceleration.size() == dofCount;
+	if (!isStateCorrect)
+		ERROR(msg);
+
+	return checkpoint;
+}
+
+void MFE::checkRestart(const Checkpoint& checkpoint,
+	const SimulationConfig& config, const IntegratorParameters& integrator,
+	const UnsignedType& dofCount, const std::uint64_t& matrixHash)
+{
+	const std::string prefix = "Scenario \"" + config.name + "\": ";
+	if (getProblemScenario(checkpoint.config) != getProblemScenario(config))
+	{
+		std::string msg = prefix + "the problem of the checkpoint is different. ";
+		ERROR(msg);
+	}
+
+	const IntegratorParameters& integratorOld = checkpoint.integrator;
+	bool isStepSame = integratorOld.alphaM == integrator.alphaM &&
+		integratorOld.alphaF == integrator.alphaF &&
+		integratorOld.beta == integrator.beta &&
+		integratorOld.gamma == integrator.gamma &&
+		checkpoint.dofCount == dofCount && checkpoint.matrixHash == matrixHash;
+	if (!isStepSame)
+	{
+		std::string msg = prefix + "the matrices or the integrator of "
+			"the checkpoint are different. ";
+		ERROR(msg);
+	}
+
+	const UnsignedType stepsCount =
+		static_cast<UnsignedType> (config.time / config.deltaT);
+	if (checkpoint.context.step >= stepsCount)
+	{
+		std::string msg = prefix + "the time is less than the time of "
+			"the checkpoint. ";
+		ERROR(msg);
+	}
+}
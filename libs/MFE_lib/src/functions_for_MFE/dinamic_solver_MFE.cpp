@@ -1,8 +1,12 @@
 #include <MFE_lib/functions_for_MFE/dinamic_solver_MFE.h>
+#include <MFE_lib/functions_for_MFE/checkpoint.h>
+#include <MFE_lib/functions_for_MFE/element_cache.h>
+#include <MFE_lib/functions_for_MFE/profiling.h>
+
+#include <utility>
 
 #include "operator_overloading/operator_overloading.h"
 #include "error_handling/error_handling.h"
-#include "inputFunctions/inputFunctions.h"
 
 using namespace MFE;
 
@@ -28,38 +32,78 @@ static bool checkAccelInitialNoZero(const RealVector& accelerationOld)
 	return false;
 }
 
-// Checking for inaccuracy of calculations (if the values go to infinity)
-static bool checkInaccuracy(const Real& sumForce)
+// Checking for inaccuracy of calculations (if the values go to infinity).
+// The resultant force of the first step is kept in the context of the run.
+static bool checkInaccuracy(SolverContext& context, const Real& sumForce)
 {
-	static bool firstEntry = true;
-	static Real firstSumForce = 0;
-	if (firstEntry)
+	if (context.isFirstForce)
 	{
-		firstSumForce = sumForce;
-		firstEntry = false;
+		context.firstSumForce = sumForce;
+		context.isFirstForce = false;
 	}
 
-	if (firstSumForce <= DBL_EPSILON)
+	if (context.firstSumForce <= DBL_EPSILON)
 	{
 		if (sumForce >= coeffLimitForce)
 			return false;
 	}
 	else
 	{
-		if (sumForce >= firstSumForce * coeffLimitForce)
+		if (sumForce >= context.firstSumForce * coeffLimitForce)
 			return false;
 	}
 
 	return true;
 }
 
-// Applying symmetry conditions to symmetry nodes for a dynamic problem
-void MFE::boundConditionsDinamic(RealMatrix& matrixStiffness,
-	RealMatrix& matrixMass, RealMatrix& displacements,
-	RealVector& speed, RealVector& acceleration,
-	RealVector& force)
+// The initial displacements from the first row of the displacement matrix
+static RealVector getFirstRow(const RealMatrix& displacements,
+	const UnsignedType& size)
+{
+	if (displacements.empty())
+		return RealVector(size, 0.0);
+
+	return displacements[0];
+}
+
+// The number of steps of the configuration
+static UnsignedType getStepsCount(const SimulationConfig& config)
+{
+	if (config.deltaT <= DBL_EPSILON)
+	{
+		std::string msg = messageDivideZero();
+		ERROR(msg);
+	}
+
+	return static_cast<UnsignedType> (config.time / config.deltaT);
+}
+
+// Checking the context of the run: the sizes of the vectors and the step
+static void checkContext(const SolverContext& context,
+	const UnsignedType& dofCount, const UnsignedType& stepsCount)
+{
+	bool isSizeCorrect = context.displacement.size() == dofCount &&
+		context.speed.size() == dofCount &&
+		context.acceleration.size() == dofCount;
+	if (!isSizeCorrect)
+	{
+		std::string msg = "The sizes of the vectors of the context are not "
+			"equal to the size of the stiffness matrix. ";
+		ERROR(msg);
+	}
+
+	if (stepsCount != 0 && context.step >= stepsCount)
+	{
+		std::string msg = "The step of the context is beyond the time. ";
+		ERROR(msg);
+	}
+}
+
+// Applying symmetry conditions to the stiffness matrix and the mass matrix
+// only: the corresponding rows and columns are deleted
+static void boundConditionsMatrices(RealMatrix& matrixStiffness,
+	RealMatrix& matrixMass)
 {
-	// Indices of degrees of freedom that are subject to symmetry conditions
 	UnsignedType rowsStiffness = matrixStiffness.sizeRows();
 	if (rowsStiffness != matrixStiffness.sizeColumns())
 	{
@@ -76,14 +120,235 @@ void MFE::boundConditionsDinamic(RealMatrix& matrixStiffness,
 		ERROR(msg);
 	}
 
-	// The corresponding columns and rows are deleted
+	// Indices of degrees of freedom that are subject to symmetry conditions
 	UnsignedType sizeIndicesSymmetry = INDICES_SYMMETRY_CONDITION.size();
 	for (UnsignedType index = sizeIndicesSymmetry - 1; index-- > 0; )
 	{
 		UnsignedType rowNum = INDICES_SYMMETRY_CONDITION[index];
-
 		matrixStiffness.eraseRow(rowNum);
 		matrixMass.eraseRow(rowNum);
+	}
+
+	for (UnsignedType index = sizeIndicesSymmetry - 1; index-- > 0;)
+	{
+		UnsignedType columnNum = INDICES_SYMMETRY_CONDITION[index];
+		matrixStiffness.eraseColumn(columnNum);
+		matrixMass.eraseColumn(columnNum);
+	}
+}
+
+// The context of a new run, the symmetry conditions are applied to the
+// matrices and to the context
+static SolverContext makeContextConditions(const SimulationConfig& config,
+	RealMatrix& matrixStiffness, RealMatrix& matrixMass,
+	const RealVector& initialDisplacements)
+{
+	MFE_PROFILE_SCOPE(PROFILE_CONDITIONS);
+
+	const UnsignedType rowsStiffness = matrixStiffness.sizeRows();
+	RealVector force(rowsStiffness, 0.0);
+
+	SolverContext context = makeSolverContext(config, rowsStiffness);
+	context.displacement = initialDisplacements;
+
+	boundConditionsDinamic(matrixStiffness, matrixMass, context.displacement,
+		context.speed, context.acceleration, force);
+
+	return context;
+}
+
+static void beginSink(ResultSink& sink, const SimulationConfig& config,
+	const UnsignedType& stepsCount, const UnsignedType& dofCount,
+	const UnsignedType& firstStep)
+{
+	MFE_PROFILE_SCOPE(PROFILE_OUTPUT);
+
+	SinkHeader header;
+	header.deltaT = config.deltaT;
+	header.stepsCount = stepsCount - std::min(firstStep, stepsCount);
+	header.dofCount = dofCount;
+	header.firstStep = firstStep;
+	sink.begin(header);
+}
+
+// The checkpoint of the run with the parameters of the step, the state is
+// set when the checkpoint is written
+static Checkpoint makeRunCheckpoint(const SimulationConfig& config,
+	const IntegratorParameters& integrator, const RealMatrix& matrixStiffness,
+	const RealMatrix& matrixMass)
+{
+	Checkpoint checkpoint;
+	if (config.checkpointFile.empty())
+		return checkpoint;
+
+	checkpoint.config = config;
+	checkpoint.integrator = integrator;
+	checkpoint.dofCount = matrixStiffness.sizeRows();
+	checkpoint.matrixHash = hashMatrices(matrixStiffness, matrixMass);
+
+	return checkpoint;
+}
+
+// Writing the checkpoint every checkpointInterval steps (the state before
+// the step is recorded). The run is not stopped if the file is not written.
+static void saveCheckpoint(Checkpoint& checkpoint, const SolverContext& context,
+	const UnsignedType& firstStep)
+{
+	const UnsignedType& interval = checkpoint.config.checkpointInterval;
+	if (interval == 0 || context.step == firstStep ||
+		context.step % interval != 0)
+		return;
+
+	checkpoint.context = context;
+	checkpoint.isStepRecorded = false;
+	writeCheckpoint(checkpoint, checkpoint.config.checkpointFile);
+}
+
+// Recording the last step (it is not recorded in the loop), the checkpoint
+// of the end of the run and the end of the results
+static void endSink(ResultSink& sink, const SolverContext& context,
+	const UnsignedType& stepsCount, Checkpoint& checkpoint)
+{
+	MFE_PROFILE_SCOPE(PROFILE_OUTPUT);
+
+	if (stepsCount != 0)
+		sink.record(context.step, context.displacement, context.isStuck);
+
+	if (!checkpoint.config.checkpointFile.empty() && stepsCount != 0)
+	{
+		checkpoint.context = context;
+		checkpoint.isStepRecorded = true;
+		writeCheckpoint(checkpoint, checkpoint.config.checkpointFile);
+	}
+
+	sink.end();
+}
+
+namespace
+{
+	// The sink of the continued run: the step of the checkpoint is not passed
+	// to the target if it was recorded by the previous run
+	class RestartSink : public ResultSink
+	{
+	public:
+
+		RestartSink(ResultSink& target, const Checkpoint& checkpoint) :
+			m_target(target), m_step(checkpoint.context.step),
+			m_isSkipped(checkpoint.isStepRecorded) {}
+
+		void begin(const SinkHeader& header) override
+		{
+			SinkHeader headerTarget = header;
+			if (m_isSkipped && header.stepsCount != 0)
+			{
+				--headerTarget.stepsCount;
+				++headerTarget.firstStep;
+			}
+
+			m_target.begin(headerTarget);
+		}
+
+		void record(const UnsignedType& step,
+			const RealVector& displacement, const bool& isStuck) override
+		{
+			if (m_isSkipped && step == m_step)
+				return;
+
+			m_target.record(step, displacement, isStuck);
+		}
+
+		void end() override
+		{
+			m_target.end();
+		}
+
+	private:
+
+		ResultSink& m_target;
+		UnsignedType m_step = 0;
+		bool m_isSkipped = false;
+
+	};
+}
+
+// The solver of the friction mode of the configuration from the context
+static void solveFromContext(const SimulationConfig& config,
+	const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+	const SolverContext& context, ResultSink& sink)
+{
+	switch (config.frictionMode)
+	{
+		case FRICTION_DRY_FREE:
+		{
+			dryFrictionFree(config, matrixStiffness, matrixMass, context, sink);
+			break;
+		}
+		case FRICTION_DRY_DRIVE:
+		{
+			forcedDryFriction(config, matrixStiffness, matrixMass, context, sink);
+			break;
+		}
+		case FRICTION_VISCOUS_DRIVE:
+		{
+			viscousFrictionForce(config, matrixStiffness, matrixMass,
+				context, sink);
+			break;
+		}
+		default:
+		{
+			std::string msg = "Unknown friction mode. ";
+			ERROR(msg);
+		}
+	}
+}
+
+// Continuing the run from the checkpoint of the restart file: the symmetry
+// conditions are applied to the matrices as in a new run, the matrices and
+// the problem are checked by the checkpoint
+static void restartDisplacementsDinamic(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass, ResultSink& sink)
+{
+	const Checkpoint checkpoint = readCheckpoint(config.restartFile);
+
+	{
+		MFE_PROFILE_SCOPE(PROFILE_CONDITIONS);
+		boundConditionsMatrices(matrixStiffness, matrixMass);
+	}
+
+	checkRestart(checkpoint, config, getIntegratorParameters(config),
+		matrixStiffness.sizeRows(), hashMatrices(matrixStiffness, matrixMass));
+
+	RestartSink restartSink(sink, checkpoint);
+	solveFromContext(config, matrixStiffness, matrixMass, checkpoint.context,
+		restartSink);
+}
+
+// The context of a new run with the initial speed and acceleration
+SolverContext MFE::makeSolverContext(const SimulationConfig& config,
+	const UnsignedType& size)
+{
+	SolverContext context;
+	context.acceleration = makeInitialAccel(size, config.initialAcceleration);
+	context.speed = makeInitialSpeed(size, config.initialSpeed);
+	context.isAccelInitialNoZero = checkAccelInitialNoZero(context.acceleration);
+
+	return context;
+}
+
+// Applying symmetry conditions to symmetry nodes for a dynamic problem
+void MFE::boundConditionsDinamic(RealMatrix& matrixStiffness,
+	RealMatrix& matrixMass, RealMatrix& displacements,
+	RealVector& speed, RealVector& acceleration,
+	RealVector& force)
+{
+	boundConditionsMatrices(matrixStiffness, matrixMass);
+
+	// The corresponding elements of the vectors and columns of the
+	// displacements are deleted
+	UnsignedType sizeIndicesSymmetry = INDICES_SYMMETRY_CONDITION.size();
+	for (UnsignedType index = sizeIndicesSymmetry - 1; index-- > 0; )
+	{
+		UnsignedType rowNum = INDICES_SYMMETRY_CONDITION[index];
 
 		if (rowNum < speed.size() && rowNum < acceleration.size() &&
 			rowNum < force.size())
@@ -102,73 +367,126 @@ void MFE::boundConditionsDinamic(RealMatrix& matrixStiffness,
 	for (UnsignedType index = sizeIndicesSymmetry - 1; index-- > 0;)
 	{
 		UnsignedType columnNum = INDICES_SYMMETRY_CONDITION[index];
-		matrixStiffness.eraseColumn(columnNum);
-		matrixMass.eraseColumn(columnNum);
 		displacements.eraseColumn(columnNum);
 	}
 }
 
+// Applying symmetry conditions for a dynamic problem to one displacement vector
+void MFE::boundConditionsDinamic(RealMatrix& matrixStiffness,
+	RealMatrix& matrixMass, RealVector& displacement,
+	RealVector& speed, RealVector& acceleration,
+	RealVector& force)
+{
+	if (displacement.size() != matrixStiffness.sizeRows())
+	{
+		std::string msg = "The size of the displacement vector is not equal "
+			"to the size of the stiffness matrix. ";
+		ERROR(msg);
+	}
+
+	RealMatrix displacements(1, displacement.size());
+	displacements[0] = displacement;
+
+	boundConditionsDinamic(matrixStiffness, matrixMass, displacements,
+		speed, acceleration, force);
+
+	displacement = displacements[0];
+}
+
 // A function that solves the problem of dry friction without forcing force.
-void MFE::dryFrictionFree(const UnsignedType& stepsCount, const Real& deltaT,
+void MFE::dryFrictionFree(const SimulationConfig& config,
 	RealMatrix matrixStiffness, RealMatrix matrixMass,
-	RealMatrix& displacements)
+	RealVector initialDisplacements, ResultSink& sink)
 {
-	Real coeffDryFrictionRest = 0.0;
-	Real coeffDryFrictionSliding = 0.0;
-	std::cout << "Input coefficient of dry friction at rest \n";
-	inputValue(coeffDryFrictionRest);
+	const SolverContext context = makeContextConditions(config,
+		matrixStiffness, matrixMass, initialDisplacements);
 
-	std::cout << "Input coefficient of dry friction at sliding \n";
-	inputValue(coeffDryFrictionSliding);
+	dryFrictionFree(config, matrixStiffness, matrixMass, context, sink);
+}
 
-	UnsignedType rowsStiffness = matrixStiffness.sizeRows();
-	RealVector force(rowsStiffness, 0.0);
+// A function that solves the problem of dry friction with a driving force
+void MFE::forcedDryFriction(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass,
+	RealVector initialDisplacements, ResultSink& sink)
+{
+	const SolverContext context = makeContextConditions(config,
+		matrixStiffness, matrixMass, initialDisplacements);
 
-	RealVector accelerationOld =
-		makeInitialAccel(rowsStiffness);
-	RealVector speedOld = makeInitialSpeed(rowsStiffness);
+	forcedDryFriction(config, matrixStiffness, matrixMass, context, sink);
+}
 
-	bool accelInitialNoZero = checkAccelInitialNoZero(accelerationOld);
+void MFE::viscousFrictionForce(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass,
+	RealVector initialDisplacements, ResultSink& sink)
+{
+	const SolverContext context = makeContextConditions(config,
+		matrixStiffness, matrixMass, initialDisplacements);
 
-	boundConditionsDinamic(matrixStiffness, matrixMass, displacements,
-		speedOld, accelerationOld, force);
+	viscousFrictionForce(config, matrixStiffness, matrixMass, context, sink);
+}
 
-	rowsStiffness = matrixStiffness.sizeRows();
-	RealVector speedNew(rowsStiffness, 0);
-	RealVector accelerationNew(rowsStiffness, 0);
-	Real averagePointsSpeedOld = 0.0;
+// The problem of dry friction without forcing force from the context
+void MFE::dryFrictionFree(const SimulationConfig& config,
+	const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+	SolverContext context, ResultSink& sink)
+{
+	const UnsignedType stepsCount = getStepsCount(config);
+	const Real& deltaT = config.deltaT;
+	const Real& coeffDryFrictionRest = config.coeffDryFrictionRest;
+	const Real& coeffDryFrictionSliding = config.coeffDryFrictionSliding;
+	const Real& normalReaction = config.normalReaction;
+	const IntegratorParameters integrator = getIntegratorParameters(config);
+
+	const UnsignedType rowsStiffness = matrixStiffness.sizeRows();
+	checkContext(context, rowsStiffness, stepsCount);
+	RealVector force(rowsStiffness, 0.0);
 
-	UnsignedType forceSizeAfterConds = force.size();
-	for (UnsignedType step = 0; step < stepsCount - 1; ++step)
+	// There is no damping in the problem of dry friction
+	const RealMatrix matrixDamping;
+	const RealMatrix matrixCoeffs = makeMatrixCoeffsIntegrator(integrator,
+		deltaT, matrixStiffness, matrixMass, matrixDamping);
+
+	Checkpoint checkpoint = makeRunCheckpoint(config, integrator,
+		matrixStiffness, matrixMass);
+
+	const UnsignedType forceSizeAfterConds = force.size();
+	const UnsignedType firstStep = context.step;
+	RealVector displacementNew(forceSizeAfterConds, 0.0);
+	beginSink(sink, config, stepsCount, forceSizeAfterConds, firstStep);
+
+	for (; context.step + 1 < stepsCount; ++context.step)
 	{
-		setForceNormReaction(force, NO_DRIVE_FORCE_DRY);
+		MFE_PROFILE_LAP(profileLap, PROFILE_OUTPUT);
+		saveCheckpoint(checkpoint, context, firstStep);
+
+		MFE_PROFILE_NEXT(profileLap, PROFILE_FORCE);
+		const UnsignedType step = context.step;
+		const RealVector& displacement = context.displacement;
 
-		Real alphaDt2 = ALPHA * pow(deltaT, 2);
-		Real alphaDt = ALPHA * deltaT;
+		setForceNormReaction(force, normalReaction);
 
-		setForceElastic(displacements[step], matrixStiffness, force);
+		setForceElastic(displacement, matrixStiffness, force);
 
 		Real elasticForceSum =
-			getElasticForceSum(displacements[step], matrixStiffness);
+			getElasticForceSum(displacement, matrixStiffness);
 
-		Real averagePointsSpeed = getAveragePointsSpeed(speedOld);
+		Real averagePointsSpeed = getAveragePointsSpeed(context.speed);
 
 		Real signForce = getSignFrictionFree(elasticForceSum, averagePointsSpeed);
 
 		Real frictionForceSum = 
 			getSumFrictionForce(signForce, coeffDryFrictionRest,
-			coeffDryFrictionSliding, averagePointsSpeed,
-				NO_DRIVE_FORCE_DRY);
+			coeffDryFrictionSliding, averagePointsSpeed, normalReaction);
 
 		setForceDry(frictionForceSum, force);
 
 		// Check for sticking - projection of all forces on the KSI axis and average speed
 		bool isFrictionGreater = abs(frictionForceSum) >= abs(elasticForceSum);
 		bool isLowSpeed = abs(averagePointsSpeed) <= EPS &&
-			abs(averagePointsSpeedOld) <= EPS;
+			abs(context.averagePointsSpeedOld) <= EPS;
 
 		Real resultantForce = getResultantForce(force);
-		bool isGoodResultantForce = checkInaccuracy(resultantForce);
+		bool isGoodResultantForce = checkInaccuracy(context, resultantForce);
 		if (!isGoodResultantForce)
 		{
 			std::string msgInaccuracy = "Inaccuracy of calculations or plastic output \n"
@@ -176,107 +494,98 @@ void MFE::dryFrictionFree(const UnsignedType& stepsCount, const Real& deltaT,
 			std::cout << msgInaccuracy;
 
 			WARNING(msgInaccuracy);
-			displacements.resizeRows(step);
+			sink.end();
 			return;
 		}
 
-		if (isFrictionGreater && isLowSpeed && !accelInitialNoZero)
+		MFE_PROFILE_NEXT(profileLap, PROFILE_OUTPUT);
+		sink.record(step, displacement, context.isStuck);
+
+		MFE_PROFILE_NEXT(profileLap, PROFILE_UPDATE);
+		MFE_PROFILE_COUNT(PROFILE_STEPS, 1);
+		if (isFrictionGreater && isLowSpeed && !context.isAccelInitialNoZero)
 		{
 			// The knot is sticking
-			displacements[step + 1] = displacements[step];
-			speedOld = RealVector(rowsStiffness, 0.0);
-			accelerationOld = RealVector(rowsStiffness, 0.0);
+			displacementNew = displacement;
+			context.speed = RealVector(rowsStiffness, 0.0);
+			context.acceleration = RealVector(rowsStiffness, 0.0);
+			context.isStuck = true;
+			MFE_PROFILE_COUNT(PROFILE_STUCK_STEPS, 1);
 		}
 		else
 		{
-			// Formulas are used according to the Newmor method and
+			// Formulas are used according to the time integrator and
 			// finite differences.
 			// Displacements are calculated using the reflection method.
-			RealVector columnFreeMembers = alphaDt2 * force;
-			columnFreeMembers += matrixMass * (displacements[step] +
-				deltaT * (speedOld - (ALPHA - 0.5) * deltaT * accelerationOld));
-
-			RealMatrix matrixCoefficients = 
-				matrixMass + alphaDt2 * matrixStiffness;
-
-			displacements[step + 1] = 
-				solveReflectionMethod(matrixCoefficients, columnFreeMembers);
-
-			RealVector differenceDisps =
-				displacements[step + 1] - displacements[step];
-
-			accelerationNew = 1.0 / alphaDt2 * differenceDisps;
-			accelerationNew -= 1.0 / alphaDt * speedOld;
-			accelerationNew += (1.0 - 0.5 / ALPHA) * accelerationOld;
-
-			speedNew = (DELTA / alphaDt) * differenceDisps;
-			speedNew += (1.0 - DELTA / ALPHA) * speedOld;
-			speedNew += (1.0 - 0.5 * DELTA / ALPHA) * deltaT * accelerationOld;
-
-			speedOld = speedNew;
-			accelerationOld = accelerationNew;
-
+			stepIntegrator(integrator, deltaT, matrixStiffness, matrixMass,
+				matrixDamping, matrixCoeffs, force, displacement,
+				displacementNew, context.speed, context.acceleration);
+			context.isStuck = false;
+			MFE_PROFILE_COUNT(PROFILE_SLIDING_STEPS, 1);
 		}
-		accelInitialNoZero = false;
-		averagePointsSpeedOld = averagePointsSpeed;
+
+		std::swap(context.displacement, displacementNew);
+		context.isAccelInitialNoZero = false;
+		context.averagePointsSpeedOld = averagePointsSpeed;
 		force.clear();
 		force.resize(forceSizeAfterConds, 0.0);
 	}
+
+	endSink(sink, context, stepsCount, checkpoint);
 }
 
-// A function that solves the problem of dry friction with a driving force
-void MFE::forcedDryFriction(const UnsignedType& stepsCount, const Real& deltaT,
-	RealMatrix matrixStiffness, RealMatrix matrixMass,
-	RealMatrix& displacements)
+// The problem of dry friction with a driving force from the context
+void MFE::forcedDryFriction(const SimulationConfig& config,
+	const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+	SolverContext context, ResultSink& sink)
 {
-	Real coeffDryFrictionRest = 0.0;
-	Real coeffDryFrictionSliding = 0.0;
-	std::cout << "Input coefficient of dry friction at rest \n";
-	inputValue(coeffDryFrictionRest);
+	const UnsignedType stepsCount = getStepsCount(config);
+	const Real& deltaT = config.deltaT;
+	const Real& coeffDryFrictionRest = config.coeffDryFrictionRest;
+	const Real& coeffDryFrictionSliding = config.coeffDryFrictionSliding;
+	const Real& normalReaction = config.normalReaction;
+	const IntegratorParameters integrator = getIntegratorParameters(config);
 
-	std::cout << "Input coefficient of dry friction at sliding \n";
-	inputValue(coeffDryFrictionSliding);
-
-	UnsignedType rowsStiffness = matrixStiffness.sizeRows();
+	const UnsignedType rowsStiffness = matrixStiffness.sizeRows();
+	checkContext(context, rowsStiffness, stepsCount);
 	RealVector force(rowsStiffness, 0.0);
 
-	RealVector accelerationOld =
-		makeInitialAccel(rowsStiffness);
-	RealVector speedOld = makeInitialSpeed(rowsStiffness);
+	Real frequency = getFrequencyForce(config);
 
-	bool accelInitialNoZero = checkAccelInitialNoZero(accelerationOld);
+	Real nodeLoad = getNodeLoad(config.amplitudeForce);
 
-	boundConditionsDinamic(matrixStiffness, matrixMass, displacements,
-		speedOld, accelerationOld, force);
+	// There is no damping in the problem of dry friction
+	const RealMatrix matrixDamping;
+	const RealMatrix matrixCoeffs = makeMatrixCoeffsIntegrator(integrator,
+		deltaT, matrixStiffness, matrixMass, matrixDamping);
 
-	rowsStiffness = matrixStiffness.sizeRows();
-	Real averagePointsSpeedOld = 0.0;
+	Checkpoint checkpoint = makeRunCheckpoint(config, integrator,
+		matrixStiffness, matrixMass);
 
-	Real frequency = getFrequencyForce(HAS_DRIVE_FORCE_DRY);
+	const UnsignedType forceSizeAfterConds = force.size();
+	const UnsignedType firstStep = context.step;
+	RealVector displacementNew(forceSizeAfterConds, 0.0);
+	beginSink(sink, config, stepsCount, forceSizeAfterConds, firstStep);
 
-	Real amplitudeForce = getAmplitudeForce(DRIVE_FORCE_DRY);
-
-	Real nodeLoad = getNodeLoad(amplitudeForce);
-	RealVector speedNew(rowsStiffness, 0);
-	RealVector accelerationNew(rowsStiffness, 0);
-
-	UnsignedType forceSizeAfterConds = force.size();
-	Real sumSteps = 0.0;
 	Real signForce = 0;
-	for (UnsignedType step = 0; step < stepsCount - 1; ++step)
+	for (; context.step + 1 < stepsCount; ++context.step)
 	{
-		setForceNormReaction(force, HAS_DRIVE_FORCE_DRY);
+		MFE_PROFILE_LAP(profileLap, PROFILE_OUTPUT);
+		saveCheckpoint(checkpoint, context, firstStep);
 
-		Real alphaDt2 = ALPHA * pow(deltaT, 2);
-		Real alphaDt = ALPHA * deltaT;
+		MFE_PROFILE_NEXT(profileLap, PROFILE_FORCE);
+		const UnsignedType step = context.step;
+		const RealVector& displacement = context.displacement;
 
-		Real driveForceNode = nodeLoad * cos(frequency * sumSteps);
+		setForceNormReaction(force, normalReaction);
+
+		Real driveForceNode = nodeLoad * cos(frequency * context.sumSteps);
 		Real elasticForceSum =
-			getElasticForceSum(displacements[step], matrixStiffness);
+			getElasticForceSum(displacement, matrixStiffness);
 
-		setForceElastic(displacements[step], matrixStiffness, force);
+		setForceElastic(displacement, matrixStiffness, force);
 
-		Real averagePointsSpeed = getAveragePointsSpeed(speedOld);
+		Real averagePointsSpeed = getAveragePointsSpeed(context.speed);
 
 		signForce = getSignFrictionDrive(elasticForceSum, averagePointsSpeed,
 			driveForceNode);
@@ -284,14 +593,13 @@ void MFE::forcedDryFriction(const UnsignedType& stepsCount, const Real& deltaT,
 		// Check for sticking - projection of all forces on the KSI axis
 		Real frictionForceSum =
 			getSumFrictionForce(signForce, coeffDryFrictionRest,
-			coeffDryFrictionSliding, averagePointsSpeed,
-				HAS_DRIVE_FORCE_DRY);
+			coeffDryFrictionSliding, averagePointsSpeed, normalReaction);
 
 		setForceDriveDry(frictionForceSum,
 			driveForceNode, force);
 
 		bool lowSpeedCondition = 
-			isLowSpeedElement(averagePointsSpeedOld, averagePointsSpeed);
+			isLowSpeedElement(context.averagePointsSpeedOld, averagePointsSpeed);
 
 		bool elasticForceCondition = isLowElasticForce(elasticForceSum,
 			driveForceNode, frictionForceSum, signForce);
@@ -309,215 +617,262 @@ void MFE::forcedDryFriction(const UnsignedType& stepsCount, const Real& deltaT,
 			driveElSignCondition;
 
 		Real resultantForce = getResultantForce(force);
-		bool isGoodResultantForce = checkInaccuracy(resultantForce);
+		bool isGoodResultantForce = checkInaccuracy(context, resultantForce);
 		if (!isGoodResultantForce)
 		{
 			std::string msgInaccuracy = "Inaccuracy of calculations or plastic output \n"
 				"(try changing the time step) \n\n";
 			WARNING(msgInaccuracy);
-			displacements.resizeRows(step);
+			sink.end();
 			return;
 		}
 
+		MFE_PROFILE_NEXT(profileLap, PROFILE_OUTPUT);
+		sink.record(step, displacement, context.isStuck);
+
+		MFE_PROFILE_NEXT(profileLap, PROFILE_UPDATE);
+		MFE_PROFILE_COUNT(PROFILE_STEPS, 1);
 		if (lowSpeedCondition &&
 			(elasticForceCondition || driveForceCondition ||
-				driveElasticCondition) && !accelInitialNoZero)
+				driveElasticCondition) && !context.isAccelInitialNoZero)
 		{
 			// The knot is sticking
-			displacements[step + 1] = displacements[step];
-			speedNew = RealVector(rowsStiffness, 0.0);
-			accelerationNew = RealVector(rowsStiffness, 0.0);
+			displacementNew = displacement;
+			context.speed = RealVector(rowsStiffness, 0.0);
+			context.acceleration = RealVector(rowsStiffness, 0.0);
+			context.isStuck = true;
+			MFE_PROFILE_COUNT(PROFILE_STUCK_STEPS, 1);
 		}
 		else
 		{
-			// Formulas are used according to the Newmor method and
+			// Formulas are used according to the time integrator and
 			// finite differences.
 			// Displacements are calculated using the reflection method.
-			RealVector accelTerm = (ALPHA - 0.5) * deltaT * accelerationOld;
-
-			RealVector innerSum = displacements[step] +
-				deltaT * (speedOld - accelTerm);
-
-			RealVector freeMembers = alphaDt2 * force + matrixMass * innerSum;
-
-
-			RealMatrix matrixCoeffs = matrixMass + alphaDt2 * matrixStiffness;
-
-			displacements[step + 1] = solveReflectionMethod(matrixCoeffs, freeMembers);
-			RealVector differenceDisps =
-				displacements[step + 1] - displacements[step];
-
-			if (ALPHA == 0 || deltaT == 0)
-			{
-				std::string msg = messageDivideZero();
-				ERROR(msg);
-			}
-
-			accelerationNew = 1.0 / alphaDt2 * differenceDisps;
-			accelerationNew -= 1.0 / alphaDt * speedOld;
-			accelerationNew += ((1.0 - 0.5 / ALPHA) * accelerationOld);
-
-			speedNew = (DELTA / alphaDt) * differenceDisps;
-			speedNew += (1.0 - DELTA / ALPHA) * speedOld;
-			speedNew += (1.0 - (DELTA * 0.5) /  ALPHA) * deltaT * accelerationOld;
-
+			stepIntegrator(integrator, deltaT, matrixStiffness, matrixMass,
+				matrixDamping, matrixCoeffs, force, displacement,
+				displacementNew, context.speed, context.acceleration);
+			context.isStuck = false;
+			MFE_PROFILE_COUNT(PROFILE_SLIDING_STEPS, 1);
 		}
 
-		accelInitialNoZero = false;
-		speedOld = speedNew;
-		accelerationOld = accelerationNew;
-		averagePointsSpeedOld = averagePointsSpeed;
-		sumSteps += deltaT;
+		std::swap(context.displacement, displacementNew);
+
+		context.isAccelInitialNoZero = false;
+		context.averagePointsSpeedOld = averagePointsSpeed;
+		context.sumSteps += deltaT;
 		force.clear();
 		force.resize(forceSizeAfterConds, 0.0);
 	}
+
+	endSink(sink, context, stepsCount, checkpoint);
 }
 
-void MFE::viscousFrictionForce(const UnsignedType& stepsCount, const Real& deltaT,
-	RealMatrix matrixStiffness, RealMatrix matrixMass,
-	RealMatrix& displacements)
+// The problem of viscous friction with a driving force from the context
+void MFE::viscousFrictionForce(const SimulationConfig& config,
+	const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+	SolverContext context, ResultSink& sink)
 {
-	Real coeffViscousfriction = 0.0;
-	std::cout << "Input coefficient viscous friction:" << "\n";
-	inputValue(coeffViscousfriction);
+	const UnsignedType stepsCount = getStepsCount(config);
+	const Real& deltaT = config.deltaT;
+	const Real& coeffViscousfriction = config.coeffViscousFriction;
+	const IntegratorParameters integrator = getIntegratorParameters(config);
 
 	const UnsignedType rowsStiffness = matrixStiffness.sizeRows();
-	RealVector accelerationOld =
-		makeInitialAccel(rowsStiffness);
-	RealVector speedOld = makeInitialSpeed(rowsStiffness);
-
+	checkContext(context, rowsStiffness, stepsCount);
 	RealVector force(rowsStiffness, 0.0);
-	boundConditionsDinamic(matrixStiffness, matrixMass, displacements,
-		speedOld, accelerationOld, force);
 
-	Real frequency = getFrequencyForce(DRIVE_FORCE_NO_DRY);
+	Real frequency = getFrequencyForce(config);
 
-	Real amplitudeForce = getAmplitudeForce(DRIVE_FORCE_NO_DRY);
+	Real nodeLoad = getNodeLoad(config.amplitudeForce);
 
-	Real nodeLoad = getNodeLoad(amplitudeForce);
+	// Viscous friction is proportional to the mass
+	const RealMatrix matrixDamping = coeffViscousfriction * matrixMass;
+	const RealMatrix matrixCoeffs = makeMatrixCoeffsIntegrator(integrator,
+		deltaT, matrixStiffness, matrixMass, matrixDamping);
 
-	RealVector speedNew(rowsStiffness, 0);
-	RealVector accelerationNew(rowsStiffness, 0);
+	Checkpoint checkpoint = makeRunCheckpoint(config, integrator,
+		matrixStiffness, matrixMass);
 
-	UnsignedType forceSizeAfterConds = force.size();
-	Real sumSteps = 0.0;
+	const UnsignedType forceSizeAfterConds = force.size();
+	const UnsignedType firstStep = context.step;
+	RealVector displacementNew(forceSizeAfterConds, 0.0);
+	beginSink(sink, config, stepsCount, forceSizeAfterConds, firstStep);
 
-	// Formulas are used according to the Newmor method and
+
+	// Formulas are used according to the time integrator and
 	// finite differences.
 	// Displacements are calculated using the reflection method.
-	for (UnsignedType step = 0; step < stepsCount - 1; ++step)
+	for (; context.step + 1 < stepsCount; ++context.step)
 	{
-		Real alphaDt2 = ALPHA * pow(deltaT, 2);
-		Real alphaDt = ALPHA * deltaT;
+		MFE_PROFILE_LAP(profileLap, PROFILE_OUTPUT);
+		saveCheckpoint(checkpoint, context, firstStep);
+
+		MFE_PROFILE_NEXT(profileLap, PROFILE_FORCE);
+		const UnsignedType step = context.step;
+		const RealVector& displacement = context.displacement;
 
-		setForceViscous(nodeLoad, frequency, sumSteps, force);
+		setForceViscous(nodeLoad, frequency, context.sumSteps, force);
 
 		Real resultantForce = getResultantForce(force);
-		bool isGoodResultantForce = checkInaccuracy(resultantForce);
+		bool isGoodResultantForce = checkInaccuracy(context, resultantForce);
 		if (!isGoodResultantForce)
 		{
 			std::string msgInaccuracy = "Inaccuracy of calculations or plastic output \n"
 										"(try changing the time step) \n\n";
 			WARNING(msgInaccuracy);
-			displacements.resizeRows(step);
+			sink.end();
 			return;
 		}
 
-		RealVector dampingTerm = 
-			DELTA * coeffViscousfriction * displacements[step];
-
-		RealVector speedTerm = 
-			speedOld * (1.0 + (DELTA - ALPHA) * deltaT * coeffViscousfriction);
-
-		RealVector accelTerm = accelerationOld * ((ALPHA - 0.5) - 
-			deltaT * (ALPHA - DELTA * 0.5) * coeffViscousfriction);
+		MFE_PROFILE_NEXT(profileLap, PROFILE_OUTPUT);
+		sink.record(step, displacement, context.isStuck);
 
-		RealVector innerSumFreeMembers = displacements[step] +
-			deltaT * (dampingTerm + speedTerm - deltaT * accelTerm);
+		MFE_PROFILE_NEXT(profileLap, PROFILE_UPDATE);
+		MFE_PROFILE_COUNT(PROFILE_STEPS, 1);
+		MFE_PROFILE_COUNT(PROFILE_SLIDING_STEPS, 1);
+		stepIntegrator(integrator, deltaT, matrixStiffness, matrixMass,
+			matrixDamping, matrixCoeffs, force, displacement,
+			displacementNew, context.speed, context.acceleration);
+		std::swap(context.displacement, displacementNew);
 
-		RealVector freeMembers = alphaDt2 * force + 
-			matrixMass * innerSumFreeMembers;
-	
+		context.sumSteps += deltaT;
 
-		RealMatrix innerSumMatrixCoeffs = alphaDt * matrixStiffness +
-			DELTA * coeffViscousfriction * matrixMass;
-
-		RealMatrix matrixCoeffs = matrixMass + deltaT * innerSumMatrixCoeffs;
-
-		displacements[step + 1] = solveReflectionMethod(matrixCoeffs, freeMembers);
-
-		RealVector differenceDisps =
-			displacements[step + 1] - displacements[step];
-
-		if (ALPHA == 0 || deltaT == 0)
-		{
-			std::string msg = messageDivideZero();
-			ERROR(msg);
-		}
+		force.clear();
+		force.resize(forceSizeAfterConds, 0.0);
+	}
 
-		accelerationNew = 1.0 / alphaDt2 * differenceDisps;
-		accelerationNew -= (1.0 / alphaDt) * speedOld;
-		accelerationNew += (1.0 - 0.5 / ALPHA) * accelerationOld;
+	endSink(sink, context, stepsCount, checkpoint);
+}
 
-		speedNew = (DELTA / alphaDt) * differenceDisps;
-		speedNew += (1.0 - DELTA / ALPHA) * speedOld;
-		speedNew += (1.0 - (0.5 * DELTA) / ALPHA) * deltaT * accelerationOld;
+// The solvers with the displacement matrix: the steps are recorded in memory
+void MFE::dryFrictionFree(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass,
+	RealMatrix& displacements)
+{
+	MemorySink sink;
+	dryFrictionFree(config, matrixStiffness, matrixMass,
+		getFirstRow(displacements, matrixStiffness.sizeRows()), sink);
+	displacements = sink.getDisplacements();
+}
 
-		speedOld = speedNew;
-		accelerationOld = accelerationNew;
-		sumSteps += deltaT;
+void MFE::forcedDryFriction(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass,
+	RealMatrix& displacements)
+{
+	MemorySink sink;
+	forcedDryFriction(config, matrixStiffness, matrixMass,
+		getFirstRow(displacements, matrixStiffness.sizeRows()), sink);
+	displacements = sink.getDisplacements();
+}
 
-		force.clear();
-		force.resize(forceSizeAfterConds, 0.0);
-	}
+void MFE::viscousFrictionForce(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass,
+	RealMatrix& displacements)
+{
+	MemorySink sink;
+	viscousFrictionForce(config, matrixStiffness, matrixMass,
+		getFirstRow(displacements, matrixStiffness.sizeRows()), sink);
+	displacements = sink.getDisplacements();
 }
 
 // Solver for a dinamic problem
-RealMatrix MFE::calculateDisplacementsDinamic
-(const Real& time, const Real& deltaT,
-	RealMatrix matrixStiffness, RealMatrix matrixMass)
+void MFE::calculateDisplacementsDinamic(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass, ResultSink& sink)
 {
-	RealVector initialDisplacements =
-		makeInitialDisps(matrixStiffness);
+	MFE_PROFILE_RUN(config.name, config.profileFile);
 
-	if (deltaT <= DBL_EPSILON)
+	if (config.deltaT <= DBL_EPSILON)
 	{
 		std::string msg = messageDivideZero();
 		ERROR(msg);
 	}
 
-	UnsignedType stepsCount = static_cast<UnsignedType> (time / deltaT);
-	const UnsignedType rowsStiffness = matrixStiffness.sizeRows();
-	RealMatrix displacements(stepsCount, rowsStiffness);
-	
-	if (displacements.sizeRows() != 0)
-		displacements[0] = initialDisplacements;
-	else
-		return RealMatrix(0, 0);
+	if (!config.restartFile.empty())
+	{
+		restartDisplacementsDinamic(config, matrixStiffness, matrixMass, sink);
+		return;
+	}
+
+	RealVector initialDisplacements =
+		makeInitialDisps(matrixStiffness, config.initialStaticLoad);
 
-	UnsignedType choice = getFrictionMode();
-	
-	switch (choice)
+	switch (config.frictionMode)
 	{
-		case 1:
+		case FRICTION_DRY_FREE:
 		{
-			dryFrictionFree(stepsCount, deltaT, matrixStiffness, matrixMass,
-				displacements);
+			dryFrictionFree(config, matrixStiffness, matrixMass,
+				initialDisplacements, sink);
 			break;
 		}
-		case 2:
+		case FRICTION_DRY_DRIVE:
 		{
-			forcedDryFriction(stepsCount, deltaT, matrixStiffness, matrixMass,
-				displacements);
+			forcedDryFriction(config, matrixStiffness, matrixMass,
+				initialDisplacements, sink);
 			break;
 		}
-		case 3:
+		case FRICTION_VISCOUS_DRIVE:
 		{
-			viscousFrictionForce(stepsCount, deltaT, matrixStiffness, matrixMass,
-				displacements);
+			viscousFrictionForce(config, matrixStiffness, matrixMass,
+				initialDisplacements, sink);
 			break;
 		}
+		default:
+		{
+			std::string msg = "Unknown friction mode. ";
+			ERROR(msg);
+		}
 	}
+}
+
+// Solver for a dinamic problem with the displacement matrix
+RealMatrix MFE::calculateDisplacementsDinamic(const SimulationConfig& config,
+	RealMatrix matrixStiffness, RealMatrix matrixMass)
+{
+	MemorySink sink;
+	calculateDisplacementsDinamic(config, matrixStiffness, matrixMass, sink);
+
+	return sink.getDisplacements();
+}
+
+// Solver for a dinamic problem with the parameters entered from the console
+RealMatrix MFE::calculateDisplacementsDinamic
+(const Real& time, const Real& deltaT,
+	RealMatrix matrixStiffness, RealMatrix matrixMass)
+{
+	SimulationConfig config;
+	config.time = time;
+	config.deltaT = deltaT;
+	inputSolverParameters(config);
+
+	return calculateDisplacementsDinamic(config, matrixStiffness, matrixMass);
+}
+
+// Simulation according to the configuration
+void MFE::runSimulation(const SimulationConfig& config, ResultSink& sink)
+{
+	MFE_PROFILE_RUN(config.name, config.profileFile);
+	validateConfig(config);
+
+	MFE_PROFILE_LAP(profileAssembly, PROFILE_ASSEMBLY);
+	// Matrix stiffness, the same elements of the sweeps are built once
+	ElementMatrixCache& cache = ElementMatrixCache::getInstance();
+	SharedMatrix matrixStiffness = cache.getStiffness(config.finiteElement);
+
+	const UnsignedType rows = matrixStiffness->sizeRows();
+	// Diagonal matrix mass final element
+	SharedMatrix matrixMassDiag = cache.getMassDiag(rows, config.finiteElement);
+	MFE_PROFILE_NEXT(profileAssembly, PROFILE_OTHER);
+
+	// The solver gets the copies, the boundary conditions change them
+	calculateDisplacementsDinamic(config, *matrixStiffness, *matrixMassDiag,
+		sink);
+}
+
+// Simulation according to the configuration with the displacement matrix
+RealMatrix MFE::runSimulation(const SimulationConfig& config)
+{
+	MemorySink sink;
+	runSimulation(config, sink);
 
-	return displacements;
+	return sink.getDisplacements();
 }
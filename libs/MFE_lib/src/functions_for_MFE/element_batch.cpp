@@ -0,0 +1,193 @@
+#include <MFE_lib/functions_for_MFE/element_batch.h>
+
+#include <algorithm>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+// The lanes are checked as the elements of makeMatrixStiffness
+static void checkElementBatch(const ElementBatch& batch)
+{
+	if (batch.count == 0 || batch.count > STIFFNESS_LANES)
+	{
+		std::string msg = "The batch must have from 1 to " +
+			std::to_string(STIFFNESS_LANES) + " elements. ";
+		ERROR(msg);
+	}
+
+	for (UnsignedType lane = 0; lane < batch.count; ++lane)
+	{
+		FiniteElement element;
+		element.poissonRatio = batch.poissonRatio[lane];
+		element.length = batch.length[lane];
+		element.width = batch.width[lane];
+		element.heigth = batch.heigth[lane];
+		checkStiffnessProperties(element);
+	}
+}
+
+ElementBatch MFE::makeElementBatch(const std::vector<FiniteElement>& elements,
+	const UnsignedType& first)
+{
+	if (first >= elements.size())
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	ElementBatch batch;
+	batch.count = std::min(STIFFNESS_LANES, elements.size() - first);
+	for (UnsignedType lane = 0; lane < batch.count; ++lane)
+	{
+		if (elements[first + lane].formulation != FORMULATION_FULL_INTEGRATION)
+		{
+			std::string msg = "The batch is only for the elements with the full "
+				"integration. ";
+			ERROR(msg);
+		}
+	}
+
+	// The unused lanes are the copies of the first element
+	for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+	{
+		const FiniteElement& element =
+			elements[first + (lane < batch.count ? lane : 0)];
+		batch.modulusElastic[lane] = element.modulusElastic;
+		batch.poissonRatio[lane] = element.poissonRatio;
+		batch.length[lane] = element.length;
+		batch.width[lane] = element.width;
+		batch.heigth[lane] = element.heigth;
+	}
+
+	return batch;
+}
+
+// The operations of makeMatrixStiffnessPerModulus and makeMatrixStiffness in
+// the same order, each one for all lanes
+void MFE::makeMatrixStiffnessBatch(const ElementBatch& batch,
+	BatchStiffness& result)
+{
+	checkElementBatch(batch);
+
+	const std::array<StiffnessLaneValues, ELEMENT_DIMENSIONS_COUNT> dimensions = {
+		batch.length, batch.width, batch.heigth };
+	const StiffnessLaneValues& poissonRatio = batch.poissonRatio;
+
+	StiffnessLaneValues normal;
+	StiffnessLaneValues lateral;
+	StiffnessLaneValues shear;
+	StiffnessLaneValues detMatrixJacobian;
+	for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+	{
+		normal[lane] = (1.0 - poissonRatio[lane]) /
+			(1.0 + poissonRatio[lane]) / (1.0 - 2.0 * poissonRatio[lane]);
+		lateral[lane] = poissonRatio[lane] /
+			(1.0 + poissonRatio[lane]) / (1.0 - 2.0 * poissonRatio[lane]);
+		shear[lane] = 1.0 / (2.0 * (1.0 + poissonRatio[lane]));
+		detMatrixJacobian[lane] = dimensions[0][lane] * dimensions[1][lane] *
+			dimensions[2][lane] / 8.0;
+	}
+
+	// detJ / (dim[p] * dim[q])
+	std::array<std::array<StiffnessLaneValues, ELEMENT_DIMENSIONS_COUNT>,
+		ELEMENT_DIMENSIONS_COUNT> factors;
+	for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+		++dimFirst)
+	{
+		for (UnsignedType dimSecond = 0; dimSecond < ELEMENT_DIMENSIONS_COUNT;
+			++dimSecond)
+		{
+			for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+			{
+				factors[dimFirst][dimSecond][lane] = detMatrixJacobian[lane] /
+					(dimensions[dimFirst][lane] * dimensions[dimSecond][lane]);
+			}
+		}
+	}
+
+	const StiffnessLaneValues& modulusElastic = batch.modulusElastic;
+	for (UnsignedType nodeFirst = 0; nodeFirst < ELEMENT_NODES_COUNT; ++nodeFirst)
+	{
+		for (UnsignedType nodeSecond = nodeFirst; nodeSecond < ELEMENT_NODES_COUNT;
+			++nodeSecond)
+		{
+			const auto& block = REFERENCE_BLOCKS[nodeFirst][nodeSecond];
+			std::array<StiffnessLaneValues, ELEMENT_DIMENSIONS_COUNT> diagonal;
+			StiffnessLaneValues diagonalSum;
+			for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+			{
+				for (UnsignedType dim = 0; dim < ELEMENT_DIMENSIONS_COUNT; ++dim)
+					diagonal[dim][lane] = block[dim][dim] * factors[dim][dim][lane];
+
+				diagonalSum[lane] = diagonal[0][lane] + diagonal[1][lane] +
+					diagonal[2][lane];
+			}
+
+			for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+				++dimFirst)
+			{
+				const UnsignedType rowNum =
+					nodeFirst * ELEMENT_DIMENSIONS_COUNT + dimFirst;
+				for (UnsignedType dimSecond = 0;
+					dimSecond < ELEMENT_DIMENSIONS_COUNT; ++dimSecond)
+				{
+					const UnsignedType columnNum =
+						nodeSecond * ELEMENT_DIMENSIONS_COUNT + dimSecond;
+					StiffnessLaneValues& values = result[rowNum][columnNum];
+					if (dimFirst == dimSecond)
+					{
+						for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+						{
+							values[lane] = modulusElastic[lane] *
+								(normal[lane] * diagonal[dimFirst][lane] +
+								shear[lane] * (diagonalSum[lane] - diagonal[dimFirst][lane]));
+						}
+					}
+					else
+					{
+						const Real blockLateral = block[dimFirst][dimSecond];
+						const Real blockShear = block[dimSecond][dimFirst];
+						for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+						{
+							values[lane] = modulusElastic[lane] *
+								((lateral[lane] * blockLateral + shear[lane] * blockShear) *
+								factors[dimFirst][dimSecond][lane]);
+						}
+					}
+
+					result[columnNum][rowNum] = values;
+				}
+			}
+		}
+	}
+}
+
+std::vector<RealMatrix> MFE::makeMatrixStiffnessBatch(
+	const std::vector<FiniteElement>& elements)
+{
+	std::vector<RealMatrix> matrices;
+	matrices.reserve(elements.size());
+
+	BatchStiffness stiffness;
+	for (UnsignedType first = 0; first < elements.size(); first += STIFFNESS_LANES)
+	{
+		const ElementBatch batch = makeElementBatch(elements, first);
+		makeMatrixStiffnessBatch(batch, stiffness);
+		for (UnsignedType lane = 0; lane < batch.count; ++lane)
+		{
+			RealMatrix matrix(ELEMENT_DOF_COUNT, ELEMENT_DOF_COUNT);
+			for (UnsignedType rowNum = 0; rowNum < ELEMENT_DOF_COUNT; ++rowNum)
+			{
+				for (UnsignedType columnNum = 0; columnNum < ELEMENT_DOF_COUNT;
+					++columnNum)
+				{
+					matrix[rowNum][columnNum] = stiffness[rowNum][columnNum][lane];
+				}
+			}
+			matrices.push_back(std::move(matrix));
+		}
+	}
+
+	return matrices;
+}
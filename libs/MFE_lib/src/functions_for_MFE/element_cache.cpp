@@ -0,0 +1,148 @@
+#include <MFE_lib/functions_for_MFE/element_cache.h>
+
+#include <cmath>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+// The fields, which are not finite, cannot be compared as the keys
+static bool isFiniteElement(const FiniteElement& finiteElement)
+{
+	return std::isfinite(finiteElement.modulusElastic) &&
+		std::isfinite(finiteElement.poissonRatio) &&
+		std::isfinite(finiteElement.dencity) &&
+		std::isfinite(finiteElement.length) &&
+		std::isfinite(finiteElement.width) &&
+		std::isfinite(finiteElement.heigth) &&
+		std::isfinite(finiteElement.hourglassCoefficient);
+}
+
+ElementMatrixCache::ElementMatrixCache(const UnsignedType& capacity) :
+	m_capacity(capacity)
+{
+	if (m_capacity == 0)
+	{
+		std::string msg = "The capacity of the cache of the matrices "
+			"must be at least 1. ";
+		ERROR(msg);
+	}
+}
+
+ElementMatrixCache& ElementMatrixCache::getInstance()
+{
+	static ElementMatrixCache cache;
+	return cache;
+}
+
+SharedMatrix ElementMatrixCache::getStiffness(const FiniteElement& finiteElement)
+{
+	if (!isFiniteElement(finiteElement))
+		return std::make_shared<const RealMatrix>(makeMatrixStiffness(finiteElement));
+
+	const StiffnessKey key{ finiteElement.modulusElastic,
+		finiteElement.poissonRatio, finiteElement.length, finiteElement.width,
+		finiteElement.heigth, finiteElement.formulation,
+		finiteElement.hourglassCoefficient };
+	const ModulusKey modulusKey{ finiteElement.poissonRatio,
+		finiteElement.length, finiteElement.width, finiteElement.heigth,
+		finiteElement.formulation, finiteElement.hourglassCoefficient };
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	SharedMatrix stiffness = find(m_stiffness, key);
+	if (stiffness)
+	{
+		++m_stats.hits;
+		return stiffness;
+	}
+
+	// makeMatrixStiffness is the stiffness for the modulus 1 multiplied by
+	// the modulus, so the scaled matrix is the same
+	SharedMatrix stiffnessPerModulus = find(m_stiffnessPerModulus, modulusKey);
+	if (stiffnessPerModulus)
+	{
+		++m_stats.modulusHits;
+	}
+	else
+	{
+		++m_stats.misses;
+		stiffnessPerModulus = std::make_shared<const RealMatrix>(
+			makeMatrixStiffnessPerModulus(finiteElement));
+		insert(m_stiffnessPerModulus, modulusKey, stiffnessPerModulus);
+	}
+
+	stiffness = std::make_shared<const RealMatrix>(scaleMatrixStiffness(
+		*stiffnessPerModulus, finiteElement.modulusElastic));
+	insert(m_stiffness, key, stiffness);
+
+	return stiffness;
+}
+
+SharedMatrix ElementMatrixCache::getMassDiag(const UnsignedType& size,
+	const FiniteElement& finiteElement)
+{
+	if (!isFiniteElement(finiteElement))
+	{
+		return std::make_shared<const RealMatrix>(
+			makeMatrixMassDiag(size, finiteElement));
+	}
+
+	const MassKey key{ size, finiteElement.dencity, finiteElement.length,
+		finiteElement.width, finiteElement.heigth };
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	SharedMatrix massDiag = find(m_massDiag, key);
+	if (massDiag)
+	{
+		++m_stats.hits;
+		return massDiag;
+	}
+
+	++m_stats.misses;
+	massDiag = std::make_shared<const RealMatrix>(
+		makeMatrixMassDiag(size, finiteElement));
+	insert(m_massDiag, key, massDiag);
+
+	return massDiag;
+}
+
+ElementCacheStats ElementMatrixCache::getStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void ElementMatrixCache::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stiffness = Entries<StiffnessKey>();
+	m_stiffnessPerModulus = Entries<ModulusKey>();
+	m_massDiag = Entries<MassKey>();
+	m_stats = ElementCacheStats();
+}
+
+template <typename Key>
+SharedMatrix ElementMatrixCache::find(const Entries<Key>& entries,
+	const Key& key) const
+{
+	const auto entry = entries.matrices.find(key);
+	if (entry == entries.matrices.end())
+		return nullptr;
+
+	return entry->second;
+}
+
+// The oldest matrix is removed, the users of the matrix keep it
+template <typename Key>
+void ElementMatrixCache::insert(Entries<Key>& entries, const Key& key,
+	const SharedMatrix& matrix)
+{
+	if (entries.order.size() >= m_capacity)
+	{
+		entries.matrices.erase(entries.order.front());
+		entries.order.pop_front();
+	}
+
+	entries.matrices.emplace(key, matrix);
+	entries.order.push_back(key);
+}
@@ -0,0 +1,281 @@
+#include <MFE_lib/functions_for_MFE/harmonic_solver_MFE.h>
+
+#include <numeric>
+
+#include "operator_overloading/operator_overloading.h"
+#include "error_handling/error_handling.h"
+#include "parallel/parallel_for.h"
+
+using namespace MFE;
+
+// The free motion of one mode: q'' + damping * q' + stiffness * q = 0
+// with the initial value q0 and the initial speed v0
+static Real getModeFreeMotion(const Real& damping, const Real& stiffness,
+	const Real& q0, const Real& v0, const Real& time)
+{
+	const Real discriminant = damping * damping - 4.0 * stiffness;
+	const Real scale = DBL_EPSILON * (damping * damping + 4.0 * abs(stiffness));
+
+	if (discriminant > scale)
+	{
+		// Overdamped mode (or the rigid body motion with damping)
+		const Real root = sqrt(discriminant);
+		const Real rootFirst = 0.5 * (-damping + root);
+		const Real rootSecond = 0.5 * (-damping - root);
+		const Real coeffFirst = (v0 - rootSecond * q0) / (rootFirst - rootSecond);
+		const Real coeffSecond = q0 - coeffFirst;
+
+		return coeffFirst * exp(rootFirst * time) +
+			coeffSecond * exp(rootSecond * time);
+	}
+
+	const Real decay = -0.5 * damping;
+	if (discriminant < -scale)
+	{
+		// Underdamped mode
+		const Real frequencyDamped = 0.5 * sqrt(-discriminant);
+		return exp(decay * time) * (q0 * cos(frequencyDamped * time) +
+			(v0 - decay * q0) / frequencyDamped * sin(frequencyDamped * time));
+	}
+
+	// Critically damped mode (or the rigid body motion without damping)
+	return exp(decay * time) * (q0 + (v0 - decay * q0) * time);
+}
+
+// Applying symmetry conditions to the stiffness and mass matrices
+void MFE::boundConditionsHarmonic(RealMatrix& matrixStiffness,
+	RealMatrix& matrixMass)
+{
+	const UnsignedType rowsStiffness = matrixStiffness.sizeRows();
+	RealMatrix displacements(1, rowsStiffness);
+	RealVector speed(rowsStiffness, 0.0);
+	RealVector acceleration(rowsStiffness, 0.0);
+	RealVector force(rowsStiffness, 0.0);
+
+	boundConditionsDinamic(matrixStiffness, matrixMass, displacements,
+		speed, acceleration, force);
+}
+
+// The steady state of the viscous friction problem at one frequency
+FrequencyResponse MFE::solveHarmonicViscous(const RealMatrix& matrixStiffness,
+	const RealMatrix& matrixMass, const Real& coeffViscousFriction,
+	const Real& amplitudeForce, const Real& frequency)
+{
+	const UnsignedType size = matrixStiffness.sizeRows();
+	bool isSizeEqual = size == matrixStiffness.sizeColumns() &&
+		size == matrixMass.sizeRows() && size == matrixMass.sizeColumns();
+	if (!isSizeEqual)
+	{
+		std::string msg = "The sizes of the matrices are not equal. ";
+		ERROR(msg);
+	}
+
+	if (size <= ACTIVE_INDICES.back())
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	// The complex system is written as a real system of double size:
+	// | K - w^2 * M    -w * C    | | Re U |   | F |
+	// | w * C          K - w^2 * M | | Im U | = | 0 |
+	const Real frequency2 = frequency * frequency;
+	RealMatrix matrixCoeffs(2 * size, 2 * size);
+	for (UnsignedType rowNum = 0; rowNum < size; ++rowNum)
+	{
+		for (UnsignedType columnNum = 0; columnNum < size; ++columnNum)
+		{
+			const Real dinamicStiffness = matrixStiffness[rowNum][columnNum] -
+				frequency2 * matrixMass[rowNum][columnNum];
+			const Real damping =
+				frequency * coeffViscousFriction * matrixMass[rowNum][columnNum];
+
+			matrixCoeffs[rowNum][columnNum] = dinamicStiffness;
+			matrixCoeffs[rowNum][columnNum + size] = -damping;
+			matrixCoeffs[rowNum + size][columnNum] = damping;
+			matrixCoeffs[rowNum + size][columnNum + size] = dinamicStiffness;
+		}
+	}
+
+	RealVector freeTerms(2 * size, 0.0);
+	const Real nodeLoad = getNodeLoad(amplitudeForce);
+	for (const auto& index : ACTIVE_INDICES)
+		freeTerms[index] = nodeLoad;
+
+	RealVector solution = solveReflectionMethod(matrixCoeffs, freeTerms);
+
+	FrequencyResponse response;
+	response.frequency = frequency;
+	response.amplitude.resize(size);
+	response.phase.resize(size);
+	for (UnsignedType index = 0; index < size; ++index)
+	{
+		const Real realPart = solution[index];
+		const Real imaginaryPart = solution[index + size];
+		response.amplitude[index] = sqrt(realPart * realPart +
+			imaginaryPart * imaginaryPart);
+		response.phase[index] = atan2(imaginaryPart, realPart);
+	}
+
+	return response;
+}
+
+// The frequency response curve
+std::vector<FrequencyResponse> MFE::sweepFrequencyViscous(
+	const RealMatrix& matrixStiffness, const RealMatrix& matrixMass,
+	const Real& coeffViscousFriction, const Real& amplitudeForce,
+	const RealVector& frequencies, const UnsignedType& threadsCount)
+{
+	const UnsignedType size = frequencies.size();
+	std::vector<FrequencyResponse> responses(size);
+	parallelFor(size, threadsCount, [&](const UnsignedType index)
+		{
+			responses[index] = solveHarmonicViscous(matrixStiffness,
+				matrixMass, coeffViscousFriction, amplitudeForce,
+				frequencies[index]);
+		});
+
+	return responses;
+}
+
+// Natural frequencies and modes for the diagonal mass matrix:
+// the problem is reduced to the symmetric M^(-1/2) * K * M^(-1/2)
+ModalData MFE::calculateModalData(const RealMatrix& matrixStiffness,
+	const RealMatrix& matrixMass)
+{
+	const UnsignedType size = matrixStiffness.sizeRows();
+	bool isSizeEqual = size == matrixStiffness.sizeColumns() &&
+		size == matrixMass.sizeRows() && size == matrixMass.sizeColumns();
+	if (!isSizeEqual)
+	{
+		std::string msg = "The sizes of the matrices are not equal. ";
+		ERROR(msg);
+	}
+
+	RealVector massInverseRoot(size, 0.0);
+	for (UnsignedType index = 0; index < size; ++index)
+	{
+		if (matrixMass[index][index] <= DBL_EPSILON)
+		{
+			std::string msg = messageDivideZero();
+			ERROR(msg);
+		}
+		massInverseRoot[index] = 1.0 / sqrt(matrixMass[index][index]);
+	}
+
+	RealMatrix matrixReduced(size, size);
+	for (UnsignedType rowNum = 0; rowNum < size; ++rowNum)
+	{
+		for (UnsignedType columnNum = 0; columnNum < size; ++columnNum)
+		{
+			matrixReduced[rowNum][columnNum] =
+				massInverseRoot[rowNum] * matrixStiffness[rowNum][columnNum] *
+				massInverseRoot[columnNum];
+		}
+	}
+
+	RealVector eigenvalues;
+	RealMatrix eigenvectors;
+	calculateEigenSymmetric(matrixReduced, eigenvalues, eigenvectors);
+
+	std::vector<UnsignedType> order(size);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(),
+		[&](const UnsignedType lhs, const UnsignedType rhs)
+		{
+			return eigenvalues[lhs] < eigenvalues[rhs];
+		});
+
+	ModalData modalData;
+	modalData.naturalFrequencies.resize(size);
+	modalData.modes = RealMatrix(size, size);
+	for (UnsignedType modeNum = 0; modeNum < size; ++modeNum)
+	{
+		const UnsignedType index = order[modeNum];
+		// Negative values are rounding errors of the rigid body motion
+		modalData.naturalFrequencies[modeNum] =
+			sqrt(std::max(eigenvalues[index], 0.0));
+
+		for (UnsignedType dof = 0; dof < size; ++dof)
+		{
+			modalData.modes[modeNum][dof] =
+				massInverseRoot[dof] * eigenvectors[index][dof];
+		}
+	}
+
+	return modalData;
+}
+
+// The steady state and the transient at the time moments
+RealMatrix MFE::calculateHarmonicDisplacements(
+	const FrequencyResponse& steadyState, const ModalData& modalData,
+	const RealMatrix& matrixMass, const Real& coeffViscousFriction,
+	const RealVector& initialDisps, const RealVector& initialSpeed,
+	const RealVector& stepsTime)
+{
+	const UnsignedType size = steadyState.amplitude.size();
+	const UnsignedType stepsCount = stepsTime.size();
+	const Real frequency = steadyState.frequency;
+	if (steadyState.phase.size() != size)
+	{
+		std::string msg = "The sizes of the amplitudes and phases are not equal. ";
+		ERROR(msg);
+	}
+
+	RealVector realPart(size, 0.0);
+	RealVector imaginaryPart(size, 0.0);
+	for (UnsignedType index = 0; index < size; ++index)
+	{
+		realPart[index] = steadyState.amplitude[index] *
+			cos(steadyState.phase[index]);
+		imaginaryPart[index] = steadyState.amplitude[index] *
+			sin(steadyState.phase[index]);
+	}
+
+	RealMatrix displacements(stepsCount, size);
+	for (UnsignedType step = 0; step < stepsCount; ++step)
+	{
+		const Real phaseTime = frequency * stepsTime[step];
+		displacements[step] = cos(phaseTime) * realPart -
+			sin(phaseTime) * imaginaryPart;
+	}
+
+	if (modalData.modes.empty())
+		return displacements;
+
+	bool isSizeCorrect = modalData.modes.sizeRows() == size &&
+		modalData.modes.sizeColumns() == size &&
+		matrixMass.sizeRows() == size && initialDisps.size() == size &&
+		initialSpeed.size() == size;
+	if (!isSizeCorrect)
+	{
+		std::string msg = "The sizes of the modal data and the initial "
+			"conditions are not equal to the size of the steady state. ";
+		ERROR(msg);
+	}
+
+	// The initial conditions of the transient are the difference between
+	// the given initial conditions and the steady state at the zero time
+	RealVector dispsTransient = initialDisps - realPart;
+	RealVector speedTransient = initialSpeed + frequency * imaginaryPart;
+	RealVector massDispsTransient = matrixMass * dispsTransient;
+	RealVector massSpeedTransient = matrixMass * speedTransient;
+
+	for (UnsignedType modeNum = 0; modeNum < size; ++modeNum)
+	{
+		const RealVector& mode = modalData.modes[modeNum];
+		const Real q0 = mode * massDispsTransient;
+		const Real v0 = mode * massSpeedTransient;
+		const Real naturalFrequency = modalData.naturalFrequencies[modeNum];
+		const Real stiffness = naturalFrequency * naturalFrequency;
+
+		for (UnsignedType step = 0; step < stepsCount; ++step)
+		{
+			const Real modeMotion = getModeFreeMotion(coeffViscousFriction,
+				stiffness, q0, v0, stepsTime[step]);
+			displacements[step] += modeMotion * mode;
+		}
+	}
+
+	return displacements;
+}
@@ -0,0 +1,404 @@
+#include <MFE_lib/functions_for_MFE/hex_mesh.h>
+#include <MFE_lib/functions_for_MFE/element_cache.h>
+#include <MFE_lib/functions_for_MFE/initial_conditions.h>
+#include <MFE_lib/functions_for_MFE/profiling.h>
+
+#include <algorithm>
+
+#include "error_handling/error_handling.h"
+#include "parallel/parallel_for.h"
+
+using namespace MFE;
+
+// The share of the node of the face in the area of the face along one
+// direction: the nodes of the edges have a half of the element
+static Real getNodeShare(const UnsignedType& nodeNum, const UnsignedType& count)
+{
+	return nodeNum == 0 || nodeNum == count ? 0.5 : 1.0;
+}
+
+HexMesh MFE::makeHexMesh(const FiniteElement& body, const UnsignedType& countX,
+	const UnsignedType& countY, const UnsignedType& countZ)
+{
+	if (countX == 0 || countY == 0 || countZ == 0)
+	{
+		std::string msg = "The mesh must have at least one element along "
+			"each direction. ";
+		ERROR(msg);
+	}
+
+	HexMesh mesh;
+	mesh.countX = countX;
+	mesh.countY = countY;
+	mesh.countZ = countZ;
+	mesh.finiteElement = body;
+	mesh.finiteElement.length = body.length / static_cast<Real>(countX);
+	mesh.finiteElement.width = body.width / static_cast<Real>(countY);
+	mesh.finiteElement.heigth = body.heigth / static_cast<Real>(countZ);
+
+	const Real length = mesh.finiteElement.length;
+	const Real width = mesh.finiteElement.width;
+	const Real heigth = mesh.finiteElement.heigth;
+	mesh.nodes.reserve((countX + 1) * (countY + 1) * (countZ + 1));
+	for (UnsignedType nodeZ = 0; nodeZ <= countZ; ++nodeZ)
+	{
+		for (UnsignedType nodeY = 0; nodeY <= countY; ++nodeY)
+		{
+			for (UnsignedType nodeX = 0; nodeX <= countX; ++nodeX)
+			{
+				const UnsignedType node = mesh.nodes.size();
+				mesh.nodes.push_back({ static_cast<Real>(nodeX) * length,
+					static_cast<Real>(nodeY) * width,
+					static_cast<Real>(nodeZ) * heigth });
+
+				// The normal displacements of the planes of symmetry
+				if (nodeX == 0)
+					mesh.symmetryDofs.push_back(getMeshDof(node, 0));
+				if (nodeY == 0)
+					mesh.symmetryDofs.push_back(getMeshDof(node, 1));
+				if (nodeZ == 0)
+					mesh.symmetryDofs.push_back(getMeshDof(node, 2));
+
+				if (nodeX == countX)
+					mesh.frontNodes.push_back(node);
+				if (nodeY == countY || nodeZ == countZ)
+					mesh.wallNodes.push_back(node);
+			}
+		}
+	}
+
+	// The local coordinate -1 is the node of the element with the smaller
+	// number, 1 - the next one
+	mesh.elements.reserve(countX * countY * countZ);
+	for (UnsignedType elementZ = 0; elementZ < countZ; ++elementZ)
+	{
+		for (UnsignedType elementY = 0; elementY < countY; ++elementY)
+		{
+			for (UnsignedType elementX = 0; elementX < countX; ++elementX)
+			{
+				ElementNodes element{};
+				for (UnsignedType nodeLoc = 0; nodeLoc < ELEMENT_NODES_COUNT;
+					++nodeLoc)
+				{
+					const Array3D& local = REFERENCE_NODES[nodeLoc];
+					element[nodeLoc] = getMeshNode(mesh,
+						elementX + (local[0] > 0.0 ? 1 : 0),
+						elementY + (local[1] > 0.0 ? 1 : 0),
+						elementZ + (local[2] > 0.0 ? 1 : 0));
+				}
+				mesh.elements.push_back(element);
+			}
+		}
+	}
+
+	mesh.colors = colorElements(mesh.elements, mesh.nodes.size());
+
+	return mesh;
+}
+
+std::vector<std::vector<UnsignedType>> MFE::colorElements(
+	const std::vector<ElementNodes>& elements, const UnsignedType& nodesCount)
+{
+	// The elements of the nodes
+	std::vector<std::vector<UnsignedType>> nodeElements(nodesCount);
+	for (UnsignedType elementNum = 0; elementNum < elements.size(); ++elementNum)
+	{
+		for (const auto& node : elements[elementNum])
+		{
+			if (node >= nodesCount)
+			{
+				std::string msg = messageOutOfRange();
+				ERROR(msg);
+			}
+			nodeElements[node].push_back(elementNum);
+		}
+	}
+
+	constexpr UnsignedType NO_COLOR = static_cast<UnsignedType>(-1);
+	std::vector<UnsignedType> elementColors(elements.size(), NO_COLOR);
+	std::vector<std::vector<UnsignedType>> colors;
+
+	// The color, which was marked by the element, is used by its neighbour
+	std::vector<UnsignedType> usedBy;
+	for (UnsignedType elementNum = 0; elementNum < elements.size(); ++elementNum)
+	{
+		for (const auto& node : elements[elementNum])
+		{
+			for (const auto& neighbour : nodeElements[node])
+			{
+				const UnsignedType color = elementColors[neighbour];
+				if (color != NO_COLOR)
+					usedBy[color] = elementNum;
+			}
+		}
+
+		UnsignedType color = 0;
+		while (color < colors.size() && usedBy[color] == elementNum)
+			++color;
+
+		if (color == colors.size())
+		{
+			colors.emplace_back();
+			usedBy.push_back(NO_COLOR);
+		}
+
+		elementColors[elementNum] = color;
+		colors[color].push_back(elementNum);
+	}
+
+	return colors;
+}
+
+UnsignedType MFE::getMeshNode(const HexMesh& mesh, const UnsignedType& nodeX,
+	const UnsignedType& nodeY, const UnsignedType& nodeZ)
+{
+	if (nodeX > mesh.countX || nodeY > mesh.countY || nodeZ > mesh.countZ)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	return nodeX + (mesh.countX + 1) * (nodeY + (mesh.countY + 1) * nodeZ);
+}
+
+UnsignedType MFE::getMeshDof(const UnsignedType& node,
+	const UnsignedType& direction)
+{
+	return ELEMENT_DIMENSIONS_COUNT * node + direction;
+}
+
+UnsignedType MFE::getMeshDofCount(const HexMesh& mesh)
+{
+	return ELEMENT_DIMENSIONS_COUNT * mesh.nodes.size();
+}
+
+// The pattern: the row of the degree of freedom has all degrees of freedom
+// of the nodes of the elements of its node (up to 27 nodes), the nodes are
+// in ascending order, so the 3 degrees of freedom of a node are together
+static SparseMatrix makeMeshPattern(const HexMesh& mesh)
+{
+	SparseMatrix matrix;
+	matrix.rows = getMeshDofCount(mesh);
+	matrix.rowOffsets.reserve(matrix.rows + 1);
+	matrix.rowOffsets.push_back(0);
+
+	std::vector<UnsignedType> neighbours;
+	for (UnsignedType nodeZ = 0; nodeZ <= mesh.countZ; ++nodeZ)
+	{
+		for (UnsignedType nodeY = 0; nodeY <= mesh.countY; ++nodeY)
+		{
+			for (UnsignedType nodeX = 0; nodeX <= mesh.countX; ++nodeX)
+			{
+				neighbours.clear();
+				for (UnsignedType otherZ = nodeZ == 0 ? 0 : nodeZ - 1;
+					otherZ <= std::min(nodeZ + 1, mesh.countZ); ++otherZ)
+				{
+					for (UnsignedType otherY = nodeY == 0 ? 0 : nodeY - 1;
+						otherY <= std::min(nodeY + 1, mesh.countY); ++otherY)
+					{
+						for (UnsignedType otherX = nodeX == 0 ? 0 : nodeX - 1;
+							otherX <= std::min(nodeX + 1, mesh.countX); ++otherX)
+						{
+							neighbours.push_back(
+								getMeshNode(mesh, otherX, otherY, otherZ));
+						}
+					}
+				}
+
+				for (UnsignedType direction = 0;
+					direction < ELEMENT_DIMENSIONS_COUNT; ++direction)
+				{
+					for (const auto& neighbour : neighbours)
+					{
+						for (UnsignedType directionOther = 0;
+							directionOther < ELEMENT_DIMENSIONS_COUNT; ++directionOther)
+						{
+							matrix.columns.push_back(
+								getMeshDof(neighbour, directionOther));
+						}
+					}
+					matrix.rowOffsets.push_back(matrix.columns.size());
+				}
+			}
+		}
+	}
+
+	matrix.values.assign(matrix.columns.size(), 0.0);
+	return matrix;
+}
+
+// The colors of the mesh, if the mesh is not colored, they are found
+static std::vector<std::vector<UnsignedType>> getMeshColors(const HexMesh& mesh)
+{
+	if (!mesh.colors.empty() || mesh.elements.empty())
+		return mesh.colors;
+
+	return colorElements(mesh.elements, mesh.nodes.size());
+}
+
+// Calling "addElement(element)" for the elements of each color in parallel,
+// the colors one after another
+template <typename AddElement>
+static void assembleByColors(const HexMesh& mesh,
+	const UnsignedType& threadsCount, AddElement&& addElement)
+{
+	const std::vector<std::vector<UnsignedType>> colors = getMeshColors(mesh);
+	for (const auto& color : colors)
+	{
+		parallelFor(color.size(), threadsCount, [&](const UnsignedType index)
+			{
+				addElement(mesh.elements[color[index]]);
+			});
+	}
+}
+
+SparseMatrix MFE::assembleStiffnessMesh(const HexMesh& mesh,
+	const UnsignedType& threadsCount)
+{
+	MFE_PROFILE_SCOPE(PROFILE_ASSEMBLY);
+	SparseMatrix matrix = makeMeshPattern(mesh);
+
+	// All elements of the structured mesh are the same
+	SharedMatrix matrixStiffness =
+		ElementMatrixCache::getInstance().getStiffness(mesh.finiteElement);
+	const RealMatrix& elementStiffness = *matrixStiffness;
+
+	assembleByColors(mesh, threadsCount, [&](const ElementNodes& element)
+		{
+			for (UnsignedType nodeFirst = 0; nodeFirst < ELEMENT_NODES_COUNT;
+				++nodeFirst)
+			{
+				for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+					++dimFirst)
+				{
+					const UnsignedType rowNum =
+						getMeshDof(element[nodeFirst], dimFirst);
+					const RealVector& rowLoc = elementStiffness[
+						ELEMENT_DIMENSIONS_COUNT * nodeFirst + dimFirst];
+					for (UnsignedType nodeSecond = 0;
+						nodeSecond < ELEMENT_NODES_COUNT; ++nodeSecond)
+					{
+						// The degrees of freedom of the node are together
+						Real* values = &getSparseValue(matrix, rowNum,
+							getMeshDof(element[nodeSecond], 0));
+						const UnsignedType columnLoc =
+							ELEMENT_DIMENSIONS_COUNT * nodeSecond;
+						for (UnsignedType dimSecond = 0;
+							dimSecond < ELEMENT_DIMENSIONS_COUNT; ++dimSecond)
+						{
+							values[dimSecond] += rowLoc[columnLoc + dimSecond];
+						}
+					}
+				}
+			}
+		});
+
+	return matrix;
+}
+
+RealMatrix MFE::assembleStiffnessMeshDense(const HexMesh& mesh,
+	const UnsignedType& threadsCount)
+{
+	MFE_PROFILE_SCOPE(PROFILE_ASSEMBLY);
+	const UnsignedType size = getMeshDofCount(mesh);
+	RealMatrix matrix(size, size);
+
+	SharedMatrix matrixStiffness =
+		ElementMatrixCache::getInstance().getStiffness(mesh.finiteElement);
+	const RealMatrix& elementStiffness = *matrixStiffness;
+
+	assembleByColors(mesh, threadsCount, [&](const ElementNodes& element)
+		{
+			for (UnsignedType rowLoc = 0; rowLoc < ELEMENT_DOF_COUNT; ++rowLoc)
+			{
+				RealVector& row = matrix[getMeshDof(
+					element[rowLoc / ELEMENT_DIMENSIONS_COUNT],
+					rowLoc % ELEMENT_DIMENSIONS_COUNT)];
+				for (UnsignedType columnLoc = 0; columnLoc < ELEMENT_DOF_COUNT;
+					++columnLoc)
+				{
+					row[getMeshDof(element[columnLoc / ELEMENT_DIMENSIONS_COUNT],
+						columnLoc % ELEMENT_DIMENSIONS_COUNT)] +=
+						elementStiffness[rowLoc][columnLoc];
+				}
+			}
+		});
+
+	return matrix;
+}
+
+RealVector MFE::assembleMassMesh(const HexMesh& mesh,
+	const UnsignedType& threadsCount)
+{
+	MFE_PROFILE_SCOPE(PROFILE_ASSEMBLY);
+	SharedMatrix matrixMass = ElementMatrixCache::getInstance().getMassDiag(
+		ELEMENT_DOF_COUNT, mesh.finiteElement);
+	const RealMatrix& elementMass = *matrixMass;
+
+	RealVector mass(getMeshDofCount(mesh), 0.0);
+	assembleByColors(mesh, threadsCount, [&](const ElementNodes& element)
+		{
+			for (UnsignedType dofLoc = 0; dofLoc < ELEMENT_DOF_COUNT; ++dofLoc)
+			{
+				mass[getMeshDof(element[dofLoc / ELEMENT_DIMENSIONS_COUNT],
+					dofLoc % ELEMENT_DIMENSIONS_COUNT)] +=
+					elementMass[dofLoc][dofLoc];
+			}
+		});
+
+	return mass;
+}
+
+RealMatrix MFE::assembleMassMeshDense(const HexMesh& mesh,
+	const UnsignedType& threadsCount)
+{
+	const RealVector mass = assembleMassMesh(mesh, threadsCount);
+	RealMatrix matrix(mass.size(), mass.size());
+	for (UnsignedType indexDiagonal = 0; indexDiagonal < mass.size();
+		++indexDiagonal)
+	{
+		matrix[indexDiagonal][indexDiagonal] = mass[indexDiagonal];
+	}
+	return matrix;
+}
+
+void MFE::boundConditionStaticMesh(const HexMesh& mesh,
+	SparseMatrix& matrixStiffness)
+{
+	for (const auto& dof : mesh.symmetryDofs)
+		getSparseValue(matrixStiffness, dof, dof) *= STATIC_SIMMETRY;
+}
+
+RealVector MFE::makeStaticForceMesh(const HexMesh& mesh,
+	const Real& initialForce)
+{
+	RealVector force(getMeshDofCount(mesh), 0.0);
+	Real sharesSum = 0.0;
+	for (UnsignedType nodeZ = 0; nodeZ <= mesh.countZ; ++nodeZ)
+	{
+		for (UnsignedType nodeY = 0; nodeY <= mesh.countY; ++nodeY)
+		{
+			const Real share = getNodeShare(nodeY, mesh.countY) *
+				getNodeShare(nodeZ, mesh.countZ);
+			const UnsignedType node = getMeshNode(mesh, mesh.countX, nodeY, nodeZ);
+			force[getMeshDof(node, 0)] = share;
+			sharesSum += share;
+		}
+	}
+
+	for (const auto& node : mesh.frontNodes)
+		force[getMeshDof(node, 0)] *= initialForce / sharesSum;
+
+	return force;
+}
+
+IterativeSolution MFE::calculateDispStaticMesh(const HexMesh& mesh,
+	const Real& initialForce, const IterativeSolverOptions& options,
+	const UnsignedType& threadsCount)
+{
+	SparseMatrix matrixStiffness = assembleStiffnessMesh(mesh, threadsCount);
+	boundConditionStaticMesh(mesh, matrixStiffness);
+
+	return solveConjugateGradient(matrixStiffness,
+		makeStaticForceMesh(mesh, initialForce), options);
+}
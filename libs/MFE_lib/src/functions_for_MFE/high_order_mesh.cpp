@@ -0,0 +1,603 @@
+#include <MFE_lib/functions_for_MFE/high_order_mesh.h>
+#include <MFE_lib/functions_for_MFE/initial_conditions.h>
+#include <MFE_lib/functions_for_MFE/solver_utils.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "error_handling/error_handling.h"
+#include "parallel/element_tiles.h"
+#include "parallel/thread_pool.h"
+
+using namespace MFE;
+
+namespace
+{
+	constexpr UnsignedType NEWTON_ITERATIONS = 100;
+	constexpr Real NEWTON_TOLERANCE = 1.0e-15;
+
+	// The vectors of one element along the directions (n x n x n values,
+	// n = order + 1, the index is a + n * (b + n * c), a - along x)
+	using ElementValues = std::array<RealVector, ELEMENT_DIMENSIONS_COUNT>;
+}
+
+// The Legendre polynomial of the order and its derivative at the point
+static void evaluateLegendre(const UnsignedType& order, const Real& point,
+	Real& value, Real& derivative)
+{
+	Real previous = 1.0;
+	value = order == 0 ? 1.0 : point;
+	for (UnsignedType degree = 2; degree <= order; ++degree)
+	{
+		const Real next = ((2.0 * degree - 1.0) * point * value -
+			(degree - 1.0) * previous) / static_cast<Real>(degree);
+		previous = value;
+		value = next;
+	}
+
+	if (order == 0)
+	{
+		derivative = 0.0;
+		return;
+	}
+
+	// At the ends of [-1, 1]: P'(+-1) = (+-1)^(n + 1) * n * (n + 1) / 2
+	if (std::fabs(point) == 1.0)
+	{
+		derivative = 0.5 * order * (order + 1.0);
+		if (point < 0.0 && order % 2 == 0)
+			derivative = -derivative;
+		return;
+	}
+
+	derivative = order * (point * value - previous) / (point * point - 1.0);
+}
+
+// The Gauss points (the roots of the Legendre polynomial of the order
+// "count") and the weights in ascending order
+static void makeGaussLegendrePoints(const UnsignedType& count, RealVector& points,
+	RealVector& weights)
+{
+	points.assign(count, 0.0);
+	weights.assign(count, 0.0);
+	for (UnsignedType pointNum = 0; pointNum < count; ++pointNum)
+	{
+		Real point = -std::cos(PI * (pointNum + 0.75) / (count + 0.5));
+		Real value = 0.0;
+		Real derivative = 0.0;
+		for (UnsignedType iteration = 0; iteration < NEWTON_ITERATIONS; ++iteration)
+		{
+			evaluateLegendre(count, point, value, derivative);
+			const Real step = value / derivative;
+			point -= step;
+			if (std::fabs(step) < NEWTON_TOLERANCE)
+				break;
+		}
+
+		evaluateLegendre(count, point, value, derivative);
+		points[pointNum] = point;
+		weights[pointNum] = 2.0 / ((1.0 - point * point) * derivative * derivative);
+	}
+}
+
+// The Gauss - Lobatto - Legendre points: -1, the roots of the derivative of
+// the Legendre polynomial of the order, 1; the weights in ascending order
+static void makeGaussLobattoPoints(const UnsignedType& order, RealVector& points,
+	RealVector& weights)
+{
+	points.assign(order + 1, 0.0);
+	weights.assign(order + 1, 0.0);
+	const Real orderFactor = order * (order + 1.0);
+	for (UnsignedType pointNum = 0; pointNum <= order; ++pointNum)
+	{
+		Real point = -std::cos(PI * pointNum / static_cast<Real>(order));
+		Real value = 0.0;
+		Real derivative = 0.0;
+		if (pointNum != 0 && pointNum != order)
+		{
+			// Newton's method for P'(x), P'' by the Legendre equation
+			for (UnsignedType iteration = 0; iteration < NEWTON_ITERATIONS;
+				++iteration)
+			{
+				evaluateLegendre(order, point, value, derivative);
+				const Real secondDerivative = (2.0 * point * derivative -
+					orderFactor * value) / (1.0 - point * point);
+				const Real step = derivative / secondDerivative;
+				point -= step;
+				if (std::fabs(step) < NEWTON_TOLERANCE)
+					break;
+			}
+		}
+
+		evaluateLegendre(order, point, value, derivative);
+		points[pointNum] = point;
+		weights[pointNum] = 2.0 / (orderFactor * value * value);
+	}
+}
+
+LagrangeBasis MFE::makeLagrangeBasis(const UnsignedType& order)
+{
+	if (order < MIN_ELEMENT_ORDER || order > MAX_ELEMENT_ORDER)
+	{
+		std::string msg = "The order of the element must be from " +
+			std::to_string(MIN_ELEMENT_ORDER) + " to " +
+			std::to_string(MAX_ELEMENT_ORDER) + ". ";
+		ERROR(msg);
+	}
+
+	LagrangeBasis basis;
+	basis.order = order;
+	makeGaussLobattoPoints(order, basis.nodes, basis.nodeWeights);
+	makeGaussLegendrePoints(order + 1, basis.gaussPoints, basis.gaussWeights);
+
+	const UnsignedType size = order + 1;
+	basis.values = RealMatrix(size, size);
+	basis.derivatives = RealMatrix(size, size);
+	const RealVector& nodes = basis.nodes;
+	for (UnsignedType pointNum = 0; pointNum < size; ++pointNum)
+	{
+		const Real point = basis.gaussPoints[pointNum];
+		for (UnsignedType node = 0; node < size; ++node)
+		{
+			Real value = 1.0;
+			Real derivative = 0.0;
+			for (UnsignedType other = 0; other < size; ++other)
+			{
+				if (other == node)
+					continue;
+
+				// The derivative of the product by the product rule
+				const Real denominator = nodes[node] - nodes[other];
+				derivative = (derivative * (point - nodes[other]) + value) /
+					denominator;
+				value *= (point - nodes[other]) / denominator;
+			}
+
+			basis.values[pointNum][node] = value;
+			basis.derivatives[pointNum][node] = derivative;
+		}
+	}
+
+	return basis;
+}
+
+HighOrderMesh MFE::makeHighOrderMesh(const FiniteElement& body,
+	const UnsignedType& order, const UnsignedType& countX,
+	const UnsignedType& countY, const UnsignedType& countZ)
+{
+	if (countX == 0 || countY == 0 || countZ == 0)
+	{
+		std::string msg = "The mesh must have at least one element along "
+			"each direction. ";
+		ERROR(msg);
+	}
+
+	HighOrderMesh mesh;
+	mesh.order = order;
+	mesh.countX = countX;
+	mesh.countY = countY;
+	mesh.countZ = countZ;
+	mesh.basis = makeLagrangeBasis(order);
+	mesh.finiteElement = body;
+	mesh.finiteElement.length = body.length / static_cast<Real>(countX);
+	mesh.finiteElement.width = body.width / static_cast<Real>(countY);
+	mesh.finiteElement.heigth = body.heigth / static_cast<Real>(countZ);
+
+	const UnsignedType lastX = countX * order;
+	for (UnsignedType nodeZ = 0; nodeZ <= countZ * order; ++nodeZ)
+	{
+		for (UnsignedType nodeY = 0; nodeY <= countY * order; ++nodeY)
+		{
+			for (UnsignedType nodeX = 0; nodeX <= lastX; ++nodeX)
+			{
+				const UnsignedType node = getHighOrderNode(mesh, nodeX, nodeY, nodeZ);
+
+				// The normal displacements of the planes of symmetry
+				if (nodeX == 0)
+					mesh.symmetryDofs.push_back(getMeshDof(node, 0));
+				if (nodeY == 0)
+					mesh.symmetryDofs.push_back(getMeshDof(node, 1));
+				if (nodeZ == 0)
+					mesh.symmetryDofs.push_back(getMeshDof(node, 2));
+
+				if (nodeX == lastX)
+					mesh.frontNodes.push_back(node);
+			}
+		}
+	}
+
+	return mesh;
+}
+
+UnsignedType MFE::getHighOrderNode(const HighOrderMesh& mesh,
+	const UnsignedType& nodeX, const UnsignedType& nodeY,
+	const UnsignedType& nodeZ)
+{
+	const UnsignedType nodesX = mesh.countX * mesh.order + 1;
+	const UnsignedType nodesY = mesh.countY * mesh.order + 1;
+	const UnsignedType nodesZ = mesh.countZ * mesh.order + 1;
+	if (nodeX >= nodesX || nodeY >= nodesY || nodeZ >= nodesZ)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	return nodeX + nodesX * (nodeY + nodesY * nodeZ);
+}
+
+UnsignedType MFE::getHighOrderDofCount(const HighOrderMesh& mesh)
+{
+	return ELEMENT_DIMENSIONS_COUNT * (mesh.countX * mesh.order + 1) *
+		(mesh.countY * mesh.order + 1) * (mesh.countZ * mesh.order + 1);
+}
+
+// The integral of the shape function of the node along one direction (in
+// the local coordinates): the weight of the node in each element of it
+static Real getNodeWeight(const LagrangeBasis& basis,
+	const UnsignedType& nodeNum, const UnsignedType& count)
+{
+	const UnsignedType order = basis.order;
+	const UnsignedType nodeLoc = nodeNum % order;
+	if (nodeLoc != 0)
+		return basis.nodeWeights[nodeLoc];
+
+	Real weight = 0.0;
+	if (nodeNum != 0)
+		weight += basis.nodeWeights[order];
+	if (nodeNum != count * order)
+		weight += basis.nodeWeights[0];
+
+	return weight;
+}
+
+RealVector MFE::makeStaticForceHighOrder(const HighOrderMesh& mesh,
+	const Real& initialForce)
+{
+	RealVector force(getHighOrderDofCount(mesh), 0.0);
+	Real sharesSum = 0.0;
+	const UnsignedType lastX = mesh.countX * mesh.order;
+	for (UnsignedType nodeZ = 0; nodeZ <= mesh.countZ * mesh.order; ++nodeZ)
+	{
+		for (UnsignedType nodeY = 0; nodeY <= mesh.countY * mesh.order; ++nodeY)
+		{
+			const Real share = getNodeWeight(mesh.basis, nodeY, mesh.countY) *
+				getNodeWeight(mesh.basis, nodeZ, mesh.countZ);
+			const UnsignedType node = getHighOrderNode(mesh, lastX, nodeY, nodeZ);
+			force[getMeshDof(node, 0)] = share;
+			sharesSum += share;
+		}
+	}
+
+	for (const auto& node : mesh.frontNodes)
+		force[getMeshDof(node, 0)] *= initialForce / sharesSum;
+
+	return force;
+}
+
+// The product of the one-dimensional matrix n x n (by rows) along the axis
+// (0 - x, 1 - y, 2 - z) of the values of the element:
+// result[.., q, ..] = sum(matrix[q][i] * values[.., i, ..])
+static void contractAxis(const RealVector& matrix, const UnsignedType& axis,
+	const UnsignedType& size, const RealVector& values, RealVector& result)
+{
+	const UnsignedType stride = axis == 0 ? 1 : (axis == 1 ? size : size * size);
+	const UnsignedType blockSize = stride * size;
+	result.assign(values.size(), 0.0);
+	for (UnsignedType block = 0; block < values.size(); block += blockSize)
+	{
+		for (UnsignedType position = 0; position < size; ++position)
+		{
+			Real* output = &result[block + position * stride];
+			for (UnsignedType other = 0; other < size; ++other)
+			{
+				const Real value = matrix[position * size + other];
+				const Real* input = &values[block + other * stride];
+				for (UnsignedType inner = 0; inner < stride; ++inner)
+					output[inner] += value * input[inner];
+			}
+		}
+	}
+}
+
+// The matrix by rows or the transposed matrix by rows
+static RealVector makeFlatMatrix(const RealMatrix& matrix, const bool isTransposed)
+{
+	const UnsignedType size = matrix.sizeRows();
+	RealVector result(size * size);
+	for (UnsignedType rowNum = 0; rowNum < size; ++rowNum)
+	{
+		for (UnsignedType columnNum = 0; columnNum < size; ++columnNum)
+		{
+			result[isTransposed ? columnNum * size + rowNum :
+				rowNum * size + columnNum] = matrix[rowNum][columnNum];
+		}
+	}
+
+	return result;
+}
+
+HighOrderStiffnessOperator::HighOrderStiffnessOperator(const HighOrderMesh& mesh,
+	const UnsignedType& threadsCount) :
+	m_mesh(mesh), m_threadPool(std::make_shared<ThreadPool>(threadsCount)),
+	m_tileColors(makeTileColors(mesh.countY, mesh.countZ, 1)),
+	m_values(makeFlatMatrix(mesh.basis.values, false)),
+	m_derivatives(makeFlatMatrix(mesh.basis.derivatives, false)),
+	m_valuesTransposed(makeFlatMatrix(mesh.basis.values, true)),
+	m_derivativesTransposed(makeFlatMatrix(mesh.basis.derivatives, true)),
+	m_diagonal(getHighOrderDofCount(mesh), 0.0)
+{
+	const FiniteElement& finiteElement = mesh.finiteElement;
+	checkStiffnessProperties(finiteElement);
+
+	const Array3D dimensions{ finiteElement.length, finiteElement.width,
+		finiteElement.heigth };
+	const Real poissonRatio = finiteElement.poissonRatio;
+	const Real factor = finiteElement.modulusElastic *
+		dimensions[0] * dimensions[1] * dimensions[2] / 8.0;
+	m_normal = factor * (1.0 - poissonRatio) /
+		(1.0 + poissonRatio) / (1.0 - 2.0 * poissonRatio);
+	m_lateral = factor * poissonRatio /
+		(1.0 + poissonRatio) / (1.0 - 2.0 * poissonRatio);
+	m_shear = factor / (2.0 * (1.0 + poissonRatio));
+	for (UnsignedType dim = 0; dim < ELEMENT_DIMENSIONS_COUNT; ++dim)
+		m_scales[dim] = 2.0 / dimensions[dim];
+
+	// The integrals of the squares of the derivatives of the shape functions
+	// are the products of the one-dimensional integrals
+	const LagrangeBasis& basis = mesh.basis;
+	const UnsignedType size = mesh.order + 1;
+	RealVector valuesSquares(size, 0.0);
+	RealVector derivativesSquares(size, 0.0);
+	for (UnsignedType pointNum = 0; pointNum < size; ++pointNum)
+	{
+		const Real weight = basis.gaussWeights[pointNum];
+		for (UnsignedType node = 0; node < size; ++node)
+		{
+			const Real value = basis.values[pointNum][node];
+			const Real derivative = basis.derivatives[pointNum][node];
+			valuesSquares[node] += weight * value * value;
+			derivativesSquares[node] += weight * derivative * derivative;
+		}
+	}
+
+	for (UnsignedType elementZ = 0; elementZ < mesh.countZ; ++elementZ)
+	{
+		for (UnsignedType elementY = 0; elementY < mesh.countY; ++elementY)
+		{
+			for (UnsignedType elementX = 0; elementX < mesh.countX; ++elementX)
+			{
+				for (UnsignedType nodeZ = 0; nodeZ < size; ++nodeZ)
+				{
+					for (UnsignedType nodeY = 0; nodeY < size; ++nodeY)
+					{
+						for (UnsignedType nodeX = 0; nodeX < size; ++nodeX)
+						{
+							const Array3D gradients{
+								m_scales[0] * m_scales[0] * derivativesSquares[nodeX] *
+									valuesSquares[nodeY] * valuesSquares[nodeZ],
+								m_scales[1] * m_scales[1] * valuesSquares[nodeX] *
+									derivativesSquares[nodeY] * valuesSquares[nodeZ],
+								m_scales[2] * m_scales[2] * valuesSquares[nodeX] *
+									valuesSquares[nodeY] * derivativesSquares[nodeZ] };
+							const Real gradientsSum =
+								gradients[0] + gradients[1] + gradients[2];
+
+							const UnsignedType node = getHighOrderNode(mesh,
+								elementX * mesh.order + nodeX,
+								elementY * mesh.order + nodeY,
+								elementZ * mesh.order + nodeZ);
+							for (UnsignedType direction = 0;
+								direction < ELEMENT_DIMENSIONS_COUNT; ++direction)
+							{
+								m_diagonal[getMeshDof(node, direction)] +=
+									m_normal * gradients[direction] +
+									m_shear * (gradientsSum - gradients[direction]);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+UnsignedType HighOrderStiffnessOperator::sizeRows() const
+{
+	return m_diagonal.size();
+}
+
+void HighOrderStiffnessOperator::apply(const RealVector& vec,
+	RealVector& result) const
+{
+	if (vec.size() != m_diagonal.size())
+	{
+		std::string msg = "Vector size != matrix rows. ";
+		ERROR(msg);
+	}
+
+	result.assign(m_diagonal.size(), 0.0);
+	for (const auto& color : m_tileColors)
+	{
+		m_threadPool->run(color.size(), [&](const UnsignedType index)
+			{
+				applyTile(color[index], vec, result);
+			});
+	}
+
+	for (const auto& dof : m_penaltyDofs)
+		result[dof] += (STATIC_SIMMETRY - 1.0) * m_diagonal[dof] * vec[dof];
+}
+
+RealVector HighOrderStiffnessOperator::getDiagonal() const
+{
+	RealVector diagonal = m_diagonal;
+	for (const auto& dof : m_penaltyDofs)
+		diagonal[dof] *= STATIC_SIMMETRY;
+
+	return diagonal;
+}
+
+void HighOrderStiffnessOperator::boundConditionStatic()
+{
+	m_penaltyDofs = m_mesh.symmetryDofs;
+}
+
+// For each element: the gradient of the displacements at the Gauss points
+// (the derivative along one axis, the values along the others), the
+// stresses multiplied by the weights and then the forces of the nodes by
+// the transposed one-dimensional matrices
+void HighOrderStiffnessOperator::applyTile(const UnsignedType& tile,
+	const RealVector& vec, RealVector& result) const
+{
+	const HighOrderMesh& mesh = m_mesh;
+	const ElementTile elementTile = getElementTile(tile, mesh.countY, 1);
+	const UnsignedType layer = elementTile.layer;
+	const LagrangeBasis& basis = mesh.basis;
+	const RealVector& values = m_values;
+	const RealVector& derivatives = m_derivatives;
+	const RealVector& valuesTransposed = m_valuesTransposed;
+	const RealVector& derivativesTransposed = m_derivativesTransposed;
+	const UnsignedType order = mesh.order;
+	const UnsignedType size = order + 1;
+	const UnsignedType elementSize = size * size * size;
+
+	ElementValues displacements;
+	std::array<ElementValues, ELEMENT_DIMENSIONS_COUNT> gradients;
+	ElementValues forces;
+	RealVector first;
+	RealVector second;
+	RealVector third;
+	for (auto& component : displacements)
+		component.resize(elementSize);
+
+	// The weights of the Gauss points of the element
+	RealVector weights(elementSize);
+	for (UnsignedType index = 0; index < elementSize; ++index)
+	{
+		weights[index] = basis.gaussWeights[index % size] *
+			basis.gaussWeights[(index / size) % size] *
+			basis.gaussWeights[index / (size * size)];
+	}
+
+	for (UnsignedType elementY = elementTile.firstRow;
+		elementY < elementTile.endRow; ++elementY)
+	{
+		for (UnsignedType elementX = 0; elementX < mesh.countX; ++elementX)
+		{
+			for (UnsignedType index = 0; index < elementSize; ++index)
+			{
+				const UnsignedType node = getHighOrderNode(mesh,
+					elementX * order + index % size,
+					elementY * order + (index / size) % size,
+					layer * order + index / (size * size));
+				for (UnsignedType direction = 0;
+					direction < ELEMENT_DIMENSIONS_COUNT; ++direction)
+				{
+					displacements[direction][index] =
+						vec[getMeshDof(node, direction)];
+				}
+			}
+
+			// gradients[d][e] - the derivative of the displacement d by e
+			for (UnsignedType direction = 0; direction < ELEMENT_DIMENSIONS_COUNT;
+				++direction)
+			{
+				ElementValues& gradient = gradients[direction];
+				contractAxis(derivatives, 0, size, displacements[direction], first);
+				contractAxis(values, 1, size, first, second);
+				contractAxis(values, 2, size, second, gradient[0]);
+
+				contractAxis(values, 0, size, displacements[direction], first);
+				contractAxis(derivatives, 1, size, first, second);
+				contractAxis(values, 2, size, second, gradient[1]);
+
+				contractAxis(values, 1, size, first, second);
+				contractAxis(derivatives, 2, size, second, gradient[2]);
+			}
+
+			// The stresses multiplied by the weights and the derivatives of
+			// the local coordinates (in the place of the gradient)
+			for (UnsignedType index = 0; index < elementSize; ++index)
+			{
+				Array3D strains;
+				for (UnsignedType dim = 0; dim < ELEMENT_DIMENSIONS_COUNT; ++dim)
+					strains[dim] = m_scales[dim] * gradients[dim][dim][index];
+
+				const Real strainsSum = strains[0] + strains[1] + strains[2];
+				std::array<Array3D, ELEMENT_DIMENSIONS_COUNT> stresses;
+				for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+					++dimFirst)
+				{
+					stresses[dimFirst][dimFirst] = m_normal * strains[dimFirst] +
+						m_lateral * (strainsSum - strains[dimFirst]);
+					for (UnsignedType dimSecond = dimFirst + 1;
+						dimSecond < ELEMENT_DIMENSIONS_COUNT; ++dimSecond)
+					{
+						const Real stress = m_shear *
+							(m_scales[dimSecond] * gradients[dimFirst][dimSecond][index] +
+							m_scales[dimFirst] * gradients[dimSecond][dimFirst][index]);
+						stresses[dimFirst][dimSecond] = stress;
+						stresses[dimSecond][dimFirst] = stress;
+					}
+				}
+
+				for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+					++dimFirst)
+				{
+					for (UnsignedType dimSecond = 0;
+						dimSecond < ELEMENT_DIMENSIONS_COUNT; ++dimSecond)
+					{
+						gradients[dimFirst][dimSecond][index] = weights[index] *
+							m_scales[dimSecond] * stresses[dimFirst][dimSecond];
+					}
+				}
+			}
+
+			// The forces: the transposed matrices in the reverse order
+			for (UnsignedType direction = 0; direction < ELEMENT_DIMENSIONS_COUNT;
+				++direction)
+			{
+				ElementValues& flux = gradients[direction];
+				RealVector& force = forces[direction];
+
+				contractAxis(valuesTransposed, 2, size, flux[0], first);
+				contractAxis(valuesTransposed, 1, size, first, second);
+				contractAxis(derivativesTransposed, 0, size, second, force);
+
+				contractAxis(valuesTransposed, 2, size, flux[1], first);
+				contractAxis(derivativesTransposed, 1, size, first, second);
+				contractAxis(derivativesTransposed, 2, size, flux[2], first);
+				contractAxis(valuesTransposed, 1, size, first, third);
+				for (UnsignedType index = 0; index < elementSize; ++index)
+					second[index] += third[index];
+				contractAxis(valuesTransposed, 0, size, second, third);
+				for (UnsignedType index = 0; index < elementSize; ++index)
+					force[index] += third[index];
+			}
+
+			for (UnsignedType index = 0; index < elementSize; ++index)
+			{
+				const UnsignedType node = getHighOrderNode(mesh,
+					elementX * order + index % size,
+					elementY * order + (index / size) % size,
+					layer * order + index / (size * size));
+				for (UnsignedType direction = 0;
+					direction < ELEMENT_DIMENSIONS_COUNT; ++direction)
+				{
+					result[getMeshDof(node, direction)] += forces[direction][index];
+				}
+			}
+		}
+	}
+}
+
+IterativeSolution MFE::calculateDispStaticHighOrder(const HighOrderMesh& mesh,
+	const Real& initialForce, const IterativeSolverOptions& options,
+	const UnsignedType& threadsCount)
+{
+	HighOrderStiffnessOperator matrixStiffness(mesh, threadsCount);
+	matrixStiffness.boundConditionStatic();
+
+	return solveConjugateGradient(matrixStiffness,
+		makeStaticForceHighOrder(mesh, initialForce), options);
+}
@@ -0,0 +1,534 @@
+#include <MFE_lib/functions_for_MFE/history_codec.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "error_handling/error_handling.h"
+
+// The predictions of the encoder and of the decoder must be equal bit for
+// bit in all builds: the multiplication and the addition must not be
+// contracted into FMA (GCC does not know the pragma, the file is compiled
+// with -ffp-contract=off, see CMakeLists.txt)
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+using namespace MFE;
+
+namespace
+{
+	constexpr char COMPRESSED_MAGIC[8] = { 'M', 'F', 'E', 'C', 'M', 'P', '0', '1' };
+	constexpr std::uint32_t COMPRESSED_VERSION = 1;
+	constexpr std::uint32_t COMPRESSED_BYTE_ORDER = 0x01020304;
+
+	constexpr UnsignedType WORD_BITS = 64;
+
+	// The number of the meaningful bits is written by 6 bits (1 - 64)
+	constexpr UnsignedType LENGTH_BITS = 6;
+
+	// The previous number of the meaningful bits is used if it is greater
+	// by no more than this (otherwise the new number is written)
+	constexpr UnsignedType LENGTH_SLACK = 4;
+
+	// The control bits: the value is equal to the previous value (sticking),
+	// the previous number of the meaningful bits, the new number
+	constexpr std::uint64_t CONTROL_REPEAT = 0;
+	constexpr std::uint64_t CONTROL_LENGTH_PREVIOUS = 2;
+	constexpr std::uint64_t CONTROL_LENGTH_NEW = 3;
+
+	// The series of "count" values takes at least WORD_BITS bits for the
+	// first value and one bit for each next value
+	constexpr UnsignedType MIN_NEXT_VALUE_BITS = 1;
+}
+
+static std::uint64_t getBits(const Real& value)
+{
+	std::uint64_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	return bits;
+}
+
+static Real getReal(const std::uint64_t& bits)
+{
+	Real value = 0.0;
+	std::memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+// The number of the meaningful bits, x must not be 0
+static UnsignedType getBitsLength(const std::uint64_t& x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return WORD_BITS - __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index = 0;
+	_BitScanReverse64(&index, x);
+	return index + 1;
+#else
+	UnsignedType length = 0;
+	for (std::uint64_t rest = x; rest != 0; rest >>= 1)
+		++length;
+	return length;
+#endif
+}
+
+// The difference of the bits as a signed number is written so that small
+// negative differences are small too: 0, -1, 1, -2, 2 -> 0, 1, 2, 3, 4
+static std::uint64_t encodeDifference(const std::uint64_t& difference)
+{
+	return (difference << 1) ^ (0 - (difference >> (WORD_BITS - 1)));
+}
+
+static std::uint64_t decodeDifference(const std::uint64_t& code)
+{
+	return (code >> 1) ^ (0 - (code & 1));
+}
+
+// The prediction of the value by the "count" previous values, the last is
+// the first (the order of the polynomial is limited by the number of values)
+static Real predict(const CodecPredictor& predictor, const UnsignedType& count,
+	const std::array<Real, CODEC_HISTORY_SIZE>& previous)
+{
+	const UnsignedType order = std::min<UnsignedType>(predictor, count - 1);
+	switch (order)
+	{
+	case 1:
+		return 2.0 * previous[0] - previous[1];
+	case 2:
+		return 3.0 * previous[0] - 3.0 * previous[1] + previous[2];
+	case 3:
+		return 4.0 * previous[0] - 6.0 * previous[1] + 4.0 * previous[2] -
+			previous[3];
+	default:
+		return previous[0];
+	}
+}
+
+static void shiftPrevious(std::array<Real, CODEC_HISTORY_SIZE>& previous,
+	const Real& value)
+{
+	for (UnsignedType valueNum = CODEC_HISTORY_SIZE - 1; valueNum > 0; --valueNum)
+		previous[valueNum] = previous[valueNum - 1];
+	previous[0] = value;
+}
+
+SeriesEncoder::SeriesEncoder(const CodecPredictor& predictor)
+{
+	m_series.predictor = predictor;
+}
+
+void SeriesEncoder::add(const Real& value)
+{
+	const std::uint64_t bits = getBits(value);
+	if (m_series.count == 0)
+	{
+		writeBits(bits, WORD_BITS);
+	}
+	else
+	{
+		const std::uint64_t code = encodeDifference(bits -
+			getBits(predict(m_series.predictor, m_series.count, m_previous)));
+		if (bits == getBits(m_previous[0]))
+		{
+			writeBits(CONTROL_REPEAT, 1);
+		}
+		else
+		{
+			const UnsignedType length = code == 0 ? 1 : getBitsLength(code);
+			if (length <= m_length && m_length - length <= LENGTH_SLACK)
+			{
+				writeBits(CONTROL_LENGTH_PREVIOUS, 2);
+				writeBits(code, m_length);
+			}
+			else
+			{
+				writeBits(CONTROL_LENGTH_NEW, 2);
+				writeBits(length - 1, LENGTH_BITS);
+				writeBits(code, length);
+				m_length = length;
+			}
+		}
+	}
+
+	shiftPrevious(m_previous, value);
+	++m_series.count;
+}
+
+const CompressedSeries& SeriesEncoder::getSeries() const
+{
+	return m_series;
+}
+
+UnsignedType SeriesEncoder::getSize() const
+{
+	return m_series.words.size() * sizeof(std::uint64_t);
+}
+
+// Writing the lower "bitsCount" bits, starting from the highest of them
+void SeriesEncoder::writeBits(const std::uint64_t& bits,
+	const UnsignedType& bitsCount)
+{
+	if (bitsCount == 0)
+		return;
+
+	const std::uint64_t value = bitsCount == WORD_BITS ? bits :
+		bits & ((std::uint64_t(1) << bitsCount) - 1);
+
+	const UnsignedType position = m_series.bitsCount % WORD_BITS;
+	if (position == 0)
+		m_series.words.push_back(0);
+
+	const UnsignedType free = WORD_BITS - position;
+	if (bitsCount <= free)
+	{
+		m_series.words.back() |= value << (free - bitsCount);
+	}
+	else
+	{
+		const UnsignedType rest = bitsCount - free;
+		m_series.words.back() |= value >> rest;
+		m_series.words.push_back(value << (WORD_BITS - rest));
+	}
+
+	m_series.bitsCount += bitsCount;
+}
+
+SeriesDecoder::SeriesDecoder(const CompressedSeries& series) :
+	m_series(series) {}
+
+bool SeriesDecoder::next(Real& value)
+{
+	if (m_valueNum == m_series.count)
+		return false;
+
+	if (m_valueNum == 0)
+	{
+		value = getReal(readBits(WORD_BITS));
+	}
+	else
+	{
+		if (readBits(1) == CONTROL_REPEAT)
+		{
+			value = m_previous[0];
+		}
+		else
+		{
+			if (readBits(1) == (CONTROL_LENGTH_NEW & 1))
+				m_length = readBits(LENGTH_BITS) + 1;
+			else if (m_length == 0)
+			{
+				std::string msg = "The compressed series is damaged. ";
+				ERROR(msg);
+			}
+
+			const std::uint64_t code = readBits(m_length);
+			value = getReal(getBits(predict(m_series.predictor, m_valueNum,
+				m_previous)) + decodeDifference(code));
+		}
+	}
+
+	shiftPrevious(m_previous, value);
+	++m_valueNum;
+
+	return true;
+}
+
+std::uint64_t SeriesDecoder::readBits(const UnsignedType& bitsCount)
+{
+	if (bitsCount == 0)
+		return 0;
+
+	if (m_bitNum + bitsCount > m_series.bitsCount ||
+		m_series.words.size() * WORD_BITS < m_series.bitsCount)
+	{
+		std::string msg = "The compressed series is damaged. ";
+		ERROR(msg);
+	}
+
+	const UnsignedType wordNum = m_bitNum / WORD_BITS;
+	const UnsignedType position = m_bitNum % WORD_BITS;
+	const UnsignedType free = WORD_BITS - position;
+
+	std::uint64_t bits = 0;
+	if (bitsCount <= free)
+	{
+		bits = m_series.words[wordNum] << position;
+		bits = bits >> (WORD_BITS - bitsCount);
+	}
+	else
+	{
+		const UnsignedType rest = bitsCount - free;
+		bits = ((m_series.words[wordNum] << position) >> position) << rest;
+		bits |= m_series.words[wordNum + 1] >> (WORD_BITS - rest);
+	}
+
+	m_bitNum += bitsCount;
+
+	return bits;
+}
+
+CompressedSeries MFE::compressSeries(const RealVector& values,
+	const CodecPredictor& predictor)
+{
+	SeriesEncoder encoder(predictor);
+	for (const auto& value : values)
+		encoder.add(value);
+
+	return encoder.getSeries();
+}
+
+RealVector MFE::decompressSeries(const CompressedSeries& series)
+{
+	RealVector values;
+	values.reserve(series.count);
+
+	SeriesDecoder decoder(series);
+	Real value = 0.0;
+	while (decoder.next(value))
+		values.push_back(value);
+
+	return values;
+}
+
+CompressedSink::CompressedSink(const std::vector<UnsignedType>& indices,
+	const CodecPredictor& predictor) :
+	m_predictor(predictor)
+{
+	if (indices.empty())
+	{
+		std::string msg = "The indices of the compressed history are not set. ";
+		ERROR(msg);
+	}
+
+	m_history.indices = indices;
+}
+
+void CompressedSink::begin(const SinkHeader& header)
+{
+	const UnsignedType lastIndex =
+		*std::max_element(m_history.indices.begin(), m_history.indices.end());
+	if (lastIndex >= header.dofCount)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	m_history.deltaT = header.deltaT;
+	m_history.steps = CompressedSeries();
+	m_history.channels.clear();
+
+	// The step numbers are increased by 1, the linear prediction is exact
+	m_stepsEncoder = SeriesEncoder(CODEC_LINEAR);
+	m_encoders.assign(m_history.indices.size(), SeriesEncoder(m_predictor));
+}
+
+void CompressedSink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool&)
+{
+	m_stepsEncoder.add(static_cast<Real>(step));
+
+	const UnsignedType channelsCount = m_history.indices.size();
+	for (UnsignedType channelNum = 0; channelNum < channelsCount; ++channelNum)
+		m_encoders[channelNum].add(displacement[m_history.indices[channelNum]]);
+}
+
+void CompressedSink::end()
+{
+	m_history.steps = m_stepsEncoder.getSeries();
+	m_history.channels.clear();
+	for (const auto& encoder : m_encoders)
+		m_history.channels.push_back(encoder.getSeries());
+
+	m_stepsEncoder = SeriesEncoder(CODEC_LINEAR);
+	m_encoders.clear();
+}
+
+const CompressedHistory& CompressedSink::getHistory() const
+{
+	return m_history;
+}
+
+RealVector CompressedSink::getChannel(const UnsignedType& index) const
+{
+	const auto& indices = m_history.indices;
+	const auto channel = std::find(indices.begin(), indices.end(), index);
+	if (channel == indices.end() || m_history.channels.empty())
+	{
+		std::string msg = "The degree of freedom " + std::to_string(index) +
+			" is not in the compressed history. ";
+		ERROR(msg);
+	}
+
+	return decompressSeries(m_history.channels[channel - indices.begin()]);
+}
+
+UnsignedType CompressedSink::getSize() const
+{
+	UnsignedType size = m_history.steps.words.size();
+	for (const auto& channel : m_history.channels)
+		size += channel.words.size();
+
+	return size * sizeof(std::uint64_t);
+}
+
+UnsignedType CompressedSink::getRawSize() const
+{
+	return m_history.steps.count * (m_history.channels.size() + 1) *
+		sizeof(Real);
+}
+
+static void writeSeries(std::ofstream& fout, const CompressedSeries& series)
+{
+	const std::uint64_t header[4] = { static_cast<std::uint64_t>(series.predictor),
+		series.count, series.bitsCount, series.words.size() };
+	fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+	fout.write(reinterpret_cast<const char*>(series.words.data()),
+		series.words.size() * sizeof(std::uint64_t));
+}
+
+// The number of bytes from the current position to the end of the file
+static std::uint64_t getRestSize(std::ifstream& fin)
+{
+	const std::streampos position = fin.tellg();
+	fin.seekg(0, std::ios::end);
+	const std::streampos end = fin.tellg();
+	fin.seekg(position);
+	if (!fin.good() || position < 0 || end < position)
+		return 0;
+
+	return static_cast<std::uint64_t>(end - position);
+}
+
+// The header of the series: the predictor, the number of values, the number
+// of bits and the number of words
+static bool isSeriesHeaderCorrect(const std::uint64_t header[4],
+	const std::uint64_t& restSize)
+{
+	const std::uint64_t count = header[1];
+	const std::uint64_t bitsCount = header[2];
+	const std::uint64_t wordsCount = header[3];
+
+	const bool isCountCorrect = count == 0 ? bitsCount == 0 :
+		bitsCount >= WORD_BITS &&
+		(bitsCount - WORD_BITS) / MIN_NEXT_VALUE_BITS >= count - 1;
+
+	return header[0] <= CODEC_CUBIC && isCountCorrect &&
+		wordsCount == (bitsCount + WORD_BITS - 1) / WORD_BITS &&
+		wordsCount <= restSize / sizeof(std::uint64_t);
+}
+
+static CompressedSeries readSeries(std::ifstream& fin, const std::string& msg)
+{
+	std::uint64_t header[4] = {};
+	fin.read(reinterpret_cast<char*>(header), sizeof(header));
+
+	const bool isCorrect = fin.good() &&
+		isSeriesHeaderCorrect(header, getRestSize(fin));
+	if (!isCorrect)
+		ERROR(msg);
+
+	CompressedSeries series;
+	series.predictor = static_cast<CodecPredictor>(header[0]);
+	series.count = header[1];
+	series.bitsCount = header[2];
+	series.words.resize(header[3]);
+	fin.read(reinterpret_cast<char*>(series.words.data()),
+		series.words.size() * sizeof(std::uint64_t));
+	if (!fin.good())
+		ERROR(msg);
+
+	return series;
+}
+
+bool MFE::writeCompressedHistory(const CompressedHistory& history,
+	const std::string& fileName)
+{
+	std::ofstream fout(fileName, std::ios::binary);
+	if (!fout.is_open())
+	{
+		std::string msg = "The file \"" + fileName + "\" was not opened. ";
+		WARNING(msg);
+		return false;
+	}
+
+	const std::uint32_t version[2] = { COMPRESSED_VERSION, COMPRESSED_BYTE_ORDER };
+	const std::uint64_t channelsCount = history.indices.size();
+	std::vector<std::uint64_t> indices(history.indices.begin(),
+		history.indices.end());
+
+	fout.write(COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+	fout.write(reinterpret_cast<const char*>(version), sizeof(version));
+	fout.write(reinterpret_cast<const char*>(&history.deltaT),
+		sizeof(history.deltaT));
+	fout.write(reinterpret_cast<const char*>(&channelsCount),
+		sizeof(channelsCount));
+	fout.write(reinterpret_cast<const char*>(indices.data()),
+		indices.size() * sizeof(std::uint64_t));
+
+	writeSeries(fout, history.steps);
+	for (const auto& channel : history.channels)
+		writeSeries(fout, channel);
+
+	fout.close();
+	if (fout.fail())
+	{
+		std::string msg = "The compressed history is not recorded. ";
+		WARNING(msg);
+		return false;
+	}
+
+	return true;
+}
+
+CompressedHistory MFE::readCompressedHistory(const std::string& fileName)
+{
+	std::ifstream fin(fileName, std::ios::binary);
+	if (!fin.is_open())
+	{
+		std::string msg = "The file \"" + fileName + "\" was not opened. ";
+		ERROR(msg);
+	}
+
+	const std::string msg = "The compressed history \"" + fileName +
+		"\" is damaged. ";
+
+	char magic[sizeof(COMPRESSED_MAGIC)] = {};
+	std::uint32_t version[2] = {};
+	CompressedHistory history;
+	std::uint64_t channelsCount = 0;
+	fin.read(magic, sizeof(magic));
+	fin.read(reinterpret_cast<char*>(version), sizeof(version));
+	fin.read(reinterpret_cast<char*>(&history.deltaT), sizeof(history.deltaT));
+	fin.read(reinterpret_cast<char*>(&channelsCount), sizeof(channelsCount));
+
+	const bool isCorrect = fin.good() &&
+		std::memcmp(magic, COMPRESSED_MAGIC, sizeof(magic)) == 0 &&
+		version[0] == COMPRESSED_VERSION && version[1] == COMPRESSED_BYTE_ORDER &&
+		channelsCount != 0 && channelsCount < (1 << 20);
+	if (!isCorrect)
+		ERROR(msg);
+
+	std::vector<std::uint64_t> indices(channelsCount);
+	fin.read(reinterpret_cast<char*>(indices.data()),
+		indices.size() * sizeof(std::uint64_t));
+	history.indices.assign(indices.begin(), indices.end());
+
+	history.steps = readSeries(fin, msg);
+	for (std::uint64_t channelNum = 0; channelNum < channelsCount; ++channelNum)
+	{
+		history.channels.push_back(readSeries(fin, msg));
+		if (history.channels.back().count != history.steps.count)
+			ERROR(msg);
+	}
+
+	return history;
+}
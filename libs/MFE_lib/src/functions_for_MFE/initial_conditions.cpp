@@ -26,6 +26,46 @@ Real MFE::inputDeltaT()
 	return deltaT;
 }
 
+// The choice of the initial static load
+Real MFE::inputInitialStaticLoad()
+{
+	char choice = 'n';
+	std::cout << "Do you want to set an initial displacements from " <<
+		"a static task (y / n)? \n";
+	inputChoice(choice);
+
+	Real force = 0.0;
+	if (choice == 'y' || choice == 'Y')
+	{
+		std::cout << "Input the initial static load acting on the edge: \n";
+		inputValue(force);
+	}
+	else
+		std::cout << "Zero initial conditions are set" << "\n\n";
+
+	return force;
+}
+
+// Initial speed setting function
+Real MFE::inputInitialSpeed()
+{
+	Real speed = 0.0;
+	std::cout << "Input the initial speed: \n";
+	inputValue(speed);
+
+	return speed;
+}
+
+// Initial acceleration setting function
+Real MFE::inputInitialAccel()
+{
+	Real acceleration = 0.0;
+	std::cout << "Input the initial acceleration: \n";
+	inputValue(acceleration);
+
+	return acceleration;
+}
+
 // Setting the vector of initial static forces by active degrees of freedom
 // to set the initial displacements
 RealVector MFE::makeInitialStaticForce(const Real& initialForce,
@@ -61,44 +101,37 @@ RealVector MFE::makeInitialStaticForce(const Real& initialForce,
 RealVector MFE::makeInitialDisps
 (RealMatrix matrixStiffness)
 {
-	const UnsignedType size = matrixStiffness.sizeRows();
-	char choice = 'n';
-	std::cout << "Do you want to set an initial displacements from " <<
-		"a static task (y / n)? \n";
-	inputChoice(choice);
+	return makeInitialDisps(matrixStiffness, inputInitialStaticLoad());
+}
 
+// Setting the initial displacements from a static problem
+RealVector MFE::makeInitialDisps(RealMatrix matrixStiffness,
+	const Real& initialStaticLoad)
+{
+	const UnsignedType size = matrixStiffness.sizeRows();
 	RealVector vectorInitial(size, 0.0);
-	if (choice == 'y' || choice == 'Y')
+	if (initialStaticLoad != 0.0)
 	{
-
 		boundConditionStatic(matrixStiffness);
 
-		Real force = 0.0;
-		std::cout << "Input the initial static load acting on the edge: \n";
-		inputValue(force);
-
-		if (force != 0.0)
-		{
-			RealVector initialForceStatic =
-				makeInitialStaticForce(force, size);
-			// Solution for static problem
-			vectorInitial =
-				calculateDispStatic(matrixStiffness, initialForceStatic);
-		}
+		RealVector initialForceStatic =
+			makeInitialStaticForce(initialStaticLoad, size);
+		// Solution for static problem
+		vectorInitial =
+			calculateDispStatic(matrixStiffness, initialForceStatic);
 	}
-	else
-		std::cout << "Zero initial conditions are set" << "\n\n";
 
 	return vectorInitial;
 }
 
 RealVector MFE::makeInitialSpeed(const UnsignedType& size)
 {
-	RealVector vectorInitial(size, 0.0);
-	Real speed = 0.0;
-	std::cout << "Input the initial speed: \n";
-	inputValue(speed);
+	return makeInitialSpeed(size, inputInitialSpeed());
+}
 
+RealVector MFE::makeInitialSpeed(const UnsignedType& size, const Real& speed)
+{
+	RealVector vectorInitial(size, 0.0);
 	if (speed != 0.0)
 	{
 		for (auto index : INDICES_INITIAL)
@@ -120,11 +153,13 @@ RealVector MFE::makeInitialSpeed(const UnsignedType& size)
 
 RealVector MFE::makeInitialAccel(const UnsignedType& size)
 {
-	RealVector vectorInitial(size, 0.0);
-	Real acceleration = 0.0;
-	std::cout << "Input the initial acceleration: \n";
-	inputValue(acceleration);
+	return makeInitialAccel(size, inputInitialAccel());
+}
 
+RealVector MFE::makeInitialAccel(const UnsignedType& size,
+	const Real& acceleration)
+{
+	RealVector vectorInitial(size, 0.0);
 	if (acceleration != 0.0)
 	{
 		for (auto index : INDICES_INITIAL)
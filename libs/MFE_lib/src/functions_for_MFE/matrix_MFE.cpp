@@ -1,4 +1,5 @@
 #include <MFE_lib/functions_for_MFE/matrix_MFE.h>
+#include <MFE_lib/functions_for_MFE/reference_element.h>
 
 #include "error_handling/error_handling.h"
 #include "inputFunctions/inputFunctions.h"
@@ -368,150 +369,262 @@ RealMatrix MFE::makeMatrixMassDiag(const UnsignedType& size,
 	return matrix;
 }
 
-// This function creates a matrix stiffness.
-RealMatrix MFE::makeMatrixStiffness(const FiniteElement& finiteElement)
+// The dimensions of the element and the Poisson's ratio for the stiffness
+void MFE::checkStiffnessProperties(const FiniteElement& finiteElement)
 {
-	const Real length = finiteElement.length;
-	const Real width = finiteElement.width;
-	const Real height = finiteElement.heigth;
-	const Real detMatrixJacobian = length * width * height / 8.0;
+	const Array3D dimensions{ finiteElement.length, finiteElement.width,
+		finiteElement.heigth };
+	for (const auto& dimension : dimensions)
+	{
+		if (dimension < MIN_SIZE_FINITE_ELEMENT)
+		{
+			std::string msg = "The size of the finite element is less than " +
+				std::to_string(MIN_SIZE_FINITE_ELEMENT);
+			ERROR(msg);
+		}
+	}
 
-	const Real modulusElastic = finiteElement.modulusElastic;
 	const Real poissonRatio = finiteElement.poissonRatio;
-	RealMatrix ElasticConst = makeMatrixElConst(6, 6, modulusElastic,
-		poissonRatio);
-
-	const UnsignedType rowsElastic = ElasticConst.sizeRows();
-
-	RealMatrix locCoord = getLocalCoordinate();
-	const UnsignedType rowsLocCord = locCoord.sizeRows();
-	const UnsignedType columnsLocCoord = locCoord.sizeColumns();
-	RealMatrix quadPoints = 
-		makeMatrixQuadPoints(rowsLocCord, columnsLocCoord, locCoord);
-	const UnsignedType columnsQuad = quadPoints.sizeColumns();
-
-	const UnsignedType sizeStiffness = rowsLocCord * columnsQuad;
-	RealMatrix result(sizeStiffness, sizeStiffness);
-	for (UnsignedType integPoint = 0; integPoint < columnsQuad; integPoint++)
-	{
-		UnsignedType nodeLoc = 0;
-		Array3D locPoint{ locCoord[0][nodeLoc], locCoord[1][nodeLoc],
-					locCoord[2][nodeLoc] };
-
-		// construction of the differentiation matrix
-		RealMatrix matrixDifferentiation(rowsElastic, sizeStiffness);
-		for (UnsignedType indexNotZero = 0; indexNotZero < sizeStiffness - 2;
-			indexNotZero += 3)
-		{
-			locPoint = { locCoord[0][nodeLoc], locCoord[1][nodeLoc],
-					locCoord[2][nodeLoc] };
+	if (poissonRatio >= LIM_POISSONS_RATIO)
+	{
+		std::string msg = "The Poisson's ratio is greater than or "
+			"equal to 0.5. ";
+		ASSERT(poissonRatio < LIM_POISSONS_RATIO, msg);
+		ERROR(msg);
+	}
+}
 
-			matrixDifferentiation[0][indexNotZero] = 
-				dShapeFuncKsi(locPoint, quadPoints[1][integPoint],
-				quadPoints[2][integPoint], length);
+// The stiffness matrix of the reduced integration for the modulus of
+// elasticity 1: the one-point matrix V * Bc^T * D * Bc plus the hourglass
+// stiffness k * sum(gamma[a] * gamma[a]^T) for each direction
+static RealMatrix makeMatrixStiffnessReduced(const ReducedElement& element)
+{
+	const auto& derivatives = element.derivatives;
+	const Real volume = element.volume;
+	RealMatrix result(ELEMENT_DOF_COUNT, ELEMENT_DOF_COUNT);
+	for (UnsignedType nodeFirst = 0; nodeFirst < ELEMENT_NODES_COUNT; ++nodeFirst)
+	{
+		const Array3D& first = derivatives[nodeFirst];
+		for (UnsignedType nodeSecond = nodeFirst; nodeSecond < ELEMENT_NODES_COUNT;
+			++nodeSecond)
+		{
+			const Array3D& second = derivatives[nodeSecond];
+			const Real diagonalSum = first[0] * second[0] + first[1] * second[1] +
+				first[2] * second[2];
 
-			matrixDifferentiation[1][indexNotZero + 1] = 
-				dShapeFuncEtta(locPoint, quadPoints[0][integPoint],
-				quadPoints[2][integPoint], width);
+			Real hourglass = 0.0;
+			for (const auto& vector : element.hourglassVectors)
+				hourglass += vector[nodeFirst] * vector[nodeSecond];
+			hourglass *= element.hourglassStiffness;
 
-			matrixDifferentiation[2][indexNotZero + 2] = 
-				dShapeFuncPsi(locPoint, quadPoints[0][integPoint],
-				quadPoints[1][integPoint], height);
-			nodeLoc++;
+			for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+				++dimFirst)
+			{
+				const UnsignedType rowNum =
+					nodeFirst * ELEMENT_DIMENSIONS_COUNT + dimFirst;
+				for (UnsignedType dimSecond = 0;
+					dimSecond < ELEMENT_DIMENSIONS_COUNT; ++dimSecond)
+				{
+					const UnsignedType columnNum =
+						nodeSecond * ELEMENT_DIMENSIONS_COUNT + dimSecond;
+					Real value = 0.0;
+					if (dimFirst == dimSecond)
+					{
+						const Real diagonal = first[dimFirst] * second[dimFirst];
+						value = volume * (element.normal * diagonal +
+							element.shear * (diagonalSum - diagonal)) + hourglass;
+					}
+					else
+					{
+						value = volume *
+							(element.lateral * first[dimFirst] * second[dimSecond] +
+							element.shear * first[dimSecond] * second[dimFirst]);
+					}
+
+					result[rowNum][columnNum] = value;
+					result[columnNum][rowNum] = value;
+				}
+			}
 		}
+	}
 
-		nodeLoc = 0;
-		for (UnsignedType indexNotZero = 0; indexNotZero < sizeStiffness - 2;
-			indexNotZero += 3)
-		{
-			locPoint = { locCoord[0][nodeLoc], locCoord[1][nodeLoc],
-			locCoord[2][nodeLoc] };
-
-			matrixDifferentiation[3][indexNotZero] = 
-				dShapeFuncEtta(locPoint, quadPoints[0][integPoint],
-				quadPoints[2][integPoint], width);
+	return result;
+}
 
-			matrixDifferentiation[3][indexNotZero + 1] = 
-				dShapeFuncKsi(locPoint, quadPoints[1][integPoint],
-				quadPoints[2][integPoint], length);
-			nodeLoc++;
-		}
+// The element of the reduced integration: the derivatives of the shape
+// functions at the center b[i][d] = s[i][d] / (4 * dim[d]) (s - the local
+// coordinates of the nodes), the one-point matrix has no stiffness of the 12
+// hourglass modes, they get the stiffness of Flanagan and Belytschko
+// k = kappa * (lambda + 2 * mu) * V * b[i][d] * b[i][d]. For the brick the
+// hourglass vectors are orthogonal to the linear fields, so
+// gamma[a] = h[a] / 8 with the base vectors h of the modes (etta * psi,
+// ksi * psi, ksi * etta, ksi * etta * psi in the nodes). The linear fields
+// (the patch test) do not depend on kappa.
+ReducedElement MFE::makeReducedElement(const FiniteElement& finiteElement)
+{
+	checkStiffnessProperties(finiteElement);
+	if (!(finiteElement.hourglassCoefficient >= 0.0))
+	{
+		std::string msg = "The hourglass coefficient must not be negative. ";
+		ERROR(msg);
+	}
 
-		nodeLoc = 0;
-		for (UnsignedType indexNotZero = 0; indexNotZero < sizeStiffness - 2;
-			indexNotZero += 3)
-		{
-			locPoint = { locCoord[0][nodeLoc], locCoord[1][nodeLoc],
-			locCoord[2][nodeLoc] };
+	const Array3D dimensions{ finiteElement.length, finiteElement.width,
+		finiteElement.heigth };
+	const Real poissonRatio = finiteElement.poissonRatio;
 
-			matrixDifferentiation[4][indexNotZero + 1] = 
-				dShapeFuncPsi(locPoint, quadPoints[0][integPoint],
-				quadPoints[1][integPoint], height);
+	ReducedElement element;
+	element.volume = dimensions[0] * dimensions[1] * dimensions[2];
+	element.normal = (1.0 - poissonRatio) /
+		(1.0 + poissonRatio) / (1.0 - 2.0 * poissonRatio);
+	element.lateral = poissonRatio /
+		(1.0 + poissonRatio) / (1.0 - 2.0 * poissonRatio);
+	element.shear = 1.0 / (2.0 * (1.0 + poissonRatio));
 
-			matrixDifferentiation[4][indexNotZero + 2] = 
-				dShapeFuncEtta(locPoint, quadPoints[0][integPoint],
-				quadPoints[2][integPoint], width);
-			nodeLoc++;
+	Real derivativesNorm = 0.0;
+	for (UnsignedType node = 0; node < ELEMENT_NODES_COUNT; ++node)
+	{
+		const Array3D& local = REFERENCE_NODES[node];
+		for (UnsignedType dim = 0; dim < ELEMENT_DIMENSIONS_COUNT; ++dim)
+		{
+			const Real derivative = local[dim] / (4.0 * dimensions[dim]);
+			element.derivatives[node][dim] = derivative;
+			derivativesNorm += derivative * derivative;
 		}
 
-		nodeLoc = 0;
-		for (UnsignedType indexNotZero = 0; indexNotZero < sizeStiffness - 2;
-			indexNotZero += 3)
-		{
-			locPoint = { locCoord[0][nodeLoc], locCoord[1][nodeLoc],
-			locCoord[2][nodeLoc] };
+		element.hourglassVectors[0][node] = local[1] * local[2] / 8.0;
+		element.hourglassVectors[1][node] = local[0] * local[2] / 8.0;
+		element.hourglassVectors[2][node] = local[0] * local[1] / 8.0;
+		element.hourglassVectors[3][node] = local[0] * local[1] * local[2] / 8.0;
+	}
 
-			matrixDifferentiation[5][indexNotZero] = 
-				dShapeFuncPsi(locPoint, quadPoints[0][integPoint],
-				quadPoints[1][integPoint], height);
+	element.hourglassStiffness = finiteElement.hourglassCoefficient *
+		element.normal * element.volume * derivativesNorm;
 
-			matrixDifferentiation[5][indexNotZero + 2] = 
-				dShapeFuncKsi(locPoint, quadPoints[1][integPoint],
-				quadPoints[2][integPoint], length);
-			nodeLoc++;
-		}
+	return element;
+}
+
+// This function creates a matrix stiffness. The products of the
+// derivatives of the shape functions are summed by the Gauss points at compile
+// time (REFERENCE_BLOCKS), for the brick they are only divided by the
+// dimensions. The block of the nodes i, j (the directions p, q) is
+// detJ * (D11 * S[p][p] / dim[p]^2 + G * sum(S[r][r] / dim[r]^2, r != p)),
+// if p == q, and detJ * (D12 * S[p][q] + G * S[q][p]) / (dim[p] * dim[q]),
+// if p != q, where S = REFERENCE_BLOCKS[i][j], D11, D12, G are the elastic
+// constants (makeMatrixElConst) for the modulus of elasticity 1. The element
+// with the reduced integration is given by makeReducedElement.
+RealMatrix MFE::makeMatrixStiffnessPerModulus(const FiniteElement& finiteElement)
+{
+	switch (finiteElement.formulation)
+	{
+	case FORMULATION_FULL_INTEGRATION:
+		break;
+	case FORMULATION_REDUCED_INTEGRATION:
+		return makeMatrixStiffnessReduced(makeReducedElement(finiteElement));
+	default:
+	{
+		std::string msg = "Unknown formulation of the finite element. ";
+		ERROR(msg);
+	}
+	}
 
-		RealMatrix matrixBt = transpose(matrixDifferentiation);
-		RealMatrix matrixBtD = makeMatrixBtD(matrixBt, ElasticConst);
+	checkStiffnessProperties(finiteElement);
+	const Array3D dimensions{ finiteElement.length, finiteElement.width,
+		finiteElement.heigth };
+	const Real poissonRatio = finiteElement.poissonRatio;
 
-		// Obtaining the final stiffness matrix
-		if (matrixBtD.sizeRows() < sizeStiffness ||
-			matrixDifferentiation.sizeColumns() < sizeStiffness)
+	// The elastic constants of makeMatrixElConst for the modulus 1
+	const Real normal = (1.0 - poissonRatio) /
+		(1.0 + poissonRatio) / (1.0 - 2.0 * poissonRatio);
+	const Real lateral = poissonRatio /
+		(1.0 + poissonRatio) / (1.0 - 2.0 * poissonRatio);
+	const Real shear = 1.0 / (2.0 * (1.0 + poissonRatio));
+
+	// detJ / (dim[p] * dim[q])
+	const Real detMatrixJacobian =
+		dimensions[0] * dimensions[1] * dimensions[2] / 8.0;
+	std::array<Array3D, ELEMENT_DIMENSIONS_COUNT> factors;
+	for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+		++dimFirst)
+	{
+		for (UnsignedType dimSecond = 0; dimSecond < ELEMENT_DIMENSIONS_COUNT;
+			++dimSecond)
 		{
-			std::string msg = messageOutOfRange();
-			ERROR(msg);
+			factors[dimFirst][dimSecond] = detMatrixJacobian /
+				(dimensions[dimFirst] * dimensions[dimSecond]);
 		}
+	}
 
-		for (UnsignedType rowNum = 0; rowNum < sizeStiffness; ++rowNum)
+	// The matrix is symmetric, the blocks j >= i are calculated
+	RealMatrix result(ELEMENT_DOF_COUNT, ELEMENT_DOF_COUNT);
+	for (UnsignedType nodeFirst = 0; nodeFirst < ELEMENT_NODES_COUNT; ++nodeFirst)
+	{
+		for (UnsignedType nodeSecond = nodeFirst; nodeSecond < ELEMENT_NODES_COUNT;
+			++nodeSecond)
 		{
-			for (UnsignedType columnNum = 0; columnNum < sizeStiffness;
-				++columnNum)
+			const auto& block = REFERENCE_BLOCKS[nodeFirst][nodeSecond];
+			Array3D diagonal;
+			for (UnsignedType dim = 0; dim < ELEMENT_DIMENSIONS_COUNT; ++dim)
+				diagonal[dim] = block[dim][dim] * factors[dim][dim];
+
+			const Real diagonalSum = diagonal[0] + diagonal[1] + diagonal[2];
+			for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+				++dimFirst)
 			{
-				Real product = 0;
-				if (matrixBtD.sizeColumns() < rowsElastic &&
-					matrixDifferentiation.sizeRows() < rowsElastic)
-				{
-					std::string msg = messageOutOfRange();
-					ERROR(msg);
-				}
-
-				if (matrixBtD.sizeColumns() != matrixDifferentiation.sizeRows())
+				const UnsignedType rowNum =
+					nodeFirst * ELEMENT_DIMENSIONS_COUNT + dimFirst;
+				for (UnsignedType dimSecond = 0;
+					dimSecond < ELEMENT_DIMENSIONS_COUNT; ++dimSecond)
 				{
-					std::string msg =
-						"Matrix size mismatch : cols(A) != rows(B). ";
-					ERROR(msg);
+					const UnsignedType columnNum =
+						nodeSecond * ELEMENT_DIMENSIONS_COUNT + dimSecond;
+					Real value = 0.0;
+					if (dimFirst == dimSecond)
+					{
+						value = normal * diagonal[dimFirst] +
+							shear * (diagonalSum - diagonal[dimFirst]);
+					}
+					else
+					{
+						value = (lateral * block[dimFirst][dimSecond] +
+							shear * block[dimSecond][dimFirst]) *
+							factors[dimFirst][dimSecond];
+					}
+
+					result[rowNum][columnNum] = value;
+					result[columnNum][rowNum] = value;
 				}
-
-				for (UnsignedType indexMultip = 0; indexMultip < rowsElastic;
-					++indexMultip)
-				{
-					product += matrixBtD[rowNum][indexMultip] *
-						matrixDifferentiation[indexMultip][columnNum];
-				}
-				result[rowNum][columnNum] += product * detMatrixJacobian;
 			}
 		}
 	}
 
 	return result;
-}
\ No newline at end of file
+}
+
+// This function creates a matrix stiffness. The stiffness is linear in the
+// modulus of elasticity, so it is the stiffness for the modulus 1 multiplied
+// by the modulus (scaleMatrixStiffness, as the cached stiffness of
+// ElementMatrixCache is scaled).
+RealMatrix MFE::makeMatrixStiffness(const FiniteElement& finiteElement)
+{
+	return scaleMatrixStiffness(makeMatrixStiffnessPerModulus(finiteElement),
+		finiteElement.modulusElastic);
+}
+
+// The stiffness matrix for the modulus 1 multiplied by the modulus
+RealMatrix MFE::scaleMatrixStiffness(const RealMatrix& stiffnessPerModulus,
+	const Real& modulusElastic)
+{
+	const UnsignedType rows = stiffnessPerModulus.sizeRows();
+	const UnsignedType columns = stiffnessPerModulus.sizeColumns();
+	RealMatrix result(rows, columns);
+	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
+	{
+		for (UnsignedType columnNum = 0; columnNum < columns; ++columnNum)
+		{
+			result[rowNum][columnNum] =
+				modulusElastic * stiffnessPerModulus[rowNum][columnNum];
+		}
+	}
+	return result;
+}
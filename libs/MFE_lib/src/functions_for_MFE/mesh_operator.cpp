@@ -0,0 +1,265 @@
+#include <MFE_lib/functions_for_MFE/mesh_operator.h>
+#include <MFE_lib/functions_for_MFE/initial_conditions.h>
+
+#include <algorithm>
+
+#include "error_handling/error_handling.h"
+#include "parallel/element_tiles.h"
+#include "parallel/thread_pool.h"
+
+using namespace MFE;
+
+namespace
+{
+	// [degree of freedom of the element][lane]
+	using BatchValues = std::array<StiffnessLaneValues, ELEMENT_DOF_COUNT>;
+
+	// [direction][direction][lane]
+	using BatchTensor = std::array<std::array<StiffnessLaneValues,
+		ELEMENT_DIMENSIONS_COUNT>, ELEMENT_DIMENSIONS_COUNT>;
+}
+
+// The forces of the elements of the batch by the dense matrix of the element
+// (the same value of the matrix for all lanes)
+static void multiplyDense(const RealMatrix& stiffness,
+	const BatchValues& displacements, BatchValues& forces)
+{
+	for (UnsignedType rowNum = 0; rowNum < ELEMENT_DOF_COUNT; ++rowNum)
+	{
+		const RealVector& row = stiffness[rowNum];
+		for (UnsignedType columnNum = 0; columnNum < ELEMENT_DOF_COUNT;
+			++columnNum)
+		{
+			const Real value = row[columnNum];
+			for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+				forces[rowNum][lane] += value * displacements[columnNum][lane];
+		}
+	}
+}
+
+// The forces of the elements of the batch with the reduced integration
+// without the matrix: the gradient of the displacements at the center, the
+// stresses (multiplied by the volume) and the amplitudes of the hourglass
+// modes, the forces are B^T * sigma * V + k * gamma * q (the same as the
+// product by the matrix of makeMatrixStiffness)
+static void multiplyReduced(const ReducedElement& element,
+	const BatchValues& displacements, BatchValues& forces)
+{
+	BatchTensor gradient{};
+	std::array<std::array<StiffnessLaneValues, HOURGLASS_MODES_COUNT>,
+		ELEMENT_DIMENSIONS_COUNT> modes{};
+	for (UnsignedType node = 0; node < ELEMENT_NODES_COUNT; ++node)
+	{
+		for (UnsignedType direction = 0; direction < ELEMENT_DIMENSIONS_COUNT;
+			++direction)
+		{
+			const StiffnessLaneValues& values =
+				displacements[ELEMENT_DIMENSIONS_COUNT * node + direction];
+			for (UnsignedType dim = 0; dim < ELEMENT_DIMENSIONS_COUNT; ++dim)
+			{
+				const Real derivative = element.derivatives[node][dim];
+				for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+					gradient[direction][dim][lane] += derivative * values[lane];
+			}
+
+			for (UnsignedType mode = 0; mode < HOURGLASS_MODES_COUNT; ++mode)
+			{
+				const Real hourglass = element.hourglassVectors[mode][node];
+				for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+					modes[direction][mode][lane] += hourglass * values[lane];
+			}
+		}
+	}
+
+	BatchTensor stress;
+	for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+	{
+		const Real strainSum = gradient[0][0][lane] + gradient[1][1][lane] +
+			gradient[2][2][lane];
+		for (UnsignedType dimFirst = 0; dimFirst < ELEMENT_DIMENSIONS_COUNT;
+			++dimFirst)
+		{
+			for (UnsignedType dimSecond = 0; dimSecond < ELEMENT_DIMENSIONS_COUNT;
+				++dimSecond)
+			{
+				const Real strain = gradient[dimFirst][dimSecond][lane];
+				if (dimFirst == dimSecond)
+				{
+					stress[dimFirst][dimSecond][lane] = element.volume *
+						(element.normal * strain + element.lateral * (strainSum - strain));
+				}
+				else
+				{
+					stress[dimFirst][dimSecond][lane] = element.volume * element.shear *
+						(strain + gradient[dimSecond][dimFirst][lane]);
+				}
+			}
+		}
+	}
+
+	for (UnsignedType node = 0; node < ELEMENT_NODES_COUNT; ++node)
+	{
+		for (UnsignedType direction = 0; direction < ELEMENT_DIMENSIONS_COUNT;
+			++direction)
+		{
+			StiffnessLaneValues& values =
+				forces[ELEMENT_DIMENSIONS_COUNT * node + direction];
+			for (UnsignedType dim = 0; dim < ELEMENT_DIMENSIONS_COUNT; ++dim)
+			{
+				const Real derivative = element.derivatives[node][dim];
+				for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+					values[lane] += stress[direction][dim][lane] * derivative;
+			}
+
+			for (UnsignedType mode = 0; mode < HOURGLASS_MODES_COUNT; ++mode)
+			{
+				const Real hourglass =
+					element.hourglassStiffness * element.hourglassVectors[mode][node];
+				for (UnsignedType lane = 0; lane < STIFFNESS_LANES; ++lane)
+					values[lane] += hourglass * modes[direction][mode][lane];
+			}
+		}
+	}
+}
+
+MeshStiffnessOperator::MeshStiffnessOperator(const HexMesh& mesh,
+	const UnsignedType& threadsCount) :
+	m_mesh(mesh), m_threadPool(std::make_shared<ThreadPool>(threadsCount)),
+	m_tileRows((MESH_TILE_ELEMENTS + mesh.countX - 1) /
+		std::max<UnsignedType>(mesh.countX, 1)),
+	m_tileColors(makeTileColors(mesh.countY, mesh.countZ, m_tileRows)),
+	m_elementStiffness(ElementMatrixCache::getInstance().getStiffness(
+		mesh.finiteElement)),
+	m_diagonal(getMeshDofCount(mesh), 0.0),
+	m_isReduced(mesh.finiteElement.formulation == FORMULATION_REDUCED_INTEGRATION)
+{
+	// The constants of the element for the modulus of elasticity of the mesh
+	if (m_isReduced)
+	{
+		m_reducedElement = makeReducedElement(mesh.finiteElement);
+		const Real modulusElastic = mesh.finiteElement.modulusElastic;
+		m_reducedElement.normal *= modulusElastic;
+		m_reducedElement.lateral *= modulusElastic;
+		m_reducedElement.shear *= modulusElastic;
+		m_reducedElement.hourglassStiffness *= modulusElastic;
+	}
+
+	const RealMatrix& stiffness = *m_elementStiffness;
+	for (const auto& element : m_mesh.elements)
+	{
+		for (UnsignedType nodeLoc = 0; nodeLoc < ELEMENT_NODES_COUNT; ++nodeLoc)
+		{
+			for (UnsignedType direction = 0; direction < ELEMENT_DIMENSIONS_COUNT;
+				++direction)
+			{
+				const UnsignedType dofLoc =
+					ELEMENT_DIMENSIONS_COUNT * nodeLoc + direction;
+				m_diagonal[getMeshDof(element[nodeLoc], direction)] +=
+					stiffness[dofLoc][dofLoc];
+			}
+		}
+	}
+}
+
+UnsignedType MeshStiffnessOperator::sizeRows() const
+{
+	return m_diagonal.size();
+}
+
+void MeshStiffnessOperator::apply(const RealVector& vec,
+	RealVector& result) const
+{
+	if (vec.size() != m_diagonal.size())
+	{
+		std::string msg = "Vector size != matrix rows. ";
+		ERROR(msg);
+	}
+
+	result.assign(m_diagonal.size(), 0.0);
+	for (const auto& color : m_tileColors)
+	{
+		m_threadPool->run(color.size(), [&](const UnsignedType index)
+			{
+				applyTile(color[index], vec, result);
+			});
+	}
+
+	for (const auto& dof : m_penaltyDofs)
+		result[dof] += (STATIC_SIMMETRY - 1.0) * m_diagonal[dof] * vec[dof];
+}
+
+RealVector MeshStiffnessOperator::getDiagonal() const
+{
+	RealVector diagonal = m_diagonal;
+	for (const auto& dof : m_penaltyDofs)
+		diagonal[dof] *= STATIC_SIMMETRY;
+
+	return diagonal;
+}
+
+void MeshStiffnessOperator::boundConditionStatic()
+{
+	m_penaltyDofs = m_mesh.symmetryDofs;
+}
+
+// The elements of the tile are in a row in the mesh (along x, then y)
+void MeshStiffnessOperator::applyTile(const UnsignedType& tile,
+	const RealVector& vec, RealVector& result) const
+{
+	const ElementTile elementTile = getElementTile(tile, m_mesh.countY,
+		m_tileRows);
+	const UnsignedType layerFirst = elementTile.layer * m_mesh.countY;
+	const UnsignedType tileFirst =
+		(layerFirst + elementTile.firstRow) * m_mesh.countX;
+	const UnsignedType tileEnd = (layerFirst + elementTile.endRow) * m_mesh.countX;
+	BatchValues displacements;
+	BatchValues forces;
+	for (UnsignedType batchStart = tileFirst; batchStart < tileEnd;
+		batchStart += STIFFNESS_LANES)
+	{
+		const UnsignedType lanes = std::min(STIFFNESS_LANES, tileEnd - batchStart);
+		for (auto& values : displacements)
+			values.fill(0.0);
+		for (auto& values : forces)
+			values.fill(0.0);
+
+		for (UnsignedType lane = 0; lane < lanes; ++lane)
+		{
+			const ElementNodes& element = m_mesh.elements[batchStart + lane];
+			for (UnsignedType dofLoc = 0; dofLoc < ELEMENT_DOF_COUNT; ++dofLoc)
+			{
+				displacements[dofLoc][lane] = vec[getMeshDof(
+					element[dofLoc / ELEMENT_DIMENSIONS_COUNT],
+					dofLoc % ELEMENT_DIMENSIONS_COUNT)];
+			}
+		}
+
+		if (m_isReduced)
+			multiplyReduced(m_reducedElement, displacements, forces);
+		else
+			multiplyDense(*m_elementStiffness, displacements, forces);
+
+		// The elements of the batch have common nodes, they are added
+		// one after another
+		for (UnsignedType lane = 0; lane < lanes; ++lane)
+		{
+			const ElementNodes& element = m_mesh.elements[batchStart + lane];
+			for (UnsignedType dofLoc = 0; dofLoc < ELEMENT_DOF_COUNT; ++dofLoc)
+			{
+				result[getMeshDof(element[dofLoc / ELEMENT_DIMENSIONS_COUNT],
+					dofLoc % ELEMENT_DIMENSIONS_COUNT)] += forces[dofLoc][lane];
+			}
+		}
+	}
+}
+
+IterativeSolution MFE::calculateDispStaticMatrixFree(const HexMesh& mesh,
+	const Real& initialForce, const IterativeSolverOptions& options,
+	const UnsignedType& threadsCount)
+{
+	MeshStiffnessOperator matrixStiffness(mesh, threadsCount);
+	matrixStiffness.boundConditionStatic();
+
+	return solveConjugateGradient(matrixStiffness,
+		makeStaticForceMesh(mesh, initialForce), options);
+}
@@ -0,0 +1,252 @@
+#include <MFE_lib/functions_for_MFE/profiling.h>
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+namespace
+{
+	using ProfileClock = std::chrono::steady_clock;
+
+	// The profiling state of the thread: the report of the current run, the
+	// current section and the time of its start
+	struct ProfileState
+	{
+		RunProfile profile;
+		RunProfile lastProfile;
+		UnsignedType depth = 0;
+		ProfileSection section = PROFILE_OTHER;
+		ProfileClock::time_point sectionStart;
+	};
+
+	thread_local ProfileState profileState;
+}
+
+// Adding the time of the current section and switching to the section,
+// the previous section is returned
+static ProfileSection switchSection(const ProfileSection& section)
+{
+	const ProfileClock::time_point now = ProfileClock::now();
+	const ProfileSection previous = profileState.section;
+	if (profileState.depth != 0)
+	{
+		profileState.profile.sectionTime[previous] +=
+			std::chrono::duration<Real>(now - profileState.sectionStart).count();
+	}
+
+	profileState.section = section;
+	profileState.sectionStart = now;
+
+	return previous;
+}
+
+ProfileRun::ProfileRun(const std::string& name, const std::string& reportFile) :
+	m_isOuter(profileState.depth == 0), m_reportFile(reportFile)
+{
+	if (m_isOuter)
+	{
+		profileState.profile = RunProfile();
+		profileState.profile.name = name;
+		profileState.profile.isEnabled = true;
+		profileState.section = PROFILE_OTHER;
+		profileState.sectionStart = ProfileClock::now();
+		m_start = profileState.sectionStart;
+	}
+
+	++profileState.depth;
+}
+
+ProfileRun::~ProfileRun()
+{
+	if (!m_isOuter)
+	{
+		--profileState.depth;
+		return;
+	}
+
+	switchSection(PROFILE_OTHER);
+	--profileState.depth;
+
+	RunProfile& profile = profileState.profile;
+	profile.totalTime =
+		std::chrono::duration<Real>(ProfileClock::now() - m_start).count();
+	profileState.lastProfile = profile;
+
+	if (!m_reportFile.empty())
+		writeProfileJson(profile, m_reportFile);
+}
+
+ProfileTimer::ProfileTimer(const ProfileSection& section)
+{
+	m_previous = switchSection(section);
+	++profileState.profile.sectionCalls[section];
+}
+
+ProfileTimer::~ProfileTimer()
+{
+	switchSection(m_previous);
+}
+
+void ProfileTimer::next(const ProfileSection& section)
+{
+	switchSection(section);
+	++profileState.profile.sectionCalls[section];
+}
+
+void MFE::addProfileCount(const ProfileCounter& counter,
+	const UnsignedType& value)
+{
+	profileState.profile.counters[counter] += value;
+}
+
+bool MFE::isProfilingEnabled()
+{
+#ifdef MFE_LIB_ENABLE_PROFILING
+	return true;
+#else
+	return false;
+#endif
+}
+
+RunProfile MFE::getLastRunProfile()
+{
+	return profileState.lastProfile;
+}
+
+std::string MFE::getSectionName(const ProfileSection& section)
+{
+	switch (section)
+	{
+	case PROFILE_OTHER:
+		return "other";
+	case PROFILE_ASSEMBLY:
+		return "assembly";
+	case PROFILE_CONDITIONS:
+		return "conditions";
+	case PROFILE_FORCE:
+		return "force";
+	case PROFILE_SOLVE:
+		return "solve";
+	case PROFILE_UPDATE:
+		return "update";
+	case PROFILE_OUTPUT:
+		return "output";
+	default:
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+	}
+
+	return "";
+}
+
+std::string MFE::getCounterName(const ProfileCounter& counter)
+{
+	switch (counter)
+	{
+	case PROFILE_STEPS:
+		return "steps";
+	case PROFILE_STUCK_STEPS:
+		return "stuckSteps";
+	case PROFILE_SLIDING_STEPS:
+		return "slidingSteps";
+	case PROFILE_LINEAR_SOLVES:
+		return "linearSolves";
+	case PROFILE_SOLVER_ITERATIONS:
+		return "solverIterations";
+	default:
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+	}
+
+	return "";
+}
+
+// The name is written as a JSON string
+static std::string quoteJson(const std::string& text)
+{
+	std::string quoted = "\"";
+	for (const auto& symbol : text)
+	{
+		if (symbol == '"' || symbol == '\\')
+			quoted += '\\';
+
+		if (static_cast<unsigned char>(symbol) < 0x20)
+			quoted += ' ';
+		else
+			quoted += symbol;
+	}
+	quoted += '"';
+
+	return quoted;
+}
+
+std::string MFE::formatProfileJson(const RunProfile& profile)
+{
+	std::ostringstream output;
+	output.precision(std::numeric_limits<Real>::max_digits10);
+
+	output << "{\n"
+		<< "\t\"name\": " << quoteJson(profile.name) << ",\n"
+		<< "\t\"enabled\": " << (profile.isEnabled ? "true" : "false") << ",\n"
+		<< "\t\"totalSeconds\": " << profile.totalTime << ",\n"
+		<< "\t\"sections\": {\n";
+
+	for (UnsignedType sectionNum = 0; sectionNum < PROFILE_SECTIONS_COUNT;
+		++sectionNum)
+	{
+		const ProfileSection section = static_cast<ProfileSection>(sectionNum);
+		output << "\t\t" << quoteJson(getSectionName(section))
+			<< ": { \"seconds\": " << profile.sectionTime[section]
+			<< ", \"calls\": " << profile.sectionCalls[section] << " }"
+			<< (sectionNum + 1 < PROFILE_SECTIONS_COUNT ? ",\n" : "\n");
+	}
+
+	output << "\t},\n"
+		<< "\t\"counters\": {\n";
+
+	for (UnsignedType counterNum = 0; counterNum < PROFILE_COUNTERS_COUNT;
+		++counterNum)
+	{
+		const ProfileCounter counter = static_cast<ProfileCounter>(counterNum);
+		output << "\t\t" << quoteJson(getCounterName(counter)) << ": "
+			<< profile.counters[counter]
+			<< (counterNum + 1 < PROFILE_COUNTERS_COUNT ? ",\n" : "\n");
+	}
+
+	output << "\t}\n"
+		<< "}\n";
+
+	return output.str();
+}
+
+bool MFE::writeProfileJson(const RunProfile& profile,
+	const std::string& fileName)
+{
+	std::ofstream fout(fileName);
+	if (!fout.is_open())
+	{
+		std::string msg = "The file \"" + fileName + "\" was not opened. ";
+		WARNING(msg);
+		return false;
+	}
+
+	fout << formatProfileJson(profile);
+
+	fout.close();
+	if (fout.fail())
+	{
+		std::string msg = "The report of the profiling is not recorded. ";
+		WARNING(msg);
+		return false;
+	}
+
+	return true;
+}
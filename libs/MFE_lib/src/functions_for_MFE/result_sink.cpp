@@ -0,0 +1,290 @@
+#include <MFE_lib/functions_for_MFE/result_sink.h>
+
+#include <algorithm>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+void MemorySink::begin(const SinkHeader& header)
+{
+	m_header = header;
+	m_displacements = RealMatrix(std::max<UnsignedType>(header.stepsCount, 1),
+		header.dofCount);
+	m_steps.clear();
+	m_steps.reserve(header.stepsCount);
+}
+
+void MemorySink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool&)
+{
+	const UnsignedType rowNum = m_steps.size();
+	// The number of steps may be more than expected
+	if (rowNum == m_displacements.sizeRows())
+		m_displacements.resizeRows(2 * rowNum);
+
+	m_displacements[rowNum] = displacement;
+	m_steps.push_back(step);
+}
+
+void MemorySink::end()
+{
+	if (m_steps.empty())
+		m_displacements = RealMatrix(0, 0);
+	else
+		m_displacements.resizeRows(m_steps.size());
+}
+
+const RealMatrix& MemorySink::getDisplacements() const
+{
+	return m_displacements;
+}
+
+const std::vector<UnsignedType>& MemorySink::getSteps() const
+{
+	return m_steps;
+}
+
+const SinkHeader& MemorySink::getHeader() const
+{
+	return m_header;
+}
+
+TextFileSink::TextFileSink(const std::string& fileName,
+	const std::vector<UnsignedType>& indices) :
+	m_fileName(fileName), m_indices(indices)
+{
+	if (m_indices.empty())
+	{
+		std::string msg = "The indices of the text file are not set. ";
+		ERROR(msg);
+	}
+}
+
+// Checking that the degrees of freedom are in the displacement vector
+static void checkIndices(const std::vector<UnsignedType>& indices,
+	const UnsignedType& dofCount)
+{
+	const UnsignedType lastIndex =
+		*std::max_element(indices.begin(), indices.end());
+	if (lastIndex >= dofCount)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+}
+
+void TextFileSink::begin(const SinkHeader& header)
+{
+	checkIndices(m_indices, header.dofCount);
+
+	m_writer = std::make_unique<TextWriter>(m_fileName, TEXT_PRECISION_STREAM);
+	m_isWritten = m_writer->isOpen();
+	if (!m_isWritten)
+	{
+		std::string msg = "The file \"" + m_fileName + "\" was not opened. ";
+		WARNING(msg);
+	}
+}
+
+void TextFileSink::record(const UnsignedType&,
+	const RealVector& displacement, const bool&)
+{
+	if (!m_isWritten)
+		return;
+
+	if (m_indices.size() == 1)
+	{
+		m_writer->writeValue(displacement[m_indices.front()]);
+		m_writer->writeChar('\n');
+		return;
+	}
+
+	const UnsignedType size = m_indices.size();
+	for (UnsignedType indexNum = 0; indexNum < size; ++indexNum)
+	{
+		const UnsignedType& index = m_indices[indexNum];
+		m_writer->writeValue(index);
+		m_writer->writeText(": ");
+		m_writer->writeValue(displacement[index]);
+		if (indexNum + 1 == size)
+			m_writer->writeChar('\n');
+		else
+			m_writer->writeText("  ");
+	}
+}
+
+void TextFileSink::end()
+{
+	if (m_writer == nullptr)
+		return;
+
+	if (m_writer->isOpen() && !m_writer->close())
+	{
+		std::string msg = "The displacements are not recorded. ";
+		WARNING(msg);
+		m_isWritten = false;
+	}
+	m_writer.reset();
+}
+
+bool TextFileSink::isWritten() const
+{
+	return m_isWritten;
+}
+
+ChannelsFileSink::ChannelsFileSink(const std::string& fileName,
+	const std::vector<UnsignedType>& indices, const TextLayout& layout) :
+	m_fileName(fileName), m_indices(indices), m_layout(layout)
+{
+	if (m_indices.empty())
+	{
+		std::string msg = "The indices of the text file are not set. ";
+		ERROR(msg);
+	}
+}
+
+void ChannelsFileSink::begin(const SinkHeader& header)
+{
+	checkIndices(m_indices, header.dofCount);
+
+	m_deltaT = header.deltaT;
+	m_writer = std::make_unique<ChannelsWriter>(m_fileName, m_indices,
+		m_layout);
+	m_isWritten = m_writer->isOpen();
+	if (!m_isWritten)
+	{
+		std::string msg = "The file \"" + m_fileName + "\" was not opened. ";
+		WARNING(msg);
+	}
+}
+
+void ChannelsFileSink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool&)
+{
+	if (m_isWritten)
+		m_writer->writeRow(m_deltaT * static_cast<Real>(step), displacement);
+}
+
+void ChannelsFileSink::end()
+{
+	if (m_writer == nullptr)
+		return;
+
+	if (m_writer->isOpen() && !m_writer->close())
+	{
+		std::string msg = "The displacements are not recorded. ";
+		WARNING(msg);
+		m_isWritten = false;
+	}
+	m_writer.reset();
+}
+
+bool ChannelsFileSink::isWritten() const
+{
+	return m_isWritten;
+}
+
+SplitSink::SplitSink(const std::vector<ResultSink*>& sinks) :
+	m_sinks(sinks)
+{
+	for (const auto& sink : m_sinks)
+	{
+		if (sink == nullptr)
+		{
+			std::string msg = "The sink is not set. ";
+			ERROR(msg);
+		}
+	}
+}
+
+void SplitSink::begin(const SinkHeader& header)
+{
+	for (auto& sink : m_sinks)
+		sink->begin(header);
+}
+
+void SplitSink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool& isStuck)
+{
+	for (auto& sink : m_sinks)
+		sink->record(step, displacement, isStuck);
+}
+
+void SplitSink::end()
+{
+	for (auto& sink : m_sinks)
+		sink->end();
+}
+
+StrideSelection::StrideSelection(const UnsignedType& stride) :
+	m_stride(stride)
+{
+	if (m_stride == 0)
+	{
+		std::string msg = "The stride of the decimation is 0. ";
+		ERROR(msg);
+	}
+}
+
+void StrideSelection::begin(const UnsignedType& firstStep)
+{
+	m_firstStep = firstStep;
+	m_hasLast = false;
+}
+
+bool StrideSelection::select(const UnsignedType& step)
+{
+	m_hasLast = (step - m_firstStep) % m_stride != 0;
+	return !m_hasLast;
+}
+
+bool StrideSelection::hasLast() const
+{
+	return m_hasLast;
+}
+
+UnsignedType StrideSelection::getSelectedCount(
+	const UnsignedType& stepsCount) const
+{
+	UnsignedType count = (stepsCount + m_stride - 1) / m_stride;
+	if (stepsCount != 0 && (stepsCount - 1) % m_stride != 0)
+		++count;
+
+	return count;
+}
+
+DecimatingSink::DecimatingSink(ResultSink& target, const UnsignedType& stride) :
+	m_target(target), m_selection(stride) {}
+
+void DecimatingSink::begin(const SinkHeader& header)
+{
+	m_selection.begin(header.firstStep);
+
+	SinkHeader headerTarget = header;
+	headerTarget.stepsCount = m_selection.getSelectedCount(header.stepsCount);
+
+	m_target.begin(headerTarget);
+}
+
+void DecimatingSink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool& isStuck)
+{
+	if (m_selection.select(step))
+	{
+		m_target.record(step, displacement, isStuck);
+		return;
+	}
+
+	m_lastStep = step;
+	m_lastDisplacement = displacement;
+	m_isLastStuck = isStuck;
+}
+
+void DecimatingSink::end()
+{
+	if (m_selection.hasLast())
+		m_target.record(m_lastStep, m_lastDisplacement, m_isLastStuck);
+
+	m_target.end();
+}
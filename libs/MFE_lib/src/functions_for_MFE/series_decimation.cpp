@@ -0,0 +1,343 @@
+#include <MFE_lib/functions_for_MFE/series_decimation.h>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+SeriesDecimator::SeriesDecimator(const DecimationPolicy& policy,
+	const UnsignedType& pointsCount) :
+	m_policy(policy), m_pointsCount(pointsCount)
+{
+	// M4 keeps 4 points of a bucket, LTTB keeps the first and the last points
+	if (m_policy != DECIMATION_ALL && m_pointsCount < 4)
+	{
+		std::string msg = "The number of points of the series is less than 4. ";
+		ERROR(msg);
+	}
+}
+
+void SeriesDecimator::begin(const UnsignedType& stepsCount, const Real& deltaT,
+	const UnsignedType& firstStep)
+{
+	m_series = PlotSeries();
+	m_deltaT = deltaT;
+	m_stepsCount = stepsCount;
+	m_firstStep = firstStep;
+	m_isAll = m_policy == DECIMATION_ALL || stepsCount <= m_pointsCount;
+
+	m_isBucketEmpty = true;
+	m_hasSelected = false;
+	m_bucketPrevious.clear();
+	m_bucketCurrent.clear();
+
+	if (m_isAll)
+	{
+		m_series.time.reserve(stepsCount);
+		m_series.values.reserve(stepsCount);
+		return;
+	}
+
+	m_series.time.reserve(m_pointsCount + 1);
+	m_series.values.reserve(m_pointsCount + 1);
+
+	switch (m_policy)
+	{
+	case DECIMATION_STRIDE:
+		m_selection = StrideSelection(
+			(stepsCount + m_pointsCount - 1) / m_pointsCount);
+		m_selection.begin(firstStep);
+		break;
+	case DECIMATION_M4:
+		m_bucketsCount = m_pointsCount / 4;
+		break;
+	case DECIMATION_LTTB:
+		m_bucketsCount = m_pointsCount - 2;
+		break;
+	default:
+		break;
+	}
+}
+
+void SeriesDecimator::add(const UnsignedType& step, const Real& value)
+{
+	Point point;
+	point.step = step;
+	point.value = value;
+
+	if (m_isAll)
+	{
+		addPoint(point);
+		return;
+	}
+
+	switch (m_policy)
+	{
+	case DECIMATION_STRIDE:
+		addStride(point);
+		break;
+	case DECIMATION_M4:
+		addM4(point);
+		break;
+	case DECIMATION_LTTB:
+		addLTTB(point);
+		break;
+	default:
+		addPoint(point);
+		break;
+	}
+}
+
+void SeriesDecimator::end()
+{
+	if (m_isAll)
+		return;
+
+	switch (m_policy)
+	{
+	case DECIMATION_STRIDE:
+		if (m_selection.hasLast())
+			addPoint(m_last);
+		break;
+	case DECIMATION_M4:
+		if (!m_isBucketEmpty)
+			flushM4();
+		break;
+	case DECIMATION_LTTB:
+	{
+		if (m_bucketCurrent.empty())
+			break;
+
+		// The last step is always in the series, the remaining buckets
+		// are closed by it
+		const Point last = m_bucketCurrent.back();
+		m_bucketCurrent.pop_back();
+
+		if (!m_bucketPrevious.empty())
+		{
+			if (m_bucketCurrent.empty())
+			{
+				selectLTTB(m_bucketPrevious, static_cast<Real>(last.step),
+					last.value);
+			}
+			else
+			{
+				Real stepNext = 0.0;
+				Real valueNext = 0.0;
+				for (const auto& point : m_bucketCurrent)
+				{
+					stepNext += static_cast<Real>(point.step);
+					valueNext += point.value;
+				}
+				const Real size = static_cast<Real>(m_bucketCurrent.size());
+				selectLTTB(m_bucketPrevious, stepNext / size, valueNext / size);
+			}
+		}
+
+		if (!m_bucketCurrent.empty())
+			selectLTTB(m_bucketCurrent, static_cast<Real>(last.step), last.value);
+
+		addPoint(last);
+		m_bucketPrevious.clear();
+		m_bucketCurrent.clear();
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+const PlotSeries& SeriesDecimator::getSeries() const
+{
+	return m_series;
+}
+
+void SeriesDecimator::addPoint(const Point& point)
+{
+	m_series.time.push_back(m_deltaT * static_cast<Real>(point.step));
+	m_series.values.push_back(point.value);
+}
+
+// The bucket of the step. M4 divides all steps into buckets, LTTB divides
+// the steps between the first and the last. The steps beyond the expected
+// number are in the last bucket.
+UnsignedType SeriesDecimator::getBucket(const UnsignedType& step) const
+{
+	const UnsignedType stepNum = step - m_firstStep;
+	UnsignedType bucket = 0;
+	if (m_policy == DECIMATION_LTTB)
+	{
+		const UnsignedType stepsInner = m_stepsCount - 2;
+		if (stepNum != 0)
+			bucket = (stepNum - 1) * m_bucketsCount / stepsInner;
+	}
+	else
+		bucket = stepNum * m_bucketsCount / m_stepsCount;
+
+	return std::min(bucket, m_bucketsCount - 1);
+}
+
+void SeriesDecimator::addStride(const Point& point)
+{
+	if (m_selection.select(point.step))
+		addPoint(point);
+	else
+		m_last = point;
+}
+
+void SeriesDecimator::addM4(const Point& point)
+{
+	const UnsignedType bucket = getBucket(point.step);
+	if (!m_isBucketEmpty && bucket != m_bucket)
+		flushM4();
+
+	if (m_isBucketEmpty)
+	{
+		m_bucket = bucket;
+		m_isBucketEmpty = false;
+		m_first = point;
+		m_min = point;
+		m_max = point;
+		m_last = point;
+		return;
+	}
+
+	if (point.value < m_min.value)
+		m_min = point;
+	if (point.value > m_max.value)
+		m_max = point;
+	m_last = point;
+}
+
+// The points of the bucket in the order of the steps, without repetitions
+void SeriesDecimator::flushM4()
+{
+	std::array<Point, 4> points = { m_first, m_min, m_max, m_last };
+	std::sort(points.begin(), points.end(),
+		[](const Point& left, const Point& right)
+		{
+			return left.step < right.step;
+		});
+
+	for (UnsignedType pointNum = 0; pointNum < points.size(); ++pointNum)
+	{
+		if (pointNum == 0 || points[pointNum].step != points[pointNum - 1].step)
+			addPoint(points[pointNum]);
+	}
+
+	m_isBucketEmpty = true;
+}
+
+void SeriesDecimator::addLTTB(const Point& point)
+{
+	// The first step is always in the series
+	if (!m_hasSelected)
+	{
+		addPoint(point);
+		m_selected = point;
+		m_hasSelected = true;
+		return;
+	}
+
+	const UnsignedType bucket = getBucket(point.step);
+	if (!m_bucketCurrent.empty() && bucket != m_bucketCurrentNum)
+	{
+		// The current bucket is filled: its average is the third vertex of
+		// the triangles of the previous bucket
+		if (!m_bucketPrevious.empty())
+		{
+			Real stepNext = 0.0;
+			Real valueNext = 0.0;
+			for (const auto& pointCurrent : m_bucketCurrent)
+			{
+				stepNext += static_cast<Real>(pointCurrent.step);
+				valueNext += pointCurrent.value;
+			}
+			const Real size = static_cast<Real>(m_bucketCurrent.size());
+			selectLTTB(m_bucketPrevious, stepNext / size, valueNext / size);
+		}
+
+		// The memory of the buckets is reused
+		std::swap(m_bucketPrevious, m_bucketCurrent);
+		m_bucketCurrent.clear();
+	}
+
+	m_bucketCurrent.push_back(point);
+	m_bucketCurrentNum = bucket;
+}
+
+// The point of the bucket with the largest triangle formed with the
+// previous selected point and the point (stepNext, valueNext)
+void SeriesDecimator::selectLTTB(const std::vector<Point>& bucket,
+	const Real& stepNext, const Real& valueNext)
+{
+	const Real stepSelected = static_cast<Real>(m_selected.step);
+	const Real valueSelected = m_selected.value;
+
+	Real areaMax = -1.0;
+	Point pointMax;
+	for (const auto& point : bucket)
+	{
+		const Real area = abs((stepSelected - stepNext) *
+			(point.value - valueSelected) -
+			(stepSelected - static_cast<Real>(point.step)) *
+			(valueNext - valueSelected));
+		if (area > areaMax)
+		{
+			areaMax = area;
+			pointMax = point;
+		}
+	}
+
+	addPoint(pointMax);
+	m_selected = pointMax;
+}
+
+SeriesSink::SeriesSink(const DecimationPolicy& policy,
+	const UnsignedType& pointsCount, const UnsignedType& index) :
+	m_decimator(policy, pointsCount), m_index(index) {}
+
+void SeriesSink::begin(const SinkHeader& header)
+{
+	if (m_index >= header.dofCount)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	m_decimator.begin(header.stepsCount, header.deltaT, header.firstStep);
+}
+
+void SeriesSink::record(const UnsignedType& step,
+	const RealVector& displacement, const bool&)
+{
+	m_decimator.add(step, displacement[m_index]);
+}
+
+void SeriesSink::end()
+{
+	m_decimator.end();
+}
+
+const PlotSeries& SeriesSink::getSeries() const
+{
+	return m_decimator.getSeries();
+}
+
+PlotSeries MFE::decimateSeries(const RealVector& values, const Real& deltaT,
+	const DecimationPolicy& policy, const UnsignedType& pointsCount)
+{
+	SeriesDecimator decimator(policy, pointsCount);
+	decimator.begin(values.size(), deltaT);
+
+	const UnsignedType size = values.size();
+	for (UnsignedType step = 0; step < size; ++step)
+		decimator.add(step, values[step]);
+
+	decimator.end();
+
+	return decimator.getSeries();
+}
@@ -0,0 +1,558 @@
+#include <MFE_lib/functions_for_MFE/simulation_config.h>
+
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#include "error_handling/error_handling.h"
+#include "inputFunctions/inputFunctions.h"
+
+using namespace MFE;
+
+namespace
+{
+	// The key of the scenario file with the line number
+	struct ScenarioValue
+	{
+		std::string key;
+		std::string value;
+		UnsignedType lineNum = 0;
+	};
+}
+
+static std::string messageScenarioLine(const UnsignedType& lineNum)
+{
+	return "Scenario file, line " + std::to_string(lineNum) + ": ";
+}
+
+// Removing spaces at the beginning and at the end of the line
+static std::string trimLine(const std::string& line)
+{
+	const std::string spaces = " \t\r\n";
+	const std::size_t first = line.find_first_not_of(spaces);
+	if (first == std::string::npos)
+		return "";
+
+	const std::size_t last = line.find_last_not_of(spaces);
+	return line.substr(first, last - first + 1);
+}
+
+static Real parseReal(const ScenarioValue& scenarioValue)
+{
+	std::size_t pos = 0;
+	Real value = 0.0;
+	try
+	{
+		value = std::stod(scenarioValue.value, &pos);
+	}
+	catch (...)
+	{
+		pos = 0;
+	}
+
+	if (pos == 0 || pos != scenarioValue.value.size())
+	{
+		std::string msg = messageScenarioLine(scenarioValue.lineNum) +
+			"the value of \"" + scenarioValue.key + "\" is not a number. ";
+		ERROR(msg);
+	}
+
+	return value;
+}
+
+static UnsignedType parseUnsigned(const ScenarioValue& scenarioValue)
+{
+	const Real value = parseReal(scenarioValue);
+	if (value < 0.0 || value != floor(value) ||
+		value >= static_cast<Real>(std::numeric_limits<UnsignedType>::max()))
+	{
+		std::string msg = messageScenarioLine(scenarioValue.lineNum) +
+			"the value of \"" + scenarioValue.key + "\" is not a number of steps. ";
+		ERROR(msg);
+	}
+
+	return static_cast<UnsignedType>(value);
+}
+
+static FrictionMode parseFrictionMode(const ScenarioValue& scenarioValue)
+{
+	const Real value = parseReal(scenarioValue);
+	bool isModeCorrect = value == FRICTION_DRY_FREE ||
+		value == FRICTION_DRY_DRIVE || value == FRICTION_VISCOUS_DRIVE;
+	if (!isModeCorrect)
+	{
+		std::string msg = messageScenarioLine(scenarioValue.lineNum) +
+			"the friction mode must be 1, 2 or 3. ";
+		ERROR(msg);
+	}
+
+	return static_cast<FrictionMode>(static_cast<int>(value));
+}
+
+static IntegrationScheme parseIntegrationScheme(const ScenarioValue& scenarioValue)
+{
+	if (scenarioValue.value == "newmark")
+		return INTEGRATION_NEWMARK;
+	if (scenarioValue.value == "hht_alpha")
+		return INTEGRATION_HHT_ALPHA;
+	if (scenarioValue.value == "generalized_alpha")
+		return INTEGRATION_GENERALIZED_ALPHA;
+
+	std::string msg = messageScenarioLine(scenarioValue.lineNum) +
+		"unknown integration scheme \"" + scenarioValue.value + "\". ";
+	ERROR(msg);
+
+	return INTEGRATION_NEWMARK;
+}
+
+static ElementFormulation parseElementFormulation(
+	const ScenarioValue& scenarioValue)
+{
+	if (scenarioValue.value == "full")
+		return FORMULATION_FULL_INTEGRATION;
+	if (scenarioValue.value == "reduced")
+		return FORMULATION_REDUCED_INTEGRATION;
+
+	std::string msg = messageScenarioLine(scenarioValue.lineNum) +
+		"unknown element formulation \"" + scenarioValue.value + "\". ";
+	ERROR(msg);
+
+	return FORMULATION_FULL_INTEGRATION;
+}
+
+// Setting the value of the scenario to the field of the configuration
+static void setScenarioValue(const ScenarioValue& scenarioValue,
+	SimulationConfig& config)
+{
+	const std::string& key = scenarioValue.key;
+	FiniteElement& finiteElement = config.finiteElement;
+
+	if (key == "frictionMode")
+		config.frictionMode = parseFrictionMode(scenarioValue);
+	else if (key == "integrationScheme")
+		config.integrationScheme = parseIntegrationScheme(scenarioValue);
+	else if (key == "outputFile")
+		config.outputFile = scenarioValue.value;
+	else if (key == "checkpointFile")
+		config.checkpointFile = scenarioValue.value;
+	else if (key == "checkpointInterval")
+		config.checkpointInterval = parseUnsigned(scenarioValue);
+	else if (key == "restartFile")
+		config.restartFile = scenarioValue.value;
+	else if (key == "profileFile")
+		config.profileFile = scenarioValue.value;
+	else if (key == "time")
+		config.time = parseReal(scenarioValue);
+	else if (key == "deltaT")
+		config.deltaT = parseReal(scenarioValue);
+	else if (key == "initialStaticLoad")
+		config.initialStaticLoad = parseReal(scenarioValue);
+	else if (key == "initialAcceleration")
+		config.initialAcceleration = parseReal(scenarioValue);
+	else if (key == "initialSpeed")
+		config.initialSpeed = parseReal(scenarioValue);
+	else if (key == "coeffDryFrictionRest")
+		config.coeffDryFrictionRest = parseReal(scenarioValue);
+	else if (key == "coeffDryFrictionSliding")
+		config.coeffDryFrictionSliding = parseReal(scenarioValue);
+	else if (key == "coeffViscousFriction")
+		config.coeffViscousFriction = parseReal(scenarioValue);
+	else if (key == "normalReaction")
+		config.normalReaction = parseReal(scenarioValue);
+	else if (key == "frequencyCoeff")
+		config.frequencyCoeff = parseReal(scenarioValue);
+	else if (key == "amplitudeForce")
+		config.amplitudeForce = parseReal(scenarioValue);
+	else if (key == "spectralRadius")
+		config.spectralRadius = parseReal(scenarioValue);
+	else if (key == "modulusElastic")
+		finiteElement.modulusElastic = parseReal(scenarioValue);
+	else if (key == "poissonRatio")
+		finiteElement.poissonRatio = parseReal(scenarioValue);
+	else if (key == "dencity")
+		finiteElement.dencity = parseReal(scenarioValue);
+	else if (key == "length")
+		finiteElement.length = parseReal(scenarioValue);
+	else if (key == "width")
+		finiteElement.width = parseReal(scenarioValue);
+	else if (key == "heigth")
+		finiteElement.heigth = parseReal(scenarioValue);
+	else if (key == "elementFormulation")
+		finiteElement.formulation = parseElementFormulation(scenarioValue);
+	else if (key == "hourglassCoefficient")
+		finiteElement.hourglassCoefficient = parseReal(scenarioValue);
+	else
+	{
+		std::string msg = messageScenarioLine(scenarioValue.lineNum) +
+			"unknown key \"" + key + "\". ";
+		ERROR(msg);
+	}
+}
+
+// The configuration of the scenario: the defaults of the friction mode,
+// then the values of the file
+static SimulationConfig makeScenarioConfig(const std::string& name,
+	const std::vector<ScenarioValue>& scenarioValues)
+{
+	FrictionMode frictionMode = FRICTION_DRY_FREE;
+	for (const auto& scenarioValue : scenarioValues)
+	{
+		if (scenarioValue.key == "frictionMode")
+			frictionMode = parseFrictionMode(scenarioValue);
+	}
+
+	SimulationConfig config = makeDefaultConfig(frictionMode);
+	config.name = name;
+	for (const auto& scenarioValue : scenarioValues)
+		setScenarioValue(scenarioValue, config);
+
+	return config;
+}
+
+// The configuration with the default values for the friction mode
+SimulationConfig MFE::makeDefaultConfig(const FrictionMode& frictionMode)
+{
+	SimulationConfig config;
+	config.frictionMode = frictionMode;
+	switch (frictionMode)
+	{
+	case FRICTION_DRY_FREE:
+	{
+		config.normalReaction = NORMAL_REACTION_FREE;
+		break;
+	}
+	case FRICTION_DRY_DRIVE:
+	{
+		config.normalReaction = NORMAL_REACTION_DRIVE;
+		config.frequencyCoeff = FREQUENCY_COEFF_DRY;
+		config.amplitudeForce = AMPLITUDE_FORCE_DRY;
+		break;
+	}
+	case FRICTION_VISCOUS_DRIVE:
+	{
+		config.frequencyCoeff = FREQUENCY_COEFF_VISCOUS;
+		config.amplitudeForce = AMPLITUDE_FORCE_VISCOUS;
+		break;
+	}
+	default:
+	{
+		std::string msg = "Unknown friction mode. ";
+		ERROR(msg);
+	}
+	}
+
+	return config;
+}
+
+// Checking the configuration
+void MFE::validateConfig(const SimulationConfig& config)
+{
+	const std::string prefix = "Scenario \"" + config.name + "\": ";
+	const FiniteElement& finiteElement = config.finiteElement;
+
+	// NaN does not fail the comparisons, so all values are checked first
+	const std::array values{ config.time, config.deltaT,
+		config.initialStaticLoad, config.initialAcceleration, config.initialSpeed,
+		config.coeffDryFrictionRest, config.coeffDryFrictionSliding,
+		config.coeffViscousFriction, config.normalReaction, config.frequencyCoeff,
+		config.amplitudeForce, config.spectralRadius, finiteElement.modulusElastic,
+		finiteElement.poissonRatio, finiteElement.dencity, finiteElement.length,
+		finiteElement.width, finiteElement.heigth,
+		finiteElement.hourglassCoefficient };
+	for (const auto& value : values)
+	{
+		if (!std::isfinite(value))
+		{
+			std::string msg = prefix + "the values must be finite numbers. ";
+			ERROR(msg);
+		}
+	}
+
+	if (!(config.deltaT > DBL_EPSILON))
+	{
+		std::string msg = prefix + "the time step must be positive. ";
+		ERROR(msg);
+	}
+
+	if (!(config.time >= config.deltaT))
+	{
+		std::string msg = prefix + "the time must be at least the time step. ";
+		ERROR(msg);
+	}
+
+	bool isModeCorrect = config.frictionMode == FRICTION_DRY_FREE ||
+		config.frictionMode == FRICTION_DRY_DRIVE ||
+		config.frictionMode == FRICTION_VISCOUS_DRIVE;
+	if (!isModeCorrect)
+	{
+		std::string msg = prefix + "the friction mode must be 1, 2 or 3. ";
+		ERROR(msg);
+	}
+
+	bool isCoeffsCorrect = config.coeffDryFrictionRest >= 0.0 &&
+		config.coeffDryFrictionSliding >= 0.0 &&
+		config.coeffViscousFriction >= 0.0 && config.normalReaction >= 0.0;
+	if (!isCoeffsCorrect)
+	{
+		std::string msg = prefix + "the coefficients of friction and the "
+			"normal reaction must not be negative. ";
+		ERROR(msg);
+	}
+
+	bool isElementCorrect = finiteElement.modulusElastic > 0.0 &&
+		finiteElement.poissonRatio > DBL_EPSILON &&
+		finiteElement.poissonRatio < LIM_POISSONS_RATIO &&
+		finiteElement.dencity >= MIN_DENCITY &&
+		finiteElement.dencity <= MAX_DENCITY &&
+		finiteElement.length >= MIN_SIZE_FINITE_ELEMENT &&
+		finiteElement.width >= MIN_SIZE_FINITE_ELEMENT &&
+		finiteElement.heigth >= MIN_SIZE_FINITE_ELEMENT &&
+		(finiteElement.formulation == FORMULATION_FULL_INTEGRATION ||
+		finiteElement.formulation == FORMULATION_REDUCED_INTEGRATION) &&
+		finiteElement.hourglassCoefficient >= 0.0;
+	if (!isElementCorrect)
+	{
+		std::string msg = prefix + "invalid properties of the finite element. ";
+		ERROR(msg);
+	}
+
+	if (config.checkpointInterval != 0 && config.checkpointFile.empty())
+	{
+		std::string msg = prefix + "the interval of the checkpoints is set "
+			"without the checkpoint file. ";
+		ERROR(msg);
+	}
+
+	// The parameters of the integrator are checked by the integrator itself
+	getIntegratorParameters(config);
+}
+
+// The frequency of the driving force
+Real MFE::getFrequencyForce(const SimulationConfig& config)
+{
+	return config.frequencyCoeff * PI;
+}
+
+// The parameters of the time integrator
+IntegratorParameters MFE::getIntegratorParameters(const SimulationConfig& config)
+{
+	return makeIntegratorParameters(config.integrationScheme,
+		config.spectralRadius);
+}
+
+// Reading the scenarios from the file
+std::vector<SimulationConfig> MFE::readScenarioFile(const std::string& fileName)
+{
+	std::ifstream fin(fileName);
+	if (!fin.is_open())
+	{
+		std::string msg = "The scenario file \"" + fileName + "\" was not opened. ";
+		ERROR(msg);
+	}
+
+	return readScenarios(fin);
+}
+
+// Reading the scenarios from the stream
+std::vector<SimulationConfig> MFE::readScenarios(std::istream& input)
+{
+	std::vector<SimulationConfig> configs;
+	std::vector<ScenarioValue> scenarioValues;
+	std::string name = "";
+	bool hasScenario = false;
+
+	std::string line = "";
+	UnsignedType lineNum = 0;
+	while (std::getline(input, line))
+	{
+		++lineNum;
+		// Only the whole line is a comment: '#' may be in the names and
+		// in the values (paths)
+		line = trimLine(line);
+		if (line.empty() || line.front() == '#')
+			continue;
+
+		if (line.front() == '[')
+		{
+			if (line.back() != ']' || line.size() < 3)
+			{
+				std::string msg = messageScenarioLine(lineNum) +
+					"invalid name of the scenario. ";
+				ERROR(msg);
+			}
+
+			if (hasScenario)
+				configs.push_back(makeScenarioConfig(name, scenarioValues));
+
+			name = trimLine(line.substr(1, line.size() - 2));
+			scenarioValues.clear();
+			hasScenario = true;
+			continue;
+		}
+
+		const std::size_t equalPos = line.find('=');
+		if (equalPos == std::string::npos)
+		{
+			std::string msg = messageScenarioLine(lineNum) +
+				"the line must be \"key = value\". ";
+			ERROR(msg);
+		}
+
+		if (!hasScenario)
+		{
+			std::string msg = messageScenarioLine(lineNum) +
+				"the value is set before the name of the scenario. ";
+			ERROR(msg);
+		}
+
+		ScenarioValue scenarioValue;
+		scenarioValue.key = trimLine(line.substr(0, equalPos));
+		scenarioValue.value = trimLine(line.substr(equalPos + 1));
+		scenarioValue.lineNum = lineNum;
+		scenarioValues.push_back(std::move(scenarioValue));
+	}
+
+	if (hasScenario)
+		configs.push_back(makeScenarioConfig(name, scenarioValues));
+
+	if (configs.empty())
+	{
+		std::string msg = "There are no scenarios in the scenario file. ";
+		ERROR(msg);
+	}
+
+	for (const auto& config : configs)
+		validateConfig(config);
+
+	return configs;
+}
+
+// Writing the configuration in the format of the scenario file
+void MFE::writeScenario(std::ostream& output, const SimulationConfig& config)
+{
+	const FiniteElement& finiteElement = config.finiteElement;
+	const std::streamsize precision = output.precision();
+	output.precision(std::numeric_limits<Real>::max_digits10);
+
+	std::string integrationScheme = "newmark";
+	if (config.integrationScheme == INTEGRATION_HHT_ALPHA)
+		integrationScheme = "hht_alpha";
+	else if (config.integrationScheme == INTEGRATION_GENERALIZED_ALPHA)
+		integrationScheme = "generalized_alpha";
+
+	const std::string elementFormulation =
+		finiteElement.formulation == FORMULATION_REDUCED_INTEGRATION ?
+		"reduced" : "full";
+
+	output << "[" << config.name << "]\n"
+		<< "frictionMode = " << static_cast<int>(config.frictionMode) << "\n"
+		<< "integrationScheme = " << integrationScheme << "\n"
+		<< "outputFile = " << config.outputFile << "\n"
+		<< "checkpointFile = " << config.checkpointFile << "\n"
+		<< "checkpointInterval = " << config.checkpointInterval << "\n"
+		<< "restartFile = " << config.restartFile << "\n"
+		<< "profileFile = " << config.profileFile << "\n"
+		<< "time = " << config.time << "\n"
+		<< "deltaT = " << config.deltaT << "\n"
+		<< "initialStaticLoad = " << config.initialStaticLoad << "\n"
+		<< "initialAcceleration = " << config.initialAcceleration << "\n"
+		<< "initialSpeed = " << config.initialSpeed << "\n"
+		<< "coeffDryFrictionRest = " << config.coeffDryFrictionRest << "\n"
+		<< "coeffDryFrictionSliding = " << config.coeffDryFrictionSliding << "\n"
+		<< "coeffViscousFriction = " << config.coeffViscousFriction << "\n"
+		<< "normalReaction = " << config.normalReaction << "\n"
+		<< "frequencyCoeff = " << config.frequencyCoeff << "\n"
+		<< "amplitudeForce = " << config.amplitudeForce << "\n"
+		<< "spectralRadius = " << config.spectralRadius << "\n"
+		<< "modulusElastic = " << finiteElement.modulusElastic << "\n"
+		<< "poissonRatio = " << finiteElement.poissonRatio << "\n"
+		<< "dencity = " << finiteElement.dencity << "\n"
+		<< "length = " << finiteElement.length << "\n"
+		<< "width = " << finiteElement.width << "\n"
+		<< "heigth = " << finiteElement.heigth << "\n"
+		<< "elementFormulation = " << elementFormulation << "\n"
+		<< "hourglassCoefficient = " << finiteElement.hourglassCoefficient << "\n";
+
+	output.precision(precision);
+}
+
+// The console front end
+SimulationConfig MFE::inputSimulationConfig()
+{
+	SimulationConfig config;
+	chooseMaterialProperties(config.finiteElement);
+
+	// As well as the oscillation time and time step (for numerical integration)
+	config.time = inputTime();
+	// For good convergence, it's worth taking 1e-7 or 1e-8.
+	config.deltaT = inputDeltaT();
+
+	inputSolverParameters(config);
+
+	return config;
+}
+
+// Entering the parameters of the solver from the console
+void MFE::inputSolverParameters(SimulationConfig& config)
+{
+	const Real initialStaticLoad = inputInitialStaticLoad();
+	const FrictionMode frictionMode =
+		static_cast<FrictionMode>(getFrictionMode());
+
+	SimulationConfig configMode = makeDefaultConfig(frictionMode);
+	configMode.name = config.name;
+	configMode.finiteElement = config.finiteElement;
+	configMode.time = config.time;
+	configMode.deltaT = config.deltaT;
+	configMode.integrationScheme = config.integrationScheme;
+	configMode.spectralRadius = config.spectralRadius;
+	configMode.outputFile = config.outputFile;
+	configMode.checkpointFile = config.checkpointFile;
+	configMode.checkpointInterval = config.checkpointInterval;
+	configMode.restartFile = config.restartFile;
+	configMode.profileFile = config.profileFile;
+	configMode.initialStaticLoad = initialStaticLoad;
+
+	if (frictionMode == FRICTION_VISCOUS_DRIVE)
+	{
+		std::cout << "Input coefficient viscous friction:" << "\n";
+		inputValue(configMode.coeffViscousFriction);
+	}
+	else
+	{
+		std::cout << "Input coefficient of dry friction at rest \n";
+		inputValue(configMode.coeffDryFrictionRest);
+
+		std::cout << "Input coefficient of dry friction at sliding \n";
+		inputValue(configMode.coeffDryFrictionSliding);
+	}
+
+	configMode.initialAcceleration = inputInitialAccel();
+	configMode.initialSpeed = inputInitialSpeed();
+
+	switch (frictionMode)
+	{
+	case FRICTION_DRY_FREE:
+	{
+		configMode.normalReaction = getNormReaction(NO_DRIVE_FORCE_DRY);
+		break;
+	}
+	case FRICTION_DRY_DRIVE:
+	{
+		configMode.frequencyCoeff = inputFrequencyCoeff(HAS_DRIVE_FORCE_DRY);
+		configMode.amplitudeForce = getAmplitudeForce(DRIVE_FORCE_DRY);
+		configMode.normalReaction = getNormReaction(HAS_DRIVE_FORCE_DRY);
+		break;
+	}
+	case FRICTION_VISCOUS_DRIVE:
+	{
+		configMode.frequencyCoeff = inputFrequencyCoeff(DRIVE_FORCE_NO_DRY);
+		configMode.amplitudeForce = getAmplitudeForce(DRIVE_FORCE_NO_DRY);
+		break;
+	}
+	}
+
+	config = configMode;
+}
@@ -31,12 +31,12 @@ Real MFE::getAmplitudeForce(const bool& isDriveForceDry)
 	Real amplitudeForce = 0.0;
 	if (isDriveForceDry)
 	{
-		amplitudeForce = 300.0;
+		amplitudeForce = AMPLITUDE_FORCE_DRY;
 		choiceAmplitude(amplitudeForce);
 	}
 	else
 	{
-		amplitudeForce = 220.0;
+		amplitudeForce = AMPLITUDE_FORCE_VISCOUS;
 		choiceAmplitude(amplitudeForce);
 	}
 
@@ -146,22 +146,27 @@ void choiceFrequency(Real& frequencyCoeff)
 // getFrequencyForce, by setting the coefficient before PI
 Real MFE::getFrequencyForce(const bool& isDriveForceDry)
 {
-	Real frequency = 0.0;
+	// The frequency is calculated after the choice, so that the entered
+	// coefficient is taken into account
+	return inputFrequencyCoeff(isDriveForceDry) * PI;
+}
+
+// Selection of the coefficient before PI manually or by default
+Real MFE::inputFrequencyCoeff(const bool& isDriveForceDry)
+{
 	Real frequencyCoeff = 0.0;
 	if (isDriveForceDry)
 	{
-		frequencyCoeff = 40.0;
-		frequency = frequencyCoeff * PI;
+		frequencyCoeff = FREQUENCY_COEFF_DRY;
 		choiceFrequency(frequencyCoeff);
 	}
 	else
 	{
-		frequencyCoeff = 2.0;
-		frequency = frequencyCoeff * PI;
+		frequencyCoeff = FREQUENCY_COEFF_VISCOUS;
 		choiceFrequency(frequencyCoeff);
 	}
 
-	return frequency;
+	return frequencyCoeff;
 }
 
 // Problem selection
@@ -193,49 +198,42 @@ Real MFE::getNodeLoad(const Real& amplitudeForce)
 }
 
 // The selection function for getNormReaction
-void choiceNormalReaction(bool& isGetNormal, Real& normalReaction)
+void choiceNormalReaction(Real& normalReaction)
 {
-	if (!isGetNormal)
-	{
-		isGetNormal = true;
-		std::cout << "The default value of a normal reaction is "
-				  << normalReaction << ", \n" 
-				  << "do you want to change it (y/n)? \n";
+	std::cout << "The default value of a normal reaction is "
+			  << normalReaction << ", \n" 
+			  << "do you want to change it (y/n)? \n";
 
-		char choice = 'n';
-		inputChoice(choice);
-		bool isChoiceYes = choice == 'y' || choice == 'Y';
-		if (isChoiceYes)
-		{
-			std::cout << "Input the value of the normal reaction: \n";
-			inputValue(normalReaction);
-		}
-		else
-			std::cout << "The default value is : " << normalReaction << "\n\n";
+	char choice = 'n';
+	inputChoice(choice);
+	bool isChoiceYes = choice == 'y' || choice == 'Y';
+	if (isChoiceYes)
+	{
+		std::cout << "Input the value of the normal reaction: \n";
+		inputValue(normalReaction);
 	}
+	else
+		std::cout << "The default value is : " << normalReaction << "\n\n";
 }
 
 // Getting a normal reaction to one degree of freedom (not total)
 Real MFE::getNormReaction(const bool& isDriveForce)
 {
-	Real normalReaction = 0.0;
-	static bool isGetNormal = false;
-	if (isDriveForce)
-	{
-		normalReaction = NORMAL_REACTION_DRIVE;
-		if (!isGetNormal)
-			choiceNormalReaction(isGetNormal, normalReaction);
-	}
-	else
-	{
-		normalReaction = NORMAL_REACTION_FREE;
-		if (!isGetNormal)
-			choiceNormalReaction(isGetNormal, normalReaction);
-	}
+	Real normalReaction = getNormReactionDefault(isDriveForce);
+	choiceNormalReaction(normalReaction);
 
 	return normalReaction;
 }
 
+// The default normal reaction to one degree of freedom
+Real MFE::getNormReactionDefault(const bool& isDriveForce)
+{
+	if (isDriveForce)
+		return NORMAL_REACTION_DRIVE;
+
+	return NORMAL_REACTION_FREE;
+}
+
 // Obtaining the sign of the direction of the friction force
 // for the problem of dry friction without a driving force
 Real MFE::getSignFrictionDrive(const Real& elasticForce,
@@ -275,7 +273,7 @@ Real MFE::getSignFrictionFree(const Real& elasticForce,
 }
 
 // Obtaining the total friction force by active degrees of freedom
-Real MFE::getSumFrictionForce(const Real& signForce,
+Real MFE::getSumFrictionForceDefault(const Real& signForce,
 	const Real& coeffDryFrictionRest, const Real& coeffDryFrictionSliding,
 	const Real& averagePointsSpeed, const bool& isDriveForce)
 {
@@ -285,16 +283,27 @@ Real MFE::getSumFrictionForce(const Real& signForce,
 		ERROR(msg);
 	}
 
+	return getSumFrictionForce(signForce, coeffDryFrictionRest,
+		coeffDryFrictionSliding, averagePointsSpeed,
+		getNormReactionDefault(isDriveForce));
+}
+
+// Obtaining the total friction force by active degrees of freedom
+// for the given normal reaction
+Real MFE::getSumFrictionForce(const Real& signForce,
+	const Real& coeffDryFrictionRest, const Real& coeffDryFrictionSliding,
+	const Real& averagePointsSpeed, const Real& normalReaction)
+{
+	if (ACTIVE_INDICES.size() == 0)
+	{
+		std::string msg = "The size of the ACTIVE_INDICES is 0. ";
+		ERROR(msg);
+	}
+
 	Real sumForce = 0.0;
 	Real coeffDryFriction = getCoeffDryFriction(coeffDryFrictionRest,
 		coeffDryFrictionSliding, averagePointsSpeed);
 
-	Real normalReaction = 0.0;
-	if (isDriveForce)
-		normalReaction = getNormReaction(HAS_DRIVE_FORCE_DRY);
-	else
-		normalReaction = getNormReaction(NO_DRIVE_FORCE_DRY);
-
 	for (const auto& index : ACTIVE_INDICES)
 	{
 		if (index == 1 || index == 4)
@@ -372,8 +381,15 @@ void MFE::setForceElastic(const RealVector& displacement,
 }
 
 // Setting the normal reaction force by degrees of freedom of wall pressure
-void MFE::setForceNormReaction(RealVector& force,
+void MFE::setForceNormReactionDefault(RealVector& force,
 	const bool& isDriveForce)
+{
+	setForceNormReaction(force, getNormReactionDefault(isDriveForce));
+}
+
+// Setting the given normal reaction force by degrees of freedom of wall pressure
+void MFE::setForceNormReaction(RealVector& force,
+	const Real& normalReaction)
 {
 	if (INDICES_NORMAL_REACTION_ACTIVE.size() == 0)
 	{
@@ -381,7 +397,6 @@ void MFE::setForceNormReaction(RealVector& force,
 		ERROR(msg);
 	}
 
-	Real normalReaction = getNormReaction(isDriveForce);
 	const UnsignedType sizeForce = force.size();
 	const UnsignedType lastIndexNormal = INDICES_NORMAL_REACTION_ACTIVE.back();
 
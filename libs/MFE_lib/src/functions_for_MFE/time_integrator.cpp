@@ -0,0 +1,134 @@
+#include <MFE_lib/functions_for_MFE/time_integrator.h>
+#include <MFE_lib/functions_for_MFE/profiling.h>
+
+#include "operator_overloading/operator_overloading.h"
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+// Parameters of the integrator by the scheme and the spectral radius
+IntegratorParameters MFE::makeIntegratorParameters(
+	const IntegrationScheme& scheme, const Real& spectralRadius)
+{
+	IntegratorParameters integrator;
+	switch (scheme)
+	{
+	case INTEGRATION_NEWMARK:
+		break;
+	case INTEGRATION_HHT_ALPHA:
+	{
+		if (spectralRadius < MIN_SPECTRAL_RADIUS_HHT || spectralRadius > 1.0)
+		{
+			std::string msg = "The spectral radius of the HHT-alpha method "
+				"must be in [0.5, 1]. ";
+			ERROR(msg);
+		}
+
+		integrator.alphaM = 0.0;
+		integrator.alphaF = (1.0 - spectralRadius) / (1.0 + spectralRadius);
+		integrator.gamma = 0.5 + integrator.alphaF;
+		integrator.beta = 0.25 * pow(1.0 + integrator.alphaF, 2);
+		break;
+	}
+	case INTEGRATION_GENERALIZED_ALPHA:
+	{
+		if (spectralRadius < 0.0 || spectralRadius > 1.0)
+		{
+			std::string msg = "The spectral radius of the generalized-alpha "
+				"method must be in [0, 1]. ";
+			ERROR(msg);
+		}
+
+		// Chung - Hulbert parameters: the optimal damping of the high
+		// frequencies with the second order of accuracy
+		integrator.alphaM = (2.0 * spectralRadius - 1.0) / (spectralRadius + 1.0);
+		integrator.alphaF = spectralRadius / (spectralRadius + 1.0);
+		integrator.gamma = 0.5 - integrator.alphaM + integrator.alphaF;
+		integrator.beta = 0.25 *
+			pow(1.0 - integrator.alphaM + integrator.alphaF, 2);
+		break;
+	}
+	default:
+	{
+		std::string msg = "Unknown integration scheme. ";
+		ERROR(msg);
+	}
+	}
+
+	return integrator;
+}
+
+// The matrix of coefficients of the step (multiplied by beta * deltaT^2)
+RealMatrix MFE::makeMatrixCoeffsIntegrator(const IntegratorParameters& integrator,
+	const Real& deltaT, const RealMatrix& matrixStiffness,
+	const RealMatrix& matrixMass, const RealMatrix& matrixDamping)
+{
+	const Real betaDt2 = integrator.beta * pow(deltaT, 2);
+	RealMatrix matrixCoeffs = (1.0 - integrator.alphaM) * matrixMass +
+		((1.0 - integrator.alphaF) * betaDt2) * matrixStiffness;
+
+	if (!matrixDamping.empty())
+	{
+		matrixCoeffs = matrixCoeffs +
+			((1.0 - integrator.alphaF) * integrator.gamma * deltaT) *
+			matrixDamping;
+	}
+
+	return matrixCoeffs;
+}
+
+// One step of the integrator.
+// Formulas are used according to the generalized-alpha method and
+// finite differences, the equation of motion is multiplied by beta * deltaT^2.
+// Displacements are calculated using the reflection method.
+void MFE::stepIntegrator(const IntegratorParameters& integrator,
+	const Real& deltaT, const RealMatrix& matrixStiffness,
+	const RealMatrix& matrixMass, const RealMatrix& matrixDamping,
+	const RealMatrix& matrixCoeffs, const RealVector& force,
+	const RealVector& displacementOld, RealVector& displacementNew,
+	RealVector& speed, RealVector& acceleration)
+{
+	const Real alphaM = integrator.alphaM;
+	const Real alphaF = integrator.alphaF;
+	const Real beta = integrator.beta;
+	const Real gamma = integrator.gamma;
+	const Real betaDt2 = beta * pow(deltaT, 2);
+	if (abs(betaDt2) <= DBL_MIN)
+	{
+		std::string msg = messageDivideZero();
+		ERROR(msg);
+	}
+
+	// Predictors of the displacements and the speed (without the new
+	// acceleration)
+	RealVector dispsPredictor = displacementOld + deltaT * speed;
+	dispsPredictor += ((0.5 - beta) * deltaT * deltaT) * acceleration;
+
+	RealVector speedPredictor = speed + ((1.0 - gamma) * deltaT) * acceleration;
+
+	RealVector freeMembers = betaDt2 * force;
+	freeMembers += matrixMass * ((1.0 - alphaM) * dispsPredictor -
+		(betaDt2 * alphaM) * acceleration);
+
+	if (alphaF != 0.0)
+		freeMembers -= (betaDt2 * alphaF) * (matrixStiffness * displacementOld);
+
+	if (!matrixDamping.empty())
+	{
+		RealVector dampingTerm = ((1.0 - alphaF) * gamma * deltaT) * dispsPredictor;
+		dampingTerm -= ((1.0 - alphaF) * betaDt2) * speedPredictor;
+		dampingTerm -= (alphaF * betaDt2) * speed;
+		freeMembers += matrixDamping * dampingTerm;
+	}
+
+	{
+		MFE_PROFILE_SCOPE(PROFILE_SOLVE);
+		displacementNew = solveReflectionMethod(matrixCoeffs, freeMembers);
+	}
+	MFE_PROFILE_COUNT(PROFILE_LINEAR_SOLVES, 1);
+
+	RealVector differenceDisps = displacementNew - dispsPredictor;
+	acceleration = (1.0 / betaDt2) * differenceDisps;
+
+	speed = speedPredictor + (gamma * deltaT) * acceleration;
+}
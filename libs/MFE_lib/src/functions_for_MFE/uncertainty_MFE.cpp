@@ -0,0 +1,499 @@
+#include <MFE_lib/functions_for_MFE/uncertainty_MFE.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "error_handling/error_handling.h"
+#include "parallel/parallel_for.h"
+
+using namespace MFE;
+
+namespace
+{
+	constexpr UnsignedType SOBOL_BITS = 32;
+
+	// Primitive polynomials and initial direction numbers of the Sobol
+	// sequence (S. Joe, F. Kuo) for dimensions 2 - 8, the first dimension
+	// is the van der Corput sequence.
+	struct SobolPolynomial
+	{
+		UnsignedType degree;
+		unsigned int coefficients;
+		std::array<unsigned int, 5> initial;
+	};
+
+	constexpr std::array<SobolPolynomial, UNCERTAIN_PARAMETERS_COUNT - 1>
+		SOBOL_POLYNOMIALS =
+	{ {
+		{ 1, 0, { 1, 0, 0, 0, 0 } },
+		{ 2, 1, { 1, 3, 0, 0, 0 } },
+		{ 3, 1, { 1, 3, 1, 0, 0 } },
+		{ 3, 2, { 1, 1, 1, 0, 0 } },
+		{ 4, 1, { 1, 1, 3, 3, 0 } },
+		{ 4, 4, { 1, 3, 5, 13, 0 } },
+		{ 5, 2, { 1, 1, 5, 5, 17 } },
+	} };
+
+	using SobolDirections =
+		std::array<std::array<unsigned int, SOBOL_BITS>, UNCERTAIN_PARAMETERS_COUNT>;
+
+	SobolDirections makeSobolDirections()
+	{
+		SobolDirections directions{};
+		for (UnsignedType bit = 0; bit < SOBOL_BITS; ++bit)
+			directions[0][bit] = 1u << (SOBOL_BITS - 1 - bit);
+
+		for (UnsignedType dim = 1; dim < UNCERTAIN_PARAMETERS_COUNT; ++dim)
+		{
+			const SobolPolynomial& polynomial = SOBOL_POLYNOMIALS[dim - 1];
+			const UnsignedType degree = polynomial.degree;
+			auto& direction = directions[dim];
+			for (UnsignedType bit = 0; bit < degree; ++bit)
+				direction[bit] = polynomial.initial[bit] << (SOBOL_BITS - 1 - bit);
+
+			for (UnsignedType bit = degree; bit < SOBOL_BITS; ++bit)
+			{
+				unsigned int value = direction[bit - degree] ^
+					(direction[bit - degree] >> degree);
+				for (UnsignedType k = 1; k < degree; ++k)
+				{
+					if ((polynomial.coefficients >> (degree - 1 - k)) & 1u)
+						value ^= direction[bit - k];
+				}
+				direction[bit] = value;
+			}
+		}
+		return directions;
+	}
+
+	// The point of the Sobol sequence with the number "index"
+	// (Gray code construction)
+	std::array<Real, UNCERTAIN_PARAMETERS_COUNT> getSobolPoint(
+		const SobolDirections& directions, const UnsignedType& index)
+	{
+		std::array<Real, UNCERTAIN_PARAMETERS_COUNT> point{};
+		const unsigned long long gray = index ^ (index >> 1);
+		for (UnsignedType dim = 0; dim < UNCERTAIN_PARAMETERS_COUNT; ++dim)
+		{
+			unsigned int value = 0;
+			for (UnsignedType bit = 0; bit < SOBOL_BITS; ++bit)
+			{
+				if ((gray >> bit) & 1ull)
+					value ^= directions[dim][bit];
+			}
+			point[dim] = static_cast<Real>(value) / 4294967296.0;
+		}
+		return point;
+	}
+
+	// The inverse function of the standard normal distribution
+	// (P. J. Acklam's rational approximation)
+	Real inverseNormal(const Real& probability)
+	{
+		constexpr std::array<Real, 6> a = { -3.969683028665376e+01,
+			2.209460984245205e+02, -2.759285104469687e+02,
+			1.383577518672690e+02, -3.066479806614716e+01,
+			2.506628277459239e+00 };
+		constexpr std::array<Real, 5> b = { -5.447609879822406e+01,
+			1.615858368580409e+02, -1.556989798598866e+02,
+			6.680131188771972e+01, -1.328068155288572e+01 };
+		constexpr std::array<Real, 6> c = { -7.784894002430293e-03,
+			-3.223964580411365e-01, -2.400758277161838e+00,
+			-2.549732539343734e+00, 4.374664141464968e+00,
+			2.938163982698783e+00 };
+		constexpr std::array<Real, 4> d = { 7.784695709041462e-03,
+			3.224671290700398e-01, 2.445134137142996e+00,
+			3.754408661907416e+00 };
+		constexpr Real lowLimit = 0.02425;
+
+		if (probability < lowLimit)
+		{
+			Real q = sqrt(-2.0 * log(probability));
+			return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+				c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+		}
+
+		if (probability > 1.0 - lowLimit)
+		{
+			Real q = sqrt(-2.0 * log(1.0 - probability));
+			return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+				c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+		}
+
+		Real q = probability - 0.5;
+		Real r = q * q;
+		return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r +
+			a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r +
+				b[4]) * r + 1.0);
+	}
+
+	// Transformation of the point of the unit interval into the value of
+	// the parameter
+	Real getParameterValue(const UncertainParameter& parameter,
+		Real probability)
+	{
+		probability = std::min(std::max(probability, DBL_EPSILON),
+			1.0 - DBL_EPSILON);
+
+		switch (parameter.distribution)
+		{
+		case DISTRIBUTION_UNIFORM:
+			return parameter.first + probability *
+				(parameter.second - parameter.first);
+		case DISTRIBUTION_NORMAL:
+			return parameter.first + parameter.second * inverseNormal(probability);
+		case DISTRIBUTION_LOG_NORMAL:
+			return exp(parameter.first + parameter.second *
+				inverseNormal(probability));
+		}
+
+		std::string msg = "Unknown distribution of the parameter. ";
+		ERROR(msg);
+		return 0.0;
+	}
+
+	UncertaintySample makeSample(const UncertaintyInput& input,
+		const std::array<Real, UNCERTAIN_PARAMETERS_COUNT>& point)
+	{
+		UncertaintySample sample;
+		FiniteElement& finiteElement = sample.finiteElement;
+		finiteElement.modulusElastic =
+			getParameterValue(input.modulusElastic, point[0]);
+		finiteElement.poissonRatio =
+			getParameterValue(input.poissonRatio, point[1]);
+		finiteElement.dencity = getParameterValue(input.dencity, point[2]);
+		finiteElement.length = getParameterValue(input.length, point[3]);
+		finiteElement.width = getParameterValue(input.width, point[4]);
+		finiteElement.heigth = getParameterValue(input.heigth, point[5]);
+		sample.coeffDryFrictionRest =
+			getParameterValue(input.coeffDryFrictionRest, point[6]);
+		sample.coeffDryFrictionSliding =
+			getParameterValue(input.coeffDryFrictionSliding, point[7]);
+
+		return sample;
+	}
+
+	bool isStatisticConverged(const RunningStatistics& statistics,
+		const UncertaintySettings& settings)
+	{
+		Real halfWidth = statistics.halfWidth(settings.confidenceQuantile);
+		return halfWidth <= std::max(
+			settings.relativeHalfWidth * abs(statistics.mean()),
+			settings.absoluteHalfWidth);
+	}
+}
+
+void RunningStatistics::add(const Real& value)
+{
+	if (m_count == 0)
+	{
+		m_min = value;
+		m_max = value;
+	}
+	else
+	{
+		m_min = std::min(m_min, value);
+		m_max = std::max(m_max, value);
+	}
+
+	++m_count;
+	Real delta = value - m_mean;
+	m_mean += delta / static_cast<Real>(m_count);
+	m_sumSquares += delta * (value - m_mean);
+}
+
+void RunningStatistics::merge(const RunningStatistics& other)
+{
+	if (other.m_count == 0)
+		return;
+
+	if (m_count == 0)
+	{
+		*this = other;
+		return;
+	}
+
+	const Real countLhs = static_cast<Real>(m_count);
+	const Real countRhs = static_cast<Real>(other.m_count);
+	const Real countSum = countLhs + countRhs;
+	const Real delta = other.m_mean - m_mean;
+
+	m_mean += delta * countRhs / countSum;
+	m_sumSquares += other.m_sumSquares + delta * delta * countLhs * countRhs /
+		countSum;
+	m_count += other.m_count;
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+}
+
+UnsignedType RunningStatistics::count() const
+{
+	return m_count;
+}
+
+Real RunningStatistics::mean() const
+{
+	return m_mean;
+}
+
+Real RunningStatistics::variance() const
+{
+	if (m_count < 2)
+		return 0.0;
+
+	return m_sumSquares / static_cast<Real>(m_count - 1);
+}
+
+Real RunningStatistics::standardDeviation() const
+{
+	return sqrt(variance());
+}
+
+Real RunningStatistics::min() const
+{
+	return m_min;
+}
+
+Real RunningStatistics::max() const
+{
+	return m_max;
+}
+
+Real RunningStatistics::halfWidth(const Real& confidenceQuantile) const
+{
+	if (m_count == 0)
+		return DBL_MAX;
+
+	return confidenceQuantile * standardDeviation() /
+		sqrt(static_cast<Real>(m_count));
+}
+
+ResponseAccumulator::ResponseAccumulator(const Real& deltaT) :
+	m_deltaT(deltaT) {}
+
+void ResponseAccumulator::addStep(const RealVector& displacement,
+	const bool& isStuck)
+{
+	const UnsignedType size = displacement.size();
+	if (size > ACTIVE_INDICES.back())
+	{
+		for (const auto& index : ACTIVE_INDICES)
+		{
+			m_peakDisplacement = std::max(m_peakDisplacement,
+				abs(displacement[index]));
+		}
+	}
+	else
+	{
+		std::string msg = messageOutOfRange();
+		ASSERT(size > ACTIVE_INDICES.back(), msg);
+		WARNING(msg);
+	}
+
+	if (m_steps != 0)
+	{
+		if (isStuck)
+			++m_stuckSteps;
+		else
+			m_lastSlidingStep = m_steps;
+	}
+
+	++m_steps;
+}
+
+SampleResponse ResponseAccumulator::getResponse() const
+{
+	SampleResponse response;
+	response.peakDisplacement = m_peakDisplacement;
+	if (m_steps > 1)
+	{
+		response.stickFraction = static_cast<Real>(m_stuckSteps) /
+			static_cast<Real>(m_steps - 1);
+	}
+	response.settlingTime = m_deltaT * static_cast<Real>(m_lastSlidingStep);
+
+	return response;
+}
+
+SampleResponse MFE::getSampleResponse(const RealMatrix& displacements,
+	const Real& deltaT)
+{
+	ResponseAccumulator accumulator(deltaT);
+	const UnsignedType rows = displacements.sizeRows();
+	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
+	{
+		const bool isStuck = rowNum != 0 &&
+			displacements[rowNum] == displacements[rowNum - 1];
+		accumulator.addStep(displacements[rowNum], isStuck);
+	}
+
+	return accumulator.getResponse();
+}
+
+void ResponseSink::begin(const SinkHeader& header)
+{
+	m_accumulator = ResponseAccumulator(header.deltaT);
+}
+
+void ResponseSink::record(const UnsignedType&,
+	const RealVector& displacement, const bool& isStuck)
+{
+	m_accumulator.addStep(displacement, isStuck);
+}
+
+void ResponseSink::end() {}
+
+SampleResponse ResponseSink::getResponse() const
+{
+	return m_accumulator.getResponse();
+}
+
+std::vector<UncertaintySample> MFE::makeSamples(const UncertaintyInput& input,
+	const SamplingMethod& samplingMethod, const UnsignedType& first,
+	const UnsignedType& count, const unsigned long long& seed)
+{
+	std::vector<UncertaintySample> samples;
+	samples.reserve(count);
+
+	switch (samplingMethod)
+	{
+	case SAMPLING_LATIN_HYPERCUBE:
+	{
+		// Each dimension is divided into "count" strata, and each stratum
+		// gets exactly one point.
+		std::mt19937_64 generator(seed + first);
+		std::uniform_real_distribution<Real> uniform(0.0, 1.0);
+		std::array<std::vector<UnsignedType>, UNCERTAIN_PARAMETERS_COUNT> strata;
+		for (auto& permutation : strata)
+		{
+			permutation.resize(count);
+			std::iota(permutation.begin(), permutation.end(), 0);
+			std::shuffle(permutation.begin(), permutation.end(), generator);
+		}
+
+		const Real countCast = static_cast<Real>(count);
+		for (UnsignedType sampleNum = 0; sampleNum < count; ++sampleNum)
+		{
+			std::array<Real, UNCERTAIN_PARAMETERS_COUNT> point{};
+			for (UnsignedType dim = 0; dim < UNCERTAIN_PARAMETERS_COUNT; ++dim)
+			{
+				point[dim] = (static_cast<Real>(strata[dim][sampleNum]) +
+					uniform(generator)) / countCast;
+			}
+			samples.push_back(makeSample(input, point));
+		}
+		break;
+	}
+	case SAMPLING_SOBOL:
+	{
+		// The zero point of the sequence is skipped: it lies on the boundary
+		// of the unit cube.
+		static const SobolDirections directions = makeSobolDirections();
+		for (UnsignedType sampleNum = 0; sampleNum < count; ++sampleNum)
+		{
+			samples.push_back(makeSample(input,
+				getSobolPoint(directions, first + sampleNum + 1)));
+		}
+		break;
+	}
+	default:
+	{
+		std::string msg = "Unknown sampling method. ";
+		ERROR(msg);
+	}
+	}
+
+	return samples;
+}
+
+UncertaintyResult MFE::runUncertainty(const UncertaintyInput& input,
+	const UncertaintySettings& settings, const SampleModel& model)
+{
+	if (!model)
+	{
+		std::string msg = "The model of the sample is not set. ";
+		ERROR(msg);
+	}
+
+	if (settings.batchSize == 0)
+	{
+		std::string msg = "The size of the batch is 0. ";
+		ERROR(msg);
+	}
+
+	if (!(settings.relativeHalfWidth >= 0.0) || !(settings.absoluteHalfWidth >= 0.0))
+	{
+		std::string msg = "The required half-width of the confidence interval "
+			"is negative. ";
+		ERROR(msg);
+	}
+
+	UncertaintyResult result;
+	while (result.samplesCount < settings.maxSamples && !result.isConverged)
+	{
+		UnsignedType batchSize = std::min(settings.batchSize,
+			settings.maxSamples - result.samplesCount);
+
+		std::vector<UncertaintySample> samples = makeSamples(input,
+			settings.samplingMethod, result.samplesCount, batchSize,
+			settings.seed);
+
+		std::vector<SampleResponse> responses(batchSize);
+		parallelFor(batchSize, settings.threadsCount,
+			[&](const UnsignedType index)
+			{
+				responses[index] = model(samples[index]);
+			});
+
+		// The statistics are updated in the order of the samples, so the
+		// result does not depend on the number of threads.
+		for (const auto& response : responses)
+		{
+			result.peakDisplacement.add(response.peakDisplacement);
+			result.stickFraction.add(response.stickFraction);
+			result.settlingTime.add(response.settlingTime);
+		}
+		result.samplesCount += batchSize;
+
+		if (result.samplesCount >= settings.minSamples)
+		{
+			result.isConverged =
+				isStatisticConverged(result.peakDisplacement, settings) &&
+				isStatisticConverged(result.stickFraction, settings) &&
+				isStatisticConverged(result.settlingTime, settings);
+		}
+	}
+
+	return result;
+}
+
+// The configuration of the sample
+SimulationConfig MFE::makeSampleConfig(const SimulationConfig& config,
+	const UncertaintySample& sample)
+{
+	SimulationConfig sampleConfig = config;
+	sampleConfig.finiteElement = sample.finiteElement;
+	sampleConfig.coeffDryFrictionRest = sample.coeffDryFrictionRest;
+	sampleConfig.coeffDryFrictionSliding = sample.coeffDryFrictionSliding;
+
+	return sampleConfig;
+}
+
+// The Monte Carlo driver for the dynamic solver
+UncertaintyResult MFE::runUncertainty(const SimulationConfig& config,
+	const UncertaintyInput& input, const UncertaintySettings& settings)
+{
+	validateConfig(config);
+
+	SampleModel model = [&config](const UncertaintySample& sample)
+		{
+			SimulationConfig sampleConfig = makeSampleConfig(config, sample);
+			ResponseSink sink;
+			runSimulation(sampleConfig, sink);
+
+			return sink.getResponse();
+		};
+
+	return runUncertainty(input, settings, model);
+}
@@ -167,4 +167,98 @@ RealVector MFE::solveReflectionMethod(RealMatrix matrixCoeffs,
 	}
 	
 	return solution;
-}
\ No newline at end of file
+}
+
+// Eigenvalues and eigenvectors of a symmetric matrix (cyclic Jacobi method)
+void MFE::calculateEigenSymmetric(const RealMatrix& matrix,
+	RealVector& eigenvalues, RealMatrix& eigenvectors)
+{
+	const UnsignedType size = matrix.sizeRows();
+	if (size == 0 || size != matrix.sizeColumns())
+	{
+		std::string msg = "The matrix is not square. ";
+		ERROR(msg);
+	}
+
+	RealMatrix rotated = matrix;
+	RealMatrix vectors = identityMatrix(size);
+	constexpr UnsignedType maxSweeps = 100;
+	bool isConverged = false;
+	// The norm is also checked after the last sweep
+	for (UnsignedType sweep = 0; sweep <= maxSweeps; ++sweep)
+	{
+		Real offDiagonal = 0.0;
+		Real diagonal = 0.0;
+		for (UnsignedType rowNum = 0; rowNum < size; ++rowNum)
+		{
+			diagonal += pow(rotated[rowNum][rowNum], 2);
+			for (UnsignedType columnNum = rowNum + 1; columnNum < size; ++columnNum)
+				offDiagonal += pow(rotated[rowNum][columnNum], 2);
+		}
+
+		if (offDiagonal <= DBL_EPSILON * DBL_EPSILON * diagonal)
+		{
+			isConverged = true;
+			break;
+		}
+
+		if (sweep == maxSweeps)
+			break;
+
+		for (UnsignedType p = 0; p < size - 1; ++p)
+		{
+			for (UnsignedType q = p + 1; q < size; ++q)
+			{
+				if (abs(rotated[p][q]) <= DBL_MIN)
+					continue;
+
+				// The rotation that sets the element (p, q) to zero
+				Real theta = (rotated[q][q] - rotated[p][p]) /
+					(2.0 * rotated[p][q]);
+				Real tangent = 1.0 / (abs(theta) + sqrt(theta * theta + 1.0));
+				if (theta < 0.0)
+					tangent = -tangent;
+
+				Real cosine = 1.0 / sqrt(tangent * tangent + 1.0);
+				Real sine = tangent * cosine;
+
+				for (UnsignedType k = 0; k < size; ++k)
+				{
+					Real valueP = rotated[k][p];
+					Real valueQ = rotated[k][q];
+					rotated[k][p] = cosine * valueP - sine * valueQ;
+					rotated[k][q] = sine * valueP + cosine * valueQ;
+				}
+
+				for (UnsignedType k = 0; k < size; ++k)
+				{
+					Real valueP = rotated[p][k];
+					Real valueQ = rotated[q][k];
+					rotated[p][k] = cosine * valueP - sine * valueQ;
+					rotated[q][k] = sine * valueP + cosine * valueQ;
+				}
+
+				for (UnsignedType k = 0; k < size; ++k)
+				{
+					Real valueP = vectors[p][k];
+					Real valueQ = vectors[q][k];
+					vectors[p][k] = cosine * valueP - sine * valueQ;
+					vectors[q][k] = sine * valueP + cosine * valueQ;
+				}
+			}
+		}
+	}
+
+	if (!isConverged)
+	{
+		std::string msg = "The Jacobi method did not converge in " +
+			std::to_string(maxSweeps) + " sweeps. ";
+		WARNING(msg);
+	}
+
+	eigenvalues.assign(size, 0.0);
+	for (UnsignedType index = 0; index < size; ++index)
+		eigenvalues[index] = rotated[index][index];
+
+	eigenvectors = vectors;
+}
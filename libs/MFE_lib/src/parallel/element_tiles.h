@@ -0,0 +1,74 @@
+// This file is used in the files of the operators of the structured meshes.
+// This file contains the division of the elements of the structured mesh
+// into the tiles that are calculated in parallel without atomics.
+#ifndef ELEMENT_TILES_H
+#define ELEMENT_TILES_H
+
+#include <algorithm>
+#include <vector>
+
+#include <MFE_lib/types/types.h>
+
+namespace MFE
+{
+	// The number of the colors of the tiles
+	constexpr UnsignedType TILE_COLORS_COUNT = 4;
+
+	// The tiles of the mesh of countY rows of the elements along y in each of
+	// countZ layers along z: the tile is "tileRows" rows of one layer (the
+	// last tile of the layer can be shorter), the tile "tile" is the rows
+	// from (tile % tilesCount) * tileRows of the layer tile / tilesCount,
+	// where tilesCount is the number of the tiles in the layer.
+	// The colors are the parities of the layer and of the tile in the layer:
+	// the tiles of one color do not have common nodes, so they add their
+	// forces to the vector at the same time without atomics, and the colors
+	// are calculated one after another. The tiles of a color are in
+	// ascending order, the result does not depend on the number of threads.
+	inline std::vector<std::vector<UnsignedType>> makeTileColors(
+		const UnsignedType& countY, const UnsignedType& countZ,
+		const UnsignedType& tileRows)
+	{
+		const UnsignedType rows = std::max<UnsignedType>(tileRows, 1);
+		const UnsignedType tilesCount = (countY + rows - 1) / rows;
+
+		std::vector<std::vector<UnsignedType>> colors(TILE_COLORS_COUNT);
+		for (UnsignedType layer = 0; layer < countZ; ++layer)
+		{
+			for (UnsignedType tileNum = 0; tileNum < tilesCount; ++tileNum)
+			{
+				colors[2 * (layer % 2) + tileNum % 2].push_back(
+					layer * tilesCount + tileNum);
+			}
+		}
+
+		colors.erase(std::remove_if(colors.begin(), colors.end(),
+			[](const std::vector<UnsignedType>& color) { return color.empty(); }),
+			colors.end());
+
+		return colors;
+	}
+
+	// The layer and the rows firstRow, ..., endRow - 1 of the tile
+	struct ElementTile
+	{
+		UnsignedType layer = 0;
+		UnsignedType firstRow = 0;
+		UnsignedType endRow = 0;
+	};
+
+	inline ElementTile getElementTile(const UnsignedType& tile,
+		const UnsignedType& countY, const UnsignedType& tileRows)
+	{
+		const UnsignedType rows = std::max<UnsignedType>(tileRows, 1);
+		const UnsignedType tilesCount = (countY + rows - 1) / rows;
+
+		ElementTile elementTile;
+		elementTile.layer = tile / tilesCount;
+		elementTile.firstRow = (tile % tilesCount) * rows;
+		elementTile.endRow = std::min(elementTile.firstRow + rows, countY);
+
+		return elementTile;
+	}
+}
+
+#endif
@@ -0,0 +1,73 @@
+// This file is used in the files of the solvers that calculate independent
+// tasks in parallel (samples, frequencies, elements).
+// This file contains the function of the parallel loop over the tasks.
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <MFE_lib/types/types.h>
+
+namespace MFE
+{
+	// The number of threads: the requested one or, if it is 0, by the number
+	// of cores.
+	inline UnsignedType getThreadsCount(const UnsignedType& threadsCount)
+	{
+		if (threadsCount != 0)
+			return threadsCount;
+
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Calling "task(index)" for all indices from 0 to count - 1 in
+	// "threadsCount" threads. Each thread takes the next free index, the
+	// calling thread also works. The first exception of the tasks is
+	// rethrown after all threads have finished.
+	template <typename Task>
+	inline void parallelFor(const UnsignedType& count,
+		const UnsignedType& threadsCount, Task&& task)
+	{
+		const UnsignedType threadsUsed =
+			std::min(getThreadsCount(threadsCount), std::max<UnsignedType>(count, 1));
+		std::vector<std::exception_ptr> exceptions(threadsUsed);
+		std::atomic<UnsignedType> nextIndex{ 0 };
+
+		auto work = [&](const UnsignedType threadNum)
+		{
+			try
+			{
+				for (UnsignedType index = nextIndex++; index < count;
+					index = nextIndex++)
+				{
+					task(index);
+				}
+			}
+			catch (...)
+			{
+				exceptions[threadNum] = std::current_exception();
+				nextIndex = count;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (UnsignedType threadNum = 1; threadNum < threadsUsed; ++threadNum)
+			threads.emplace_back(work, threadNum);
+		work(0);
+
+		for (auto& thread : threads)
+			thread.join();
+
+		for (const auto& exception : exceptions)
+		{
+			if (exception)
+				std::rethrow_exception(exception);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,169 @@
+// This file is used in the files of the operators that calculate the tasks
+// in parallel many times (at each iteration of the solver).
+// This file contains the pool of the threads that wait for the tasks between
+// the runs, so the threads are not created and joined at each run as in
+// parallelFor.
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parallel/parallel_for.h"
+
+namespace MFE
+{
+	// threadsCount - the number of threads with the calling one (0 - by the
+	// number of cores). The runs of several threads with the same pool are
+	// performed one after another.
+	class ThreadPool
+	{
+	public:
+
+		explicit ThreadPool(const UnsignedType& threadsCount = 0)
+		{
+			const UnsignedType threadsUsed = MFE::getThreadsCount(threadsCount);
+			m_exceptions.resize(threadsUsed);
+			for (UnsignedType threadNum = 1; threadNum < threadsUsed; ++threadNum)
+				m_threads.emplace_back(&ThreadPool::wait, this, threadNum);
+		}
+
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_isStopped = true;
+			}
+			m_started.notify_all();
+
+			for (auto& thread : m_threads)
+				thread.join();
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		UnsignedType getThreadsCount() const
+		{
+			return m_threads.size() + 1;
+		}
+
+		// Calling "task(index)" for all indices from 0 to count - 1 as
+		// parallelFor: each thread takes the next free index, the calling
+		// thread also works, the first exception of the tasks is rethrown
+		// after all threads have finished.
+		template <typename Task>
+		void run(const UnsignedType& count, Task&& task)
+		{
+			std::lock_guard<std::mutex> runLock(m_runMutex);
+
+			const std::function<void(const UnsignedType)> function =
+				std::ref(task);
+			if (m_threads.empty() || count <= 1)
+			{
+				for (UnsignedType index = 0; index < count; ++index)
+					function(index);
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_task = &function;
+				m_count = count;
+				m_nextIndex = 0;
+				m_activeCount = m_threads.size();
+				++m_generation;
+			}
+			m_started.notify_all();
+
+			work(0);
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_finished.wait(lock, [this] { return m_activeCount == 0; });
+				m_task = nullptr;
+			}
+
+			for (auto& exception : m_exceptions)
+			{
+				if (exception)
+				{
+					const std::exception_ptr first = exception;
+					for (auto& other : m_exceptions)
+						other = nullptr;
+					std::rethrow_exception(first);
+				}
+			}
+		}
+
+	private:
+
+		// The tasks of the current run
+		void work(const UnsignedType threadNum)
+		{
+			try
+			{
+				for (UnsignedType index = m_nextIndex++; index < m_count;
+					index = m_nextIndex++)
+				{
+					(*m_task)(index);
+				}
+			}
+			catch (...)
+			{
+				m_exceptions[threadNum] = std::current_exception();
+				m_nextIndex = m_count;
+			}
+		}
+
+		// Waiting for the runs, each thread works once in each run
+		void wait(const UnsignedType threadNum)
+		{
+			UnsignedType generation = 0;
+			while (true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_started.wait(lock, [&]
+						{
+							return m_isStopped || m_generation != generation;
+						});
+					if (m_isStopped)
+						return;
+					generation = m_generation;
+				}
+
+				work(threadNum);
+
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (--m_activeCount == 0)
+						m_finished.notify_one();
+				}
+			}
+		}
+
+		std::vector<std::thread> m_threads;
+		std::vector<std::exception_ptr> m_exceptions;
+
+		std::mutex m_runMutex;
+		std::mutex m_mutex;
+		std::condition_variable m_started;
+		std::condition_variable m_finished;
+
+		const std::function<void(const UnsignedType)>* m_task = nullptr;
+		UnsignedType m_count = 0;
+		std::atomic<UnsignedType> m_nextIndex{ 0 };
+		UnsignedType m_activeCount = 0;
+		UnsignedType m_generation = 0;
+		bool m_isStopped = false;
+
+	};
+}
+
+#endif
@@ -0,0 +1,223 @@
+#include <MFE_lib/sparse_matrix.h>
+#include <MFE_lib/functions_for_MFE/profiling.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "error_handling/error_handling.h"
+
+using namespace MFE;
+
+static Real dotProduct(const RealVector& vectorLhs, const RealVector& vectorRhs)
+{
+	Real sum = 0.0;
+	for (UnsignedType index = 0; index < vectorLhs.size(); ++index)
+		sum += vectorLhs[index] * vectorRhs[index];
+
+	return sum;
+}
+
+static void checkSparseMatrix(const SparseMatrix& matrix)
+{
+	const bool isCorrect = matrix.rowOffsets.size() == matrix.rows + 1 &&
+		matrix.columns.size() == matrix.values.size() &&
+		matrix.rowOffsets.back() == matrix.columns.size();
+	if (!isCorrect)
+	{
+		std::string msg = "The sparse matrix is not in the CSR format. ";
+		ERROR(msg);
+	}
+}
+
+// The position of the value in "values"
+static UnsignedType findSparsePosition(const SparseMatrix& matrix,
+	const UnsignedType& rowNum, const UnsignedType& columnNum)
+{
+	if (rowNum >= matrix.rows)
+	{
+		std::string msg = messageOutOfRange();
+		ERROR(msg);
+	}
+
+	const auto begin = matrix.columns.begin() + matrix.rowOffsets[rowNum];
+	const auto end = matrix.columns.begin() + matrix.rowOffsets[rowNum + 1];
+	const auto position = std::lower_bound(begin, end, columnNum);
+	if (position == end || *position != columnNum)
+	{
+		std::string msg = "The position is not in the pattern of the sparse "
+			"matrix. ";
+		ERROR(msg);
+	}
+
+	return static_cast<UnsignedType>(position - matrix.columns.begin());
+}
+
+Real& MFE::getSparseValue(SparseMatrix& matrix, const UnsignedType& rowNum,
+	const UnsignedType& columnNum)
+{
+	return matrix.values[findSparsePosition(matrix, rowNum, columnNum)];
+}
+
+void MFE::multiplySparse(const SparseMatrix& matrix, const RealVector& vec,
+	RealVector& result)
+{
+	if (vec.size() != matrix.rows)
+	{
+		std::string msg = "Vector size != matrix rows. ";
+		ERROR(msg);
+	}
+
+	result.resize(matrix.rows);
+	for (UnsignedType rowNum = 0; rowNum < matrix.rows; ++rowNum)
+	{
+		Real sum = 0.0;
+		for (UnsignedType position = matrix.rowOffsets[rowNum];
+			position < matrix.rowOffsets[rowNum + 1]; ++position)
+		{
+			sum += matrix.values[position] * vec[matrix.columns[position]];
+		}
+		result[rowNum] = sum;
+	}
+}
+
+RealMatrix MFE::makeDenseMatrix(const SparseMatrix& matrix)
+{
+	checkSparseMatrix(matrix);
+
+	RealMatrix result(matrix.rows, matrix.rows);
+	for (UnsignedType rowNum = 0; rowNum < matrix.rows; ++rowNum)
+	{
+		for (UnsignedType position = matrix.rowOffsets[rowNum];
+			position < matrix.rowOffsets[rowNum + 1]; ++position)
+		{
+			result[rowNum][matrix.columns[position]] = matrix.values[position];
+		}
+	}
+	return result;
+}
+
+SparseOperator::SparseOperator(const SparseMatrix& matrix) :
+	m_matrix(matrix)
+{
+	checkSparseMatrix(m_matrix);
+}
+
+UnsignedType SparseOperator::sizeRows() const
+{
+	return m_matrix.rows;
+}
+
+void SparseOperator::apply(const RealVector& vec, RealVector& result) const
+{
+	multiplySparse(m_matrix, vec, result);
+}
+
+RealVector SparseOperator::getDiagonal() const
+{
+	RealVector diagonal(m_matrix.rows, 0.0);
+	for (UnsignedType rowNum = 0; rowNum < m_matrix.rows; ++rowNum)
+		diagonal[rowNum] = m_matrix.values[findSparsePosition(m_matrix, rowNum, rowNum)];
+
+	return diagonal;
+}
+
+IterativeSolution MFE::solveConjugateGradient(const SparseMatrix& matrix,
+	const RealVector& freeTerms, const IterativeSolverOptions& options)
+{
+	return solveConjugateGradient(SparseOperator(matrix), freeTerms, options);
+}
+
+// The preconditioner is the inverse of the diagonal, the residual is
+// updated by the recurrence (one product by the matrix per iteration)
+IterativeSolution MFE::solveConjugateGradient(const LinearOperator& matrix,
+	const RealVector& freeTerms, const IterativeSolverOptions& options)
+{
+	MFE_PROFILE_SCOPE(PROFILE_SOLVE);
+	MFE_PROFILE_COUNT(PROFILE_LINEAR_SOLVES, 1);
+
+	const UnsignedType size = matrix.sizeRows();
+	if (freeTerms.size() != size)
+	{
+		std::string msg = "Vector size != matrix rows. ";
+		ERROR(msg);
+	}
+
+	RealVector inverseDiagonal = matrix.getDiagonal();
+	for (auto& diagonal : inverseDiagonal)
+	{
+		if (diagonal <= 0.0)
+		{
+			std::string msg = "The matrix is not positive definite. ";
+			ERROR(msg);
+		}
+		diagonal = 1.0 / diagonal;
+	}
+
+	IterativeSolution result;
+	result.solution.assign(size, 0.0);
+
+	const Real normFreeTerms = std::sqrt(dotProduct(freeTerms, freeTerms));
+	if (normFreeTerms == 0.0)
+	{
+		result.isConverged = true;
+		return result;
+	}
+
+	RealVector residual = freeTerms;
+	RealVector preconditioned(size);
+	for (UnsignedType index = 0; index < size; ++index)
+		preconditioned[index] = inverseDiagonal[index] * residual[index];
+
+	RealVector direction = preconditioned;
+	RealVector product(size);
+	Real residualProduct = dotProduct(residual, preconditioned);
+
+	const UnsignedType maxIterations =
+		options.maxIterations == 0 ? size : options.maxIterations;
+	result.residual = 1.0;
+	while (result.iterations < maxIterations)
+	{
+		matrix.apply(direction, product);
+		const Real curvature = dotProduct(direction, product);
+		if (curvature <= 0.0)
+		{
+			std::string msg = "The matrix is not positive definite. ";
+			ERROR(msg);
+		}
+
+		const Real step = residualProduct / curvature;
+		for (UnsignedType index = 0; index < size; ++index)
+		{
+			result.solution[index] += step * direction[index];
+			residual[index] -= step * product[index];
+		}
+		++result.iterations;
+
+		result.residual = std::sqrt(dotProduct(residual, residual)) /
+			normFreeTerms;
+		if (result.residual <= options.tolerance)
+		{
+			result.isConverged = true;
+			break;
+		}
+
+		for (UnsignedType index = 0; index < size; ++index)
+			preconditioned[index] = inverseDiagonal[index] * residual[index];
+
+		const Real residualProductNew = dotProduct(residual, preconditioned);
+		const Real factor = residualProductNew / residualProduct;
+		residualProduct = residualProductNew;
+		for (UnsignedType index = 0; index < size; ++index)
+			direction[index] = preconditioned[index] + factor * direction[index];
+	}
+
+	MFE_PROFILE_COUNT(PROFILE_SOLVER_ITERATIONS, result.iterations);
+	if (!result.isConverged)
+	{
+		std::string msg = "The conjugate gradient method did not converge in " +
+			std::to_string(maxIterations) + " iterations. ";
+		WARNING(msg);
+	}
+
+	return result;
+}
@@ -1,17 +1,26 @@
 #include <MFE_lib/write_functions.h>
 
+#include <algorithm>
+#include <charconv>
+
 #include "error_handling/error_handling.h"
 
 using namespace MFE;
 
+// The maximum length of a formatted number: the sign, the digits, the point
+// and the exponent (e-308)
+constexpr UnsignedType NUMBER_SIZE_MAX = 32;
+static_assert(TEXT_PRECISION_MAX + 7 <= NUMBER_SIZE_MAX,
+	"The formatted number does not fit into NUMBER_SIZE_MAX");
+
 std::string messageNotRecorded()
 {
 	return "The displacements are not recorded. ";
 }
 
-void checkFileOpen(std::ofstream& fout, bool& isWrite)
+void checkFileOpen(const TextWriter& writer, bool& isWrite)
 {
-	if (!fout.is_open())
+	if (!writer.isOpen())
 	{
 		std::string msg = "The file was not opened. ";
 		WARNING(msg);
@@ -21,82 +30,173 @@ void checkFileOpen(std::ofstream& fout, bool& isWrite)
 	std::cout << "File is open. \n";
 }
 
-bool MFE::writeDispAllNodes(const RealMatrix& displacements)
+TextWriter::TextWriter(const std::string& fileName, const int& precision,
+	const UnsignedType& bufferSize) :
+	m_fout(fileName),
+	m_buffer(std::max(bufferSize, NUMBER_SIZE_MAX)),
+	m_precision(precision)
 {
-	bool isWrite = true;
-	std::ofstream fout("displacements.txt");
-	checkFileOpen(fout, isWrite);
-
-	const UnsignedType rows = displacements.sizeRows();
-	const UnsignedType lastActiveIndex = ACTIVE_INDICES.back();
-	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
+	if (m_precision < TEXT_PRECISION_SHORTEST || m_precision > TEXT_PRECISION_MAX)
 	{
-		if (displacements[rowNum].size() >= lastActiveIndex + 1)
-		{
-			for (const auto& index : ACTIVE_INDICES)
-			{
-				if (index == lastActiveIndex)
-					fout << std::to_string(index) << ": " 
-						 << displacements[rowNum][index] << "\n";
-				else
-					fout << std::to_string(index) << ": "
-					<< displacements[rowNum][index] << "  ";
-			}
-		}
-		else
-		{
-			std::string msg = messageNotRecorded();
-			std::cout << msg << "\n";
-			WARNING(msg);
+		std::string msg = "The precision of the values must be from " +
+			std::to_string(TEXT_PRECISION_SHORTEST) + " to " +
+			std::to_string(TEXT_PRECISION_MAX) + ". ";
+		ERROR(msg);
+	}
 
-			isWrite = false;
-		}
+	m_isWritten = m_fout.is_open();
+}
+
+TextWriter::~TextWriter()
+{
+	close();
+}
+
+bool TextWriter::isOpen() const
+{
+	return m_fout.is_open();
+}
+
+void TextWriter::writeValue(const Real& value)
+{
+	reserve(NUMBER_SIZE_MAX);
+
+	char* first = m_buffer.data() + m_size;
+	char* last = m_buffer.data() + m_buffer.size();
+	std::to_chars_result result;
+	if (m_precision == TEXT_PRECISION_SHORTEST)
+		result = std::to_chars(first, last, value);
+	else
+		result = std::to_chars(first, last, value, std::chars_format::general,
+			m_precision);
+
+	if (result.ec != std::errc())
+	{
+		std::string msg = "The value does not fit into the buffer. ";
+		ERROR(msg);
 	}
-	fout.close();
 
-	return isWrite;
+	m_size = result.ptr - m_buffer.data();
 }
 
-bool MFE::writeDispFirstNode(const RealMatrix& displacements)
+void TextWriter::writeValue(const UnsignedType& value)
 {
-	bool isWrite = true;
-	std::ofstream fout("displacements.txt");
-	checkFileOpen(fout, isWrite);
+	reserve(NUMBER_SIZE_MAX);
 
-	const UnsignedType rows = displacements.sizeRows();
-	const UnsignedType& firstIndex = ACTIVE_INDICES.front();
-	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
+	char* first = m_buffer.data() + m_size;
+	char* last = m_buffer.data() + m_buffer.size();
+	const std::to_chars_result result = std::to_chars(first, last, value);
+	if (result.ec != std::errc())
 	{
-		if (displacements[rowNum].size() >= firstIndex + 1)
-			fout << displacements[rowNum][firstIndex] << "\n";
-		else
-		{
-			std::string msg = messageNotRecorded();
-			std::cout << msg << "\n";
-			WARNING(msg);
+		std::string msg = "The value does not fit into the buffer. ";
+		ERROR(msg);
+	}
 
-			isWrite = false;
-			break;
-		}
+	m_size = result.ptr - m_buffer.data();
+}
+
+void TextWriter::writeText(const std::string& text)
+{
+	if (text.size() > m_buffer.size())
+	{
+		flush();
+		if (m_fout.is_open())
+			m_fout.write(text.data(), text.size());
+		return;
 	}
 
-	fout.close();
+	reserve(text.size());
+	std::copy(text.begin(), text.end(), m_buffer.begin() + m_size);
+	m_size += text.size();
+}
 
-	return isWrite;
+void TextWriter::writeChar(const char& symbol)
+{
+	reserve(1);
+	m_buffer[m_size] = symbol;
+	++m_size;
+}
+
+bool TextWriter::close()
+{
+	if (!m_fout.is_open())
+		return m_isWritten;
+
+	flush();
+	m_fout.close();
+	if (m_fout.fail())
+		m_isWritten = false;
+
+	return m_isWritten;
 }
 
-bool MFE::writeDispSecondNode(const RealMatrix& displacements)
+void TextWriter::reserve(const UnsignedType& size)
+{
+	if (m_buffer.size() - m_size < size)
+		flush();
+}
+
+void TextWriter::flush()
+{
+	if (m_fout.is_open() && m_size != 0)
+		m_fout.write(m_buffer.data(), m_size);
+	m_size = 0;
+}
+
+ChannelsWriter::ChannelsWriter(const std::string& fileName,
+	const std::vector<UnsignedType>& indices, const TextLayout& layout,
+	const int& precision) :
+	m_writer(fileName, precision), m_indices(indices)
+{
+	m_separator = layout == TEXT_LAYOUT_TSV ? '\t' : ',';
+
+	m_writer.writeText("time");
+	for (const auto& index : m_indices)
+	{
+		m_writer.writeChar(m_separator);
+		m_writer.writeChar('u');
+		m_writer.writeValue(index);
+	}
+	m_writer.writeChar('\n');
+}
+
+bool ChannelsWriter::isOpen() const
+{
+	return m_writer.isOpen();
+}
+
+void ChannelsWriter::writeRow(const Real& time, const RealVector& displacement)
+{
+	m_writer.writeValue(time);
+	for (const auto& index : m_indices)
+	{
+		m_writer.writeChar(m_separator);
+		m_writer.writeValue(displacement[index]);
+	}
+	m_writer.writeChar('\n');
+}
+
+bool ChannelsWriter::close()
+{
+	return m_writer.close();
+}
+
+// Writing the displacements of the degree of freedom "index", one per line
+static bool writeDispIndex(const RealMatrix& displacements,
+	const UnsignedType& index, const std::string& fileName)
 {
 	bool isWrite = true;
-	std::ofstream fout("displacements.txt");
-	checkFileOpen(fout, isWrite);
+	TextWriter writer(fileName, TEXT_PRECISION_STREAM);
+	checkFileOpen(writer, isWrite);
 
 	const UnsignedType rows = displacements.sizeRows();
-	const UnsignedType& secondIndex = ACTIVE_INDICES[1];
 	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
 	{
-		if (displacements[rowNum].size() >= secondIndex + 1)
-			fout << displacements[rowNum][secondIndex] << "\n";
+		if (displacements[rowNum].size() >= index + 1)
+		{
+			writer.writeValue(displacements[rowNum][index]);
+			writer.writeChar('\n');
+		}
 		else
 		{
 			std::string msg = messageNotRecorded();
@@ -108,23 +208,36 @@ bool MFE::writeDispSecondNode(const RealMatrix& displacements)
 		}
 	}
 
-	fout.close();
-	
+	if (!writer.close())
+		isWrite = false;
+
 	return isWrite;
 }
 
-bool MFE::writeDispFifthNode(const RealMatrix& displacements)
+bool MFE::writeDispAllNodes(const RealMatrix& displacements,
+	const std::string& fileName)
 {
 	bool isWrite = true;
-	std::ofstream fout("displacements.txt");
-	checkFileOpen(fout, isWrite);
+	TextWriter writer(fileName, TEXT_PRECISION_STREAM);
+	checkFileOpen(writer, isWrite);
 
 	const UnsignedType rows = displacements.sizeRows();
-	const UnsignedType& thirdIndex = ACTIVE_INDICES[3];
+	const UnsignedType lastActiveIndex = ACTIVE_INDICES.back();
 	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
 	{
-		if (displacements[rowNum].size() >= thirdIndex + 1)
-			fout << displacements[rowNum][thirdIndex] << "\n";
+		if (displacements[rowNum].size() >= lastActiveIndex + 1)
+		{
+			for (const auto& index : ACTIVE_INDICES)
+			{
+				writer.writeValue(index);
+				writer.writeText(": ");
+				writer.writeValue(displacements[rowNum][index]);
+				if (index == lastActiveIndex)
+					writer.writeChar('\n');
+				else
+					writer.writeText("  ");
+			}
+		}
 		else
 		{
 			std::string msg = messageNotRecorded();
@@ -132,54 +245,90 @@ bool MFE::writeDispFifthNode(const RealMatrix& displacements)
 			WARNING(msg);
 
 			isWrite = false;
-			break;
 		}
 	}
 
-	fout.close();
+	if (!writer.close())
+		isWrite = false;
 
 	return isWrite;
 }
 
-bool MFE::writeDispSixthNode(const RealMatrix& displacements)
+bool MFE::writeDispFirstNode(const RealMatrix& displacements,
+	const std::string& fileName)
+{
+	return writeDispIndex(displacements, ACTIVE_INDICES.front(), fileName);
+}
+
+bool MFE::writeDispSecondNode(const RealMatrix& displacements,
+	const std::string& fileName)
+{
+	return writeDispIndex(displacements, ACTIVE_INDICES[1], fileName);
+}
+
+bool MFE::writeDispFifthNode(const RealMatrix& displacements,
+	const std::string& fileName)
+{
+	return writeDispIndex(displacements, ACTIVE_INDICES[3], fileName);
+}
+
+bool MFE::writeDispSixthNode(const RealMatrix& displacements,
+	const std::string& fileName)
+{
+	return writeDispIndex(displacements, ACTIVE_INDICES.back(), fileName);
+}
+
+bool MFE::writeChannels(const RealMatrix& displacements, const Real& deltaT,
+	const std::string& fileName, const std::vector<UnsignedType>& indices,
+	const TextLayout& layout)
 {
 	bool isWrite = true;
-	std::ofstream fout("displacements.txt");
-	checkFileOpen(fout, isWrite);
+	ChannelsWriter writer(fileName, indices, layout);
+	if (!writer.isOpen())
+	{
+		std::string msg = "The file \"" + fileName + "\" was not opened. ";
+		WARNING(msg);
+		return false;
+	}
 
+	const UnsignedType lastIndex = indices.empty() ? 0 :
+		*std::max_element(indices.begin(), indices.end());
 	const UnsignedType rows = displacements.sizeRows();
-	const UnsignedType& fourthIndex = ACTIVE_INDICES.back();
 	for (UnsignedType rowNum = 0; rowNum < rows; ++rowNum)
 	{
-		if (displacements[rowNum].size() >= fourthIndex + 1)
-			fout << displacements[rowNum][fourthIndex] << "\n";
-		else
+		if (displacements[rowNum].size() < lastIndex + 1)
 		{
 			std::string msg = messageNotRecorded();
-			std::cout << msg << "\n";
 			WARNING(msg);
 
 			isWrite = false;
 			break;
 		}
+
+		writer.writeRow(deltaT * rowNum, displacements[rowNum]);
 	}
 
-	fout.close();
+	if (!writer.close())
+		isWrite = false;
 
 	return isWrite;
 }
 
-bool MFE::writeStepsTime(const UnsignedType& steps, const Real& deltaT)
+bool MFE::writeStepsTime(const UnsignedType& steps, const Real& deltaT,
+	const std::string& fileName)
 {
 	bool isWrite = true;
-	std::ofstream fout("time.txt");
-	checkFileOpen(fout, isWrite);
+	TextWriter writer(fileName, TEXT_PRECISION_STREAM);
+	checkFileOpen(writer, isWrite);
 
 	for (UnsignedType step = 0; step < steps; ++step)
 	{
-		fout << deltaT * step << "\n";
+		writer.writeValue(deltaT * step);
+		writer.writeChar('\n');
 	}
-	fout.close();
+
+	if (!writer.close())
+		isWrite = false;
 
 	return isWrite;
-}
\ No newline at end of file
+}